@@ -0,0 +1,27 @@
+﻿using UnrealBuildTool;
+
+public class FenceWallMass : ModuleRules
+{
+    public FenceWallMass(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+                "CoreUObject",
+                "Engine",
+                "MassEntity",
+                "FenceWallRelated"
+            }
+        );
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "ToolKits"
+            }
+        );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "FenceMassProcessors.h"
+
+#include "FenceMassTypes.h"
+#include "FenceSplineMass.h"
+#include "MassExecutionContext.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+
+UFencePostProcessorBase::UFencePostProcessorBase()
+{
+	// 由 AFenceSplineMass 手动执行
+	bAutoRegisterWithProcessingPhases = false;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	// 需要访问实例组件
+	bRequiresGameThreadExecution = true;
+}
+
+// 当前时间
+float UFencePostProcessorBase::GetTimeSeconds() const
+{
+	const AFenceSplineMass* Owner = FenceOwner.Get();
+	const UWorld* World = Owner != nullptr ? Owner->GetWorld() : nullptr;
+	return World != nullptr ? World->GetTimeSeconds() : 0.f;
+}
+
+UFencePostHitProcessor::UFencePostHitProcessor(): EntityQuery(*this)
+{
+}
+
+void UFencePostHitProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FFencePostAnimationFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FFencePostHitTag>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FFencePostRemovedTag>(EMassFragmentPresence::None);
+}
+
+// 记录命中开始时间
+void UFencePostHitProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFencePostHitProcessor::Execute);
+
+	const AFenceSplineMass* Owner = FenceOwner.Get();
+	if (Owner == nullptr) return;
+	const float Now = GetTimeSeconds();
+	const float HitTime = Owner->HitTime;
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [Now, HitTime](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FFencePostAnimationFragment> Animations = ChunkContext.GetMutableFragmentView<FFencePostAnimationFragment>();
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			// 与 ASingleFence_Base 一样随机延迟，同时被攻击的围栏不会完全同步
+			Animations[i].HitStartTime = Now + FMath::RandRange(0.01f, 0.05f);
+			Animations[i].HitDuration = HitTime;
+
+			const FMassEntityHandle Entity = ChunkContext.GetEntity(i);
+			ChunkContext.Defer().RemoveTag<FFencePostHitTag>(Entity);
+			ChunkContext.Defer().AddTag<FFencePostDirtyTag>(Entity);
+		}
+	});
+}
+
+UFencePostRecolorProcessor::UFencePostRecolorProcessor(): EntityQuery(*this)
+{
+}
+
+void UFencePostRecolorProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FFencePostColorFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FFencePostRecolorTag>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FFencePostRemovedTag>(EMassFragmentPresence::None);
+}
+
+// 变色波到达后切换颜色
+void UFencePostRecolorProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFencePostRecolorProcessor::Execute);
+
+	const float Now = GetTimeSeconds();
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [Now](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FFencePostColorFragment> Colors = ChunkContext.GetMutableFragmentView<FFencePostColorFragment>();
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			FFencePostColorFragment& Color = Colors[i];
+			if (Now < Color.RecolorTime) continue;
+
+			Color.Color = Color.TargetColor;
+			const FMassEntityHandle Entity = ChunkContext.GetEntity(i);
+			ChunkContext.Defer().RemoveTag<FFencePostRecolorTag>(Entity);
+			ChunkContext.Defer().AddTag<FFencePostDirtyTag>(Entity);
+		}
+	});
+}
+
+UFencePostRemovalProcessor::UFencePostRemovalProcessor(): EntityQuery(*this)
+{
+}
+
+void UFencePostRemovalProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FFencePostTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FFencePostMeshFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddTagRequirement<FFencePostRemovedTag>(EMassFragmentPresence::All);
+}
+
+// 隐藏实例并销毁实体
+void UFencePostRemovalProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFencePostRemovalProcessor::Execute);
+
+	AFenceSplineMass* Owner = FenceOwner.Get();
+	if (Owner == nullptr) return;
+
+	// 实例下标由实体记录，删除实例会改变后面实例的下标，所以只把缩放设为0
+	TSet<UHierarchicalInstancedStaticMeshComponent*> ChangedComponents;
+	TArray<int32> RemovedPosts;
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [Owner, &ChangedComponents, &RemovedPosts](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FFencePostTransformFragment> Transforms = ChunkContext.GetFragmentView<FFencePostTransformFragment>();
+		const TConstArrayView<FFencePostMeshFragment> Meshes = ChunkContext.GetFragmentView<FFencePostMeshFragment>();
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			const FFencePostMeshFragment& Mesh = Meshes[i];
+			if (Owner->InstancedStaticMeshComponents.IsValidIndex(Mesh.MeshIndex))
+			{
+				if (UHierarchicalInstancedStaticMeshComponent* Component = Owner->InstancedStaticMeshComponents[Mesh.MeshIndex])
+				{
+					FTransform Hidden = Transforms[i].Transform;
+					Hidden.SetScale3D(FVector::ZeroVector);
+					Component->UpdateInstanceTransform(Mesh.InstanceIndex, Hidden, true, false, true);
+					ChangedComponents.Add(Component);
+				}
+			}
+			RemovedPosts.Add(Mesh.PostIndex);
+			ChunkContext.Defer().DestroyEntity(ChunkContext.GetEntity(i));
+		}
+	});
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : ChangedComponents)
+	{
+		Component->MarkRenderStateDirty();
+		Component->BuildTreeIfOutdated(true, false);
+	}
+	for (const int32 PostIndex : RemovedPosts)
+	{
+		Owner->OnPostRemoved(PostIndex);
+	}
+}
+
+UFencePostVisualizationProcessor::UFencePostVisualizationProcessor(): EntityQuery(*this)
+{
+}
+
+void UFencePostVisualizationProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FFencePostMeshFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FFencePostColorFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FFencePostAnimationFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddTagRequirement<FFencePostDirtyTag>(EMassFragmentPresence::All);
+	EntityQuery.AddTagRequirement<FFencePostRemovedTag>(EMassFragmentPresence::None);
+}
+
+// 写入实例自定义数据
+void UFencePostVisualizationProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFencePostVisualizationProcessor::Execute);
+
+	AFenceSplineMass* Owner = FenceOwner.Get();
+	if (Owner == nullptr) return;
+
+	// 曲线的采样对所有实例相同
+	const TConstArrayView<float> CurveSamples = Owner->GetCurveSamples();
+	if (!ensure(CurveSamples.Num() == FenceMassCustomData::Num - FenceMassCustomData::ScaleCurve)) return;
+
+	TSet<UHierarchicalInstancedStaticMeshComponent*> ChangedComponents;
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [Owner, CurveSamples, &ChangedComponents](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FFencePostMeshFragment> Meshes = ChunkContext.GetFragmentView<FFencePostMeshFragment>();
+		const TConstArrayView<FFencePostColorFragment> Colors = ChunkContext.GetFragmentView<FFencePostColorFragment>();
+		const TConstArrayView<FFencePostAnimationFragment> Animations = ChunkContext.GetFragmentView<FFencePostAnimationFragment>();
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+		{
+			ChunkContext.Defer().RemoveTag<FFencePostDirtyTag>(ChunkContext.GetEntity(i));
+
+			const FFencePostMeshFragment& Mesh = Meshes[i];
+			if (!Owner->InstancedStaticMeshComponents.IsValidIndex(Mesh.MeshIndex)) continue;
+			UHierarchicalInstancedStaticMeshComponent* Component = Owner->InstancedStaticMeshComponents[Mesh.MeshIndex];
+			if (Component == nullptr) continue;
+
+			const FFencePostAnimationFragment& Animation = Animations[i];
+			const FLinearColor& Color = Colors[i].Color;
+			float CustomData[FenceMassCustomData::Num];
+			CustomData[FenceMassCustomData::HitStartTime] = Animation.HitStartTime;
+			CustomData[FenceMassCustomData::HitDuration] = Animation.HitDuration;
+			CustomData[FenceMassCustomData::ShakeAngle] = Animation.ShakeAngle;
+			CustomData[FenceMassCustomData::ScaleStartTime] = Animation.ScaleStartTime;
+			CustomData[FenceMassCustomData::ScaleDuration] = Animation.ScaleDuration;
+			CustomData[FenceMassCustomData::ColorR] = Color.R;
+			CustomData[FenceMassCustomData::ColorG] = Color.G;
+			CustomData[FenceMassCustomData::ColorB] = Color.B;
+			FMemory::Memcpy(CustomData + FenceMassCustomData::ScaleCurve, CurveSamples.GetData(), CurveSamples.Num() * sizeof(float));
+			Component->SetCustomData(Mesh.InstanceIndex, MakeArrayView(CustomData), false);
+			ChangedComponents.Add(Component);
+		}
+	});
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : ChangedComponents)
+	{
+		Component->MarkRenderStateDirty();
+	}
+}
@@ -0,0 +1,342 @@
+#include "FenceSplineMass.h"
+
+#include "FenceInstanceSync.h"
+#include "FenceMassProcessors.h"
+#include "FenceMassTypes.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "YC_Log.h"
+
+namespace FenceSplineMass
+{
+	// 未显示的围栏的缩放开始时间，材质中缩放保持为0
+	constexpr float HiddenScaleStartTime = 1.e8f;
+}
+
+AFenceSplineMass::AFenceSplineMass()
+{
+	// 创建实体后开启Tick执行处理器
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+// 获取实体管理器
+FMassEntityManager* AFenceSplineMass::GetEntityManager() const
+{
+	const UWorld* World = GetWorld();
+	UMassEntitySubsystem* EntitySubsystem = World != nullptr ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+	return EntitySubsystem != nullptr ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
+
+// 为每个围栏创建实体
+int32 AFenceSplineMass::RealizeFences(const TArray<FTransform>& Transforms, const int32 FirstPost, const double EndTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSplineMass::RealizeFences);
+
+	FMassEntityManager* EntityManager = GetEntityManager();
+	const FFenceLayout& Layout = GetBakedLayout();
+	if (EntityManager == nullptr)
+	{
+		if (FirstPost == 0)
+		{
+			YICHEN_CLOG(Fence, Warning, "%s 没有 MassEntity 子系统，使用 Actor 生成围栏", *GetName());
+		}
+		return Super::RealizeFences(Transforms, FirstPost, EndTime);
+	}
+	if (Transforms.Num() != Layout.Num()) return Transforms.Num();
+
+	DestroyEntities();
+
+	// 曲线的采样对所有实例相同，生成时计算一次，由显示处理器写入实例自定义数据
+	CurveSamples.SetNumUninitialized(FenceAnimationData::CurveSamples * 2);
+	FenceAnimationData::SampleCurve(ScaleCurve, &FenceAnimationData::DefaultSpawnScale, MakeArrayView(CurveSamples.GetData(), FenceAnimationData::CurveSamples));
+	FenceAnimationData::SampleCurve(HitCurve, &FenceAnimationData::DefaultHitAmount, MakeArrayView(CurveSamples.GetData() + FenceAnimationData::CurveSamples, FenceAnimationData::CurveSamples));
+
+	// 实例与实体一一对应，按模型分组后的顺序就是实例下标
+	TArray<TArray<FTransform>> GroupedTransforms;
+	GroupedTransforms.SetNum(InstancedStaticMeshComponents.Num());
+	TArray<int32> InstanceIndices;
+	InstanceIndices.SetNumUninitialized(Transforms.Num());
+	for (int32 i = 0; i < Transforms.Num(); ++i)
+	{
+		const uint8 MeshIndex = Layout.MeshIndices[i];
+		InstanceIndices[i] = GroupedTransforms.IsValidIndex(MeshIndex) ? GroupedTransforms[MeshIndex].Add(Transforms[i]) : INDEX_NONE;
+	}
+	for (int32 i = 0; i < InstancedStaticMeshComponents.Num(); ++i)
+	{
+		if (UHierarchicalInstancedStaticMeshComponent* Component = InstancedStaticMeshComponents[i])
+		{
+			// 贴合地面后的变换与构造时不同，只提交变化的部分
+			Component->SetNumCustomDataFloats(FenceMassCustomData::Num);
+			FenceInstanceSync::SyncInstances(Component, GroupedTransforms[i]);
+		}
+	}
+
+	const FMassArchetypeHandle Archetype = EntityManager->CreateArchetype({
+		FFencePostTransformFragment::StaticStruct(),
+		FFencePostMeshFragment::StaticStruct(),
+		FFencePostColorFragment::StaticStruct(),
+		FFencePostHealthFragment::StaticStruct(),
+		FFencePostAnimationFragment::StaticStruct(),
+		FFencePostDirtyTag::StaticStruct()
+	}, TEXT("FencePost"));
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	TBitArray<> Spawned(false, Transforms.Num());
+	{
+		TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext = EntityManager->BatchCreateEntities(Archetype, Transforms.Num(), PostEntities);
+		for (int32 i = 0; i < PostEntities.Num(); ++i)
+		{
+			const FMassEntityHandle Entity = PostEntities[i];
+			EntityManager->GetFragmentDataChecked<FFencePostTransformFragment>(Entity).Transform = Transforms[i];
+
+			FFencePostMeshFragment& Mesh = EntityManager->GetFragmentDataChecked<FFencePostMeshFragment>(Entity);
+			Mesh.PostIndex = i;
+			Mesh.MeshIndex = Layout.MeshIndices[i];
+			Mesh.InstanceIndex = InstanceIndices[i];
+
+			FFencePostColorFragment& Color = EntityManager->GetFragmentDataChecked<FFencePostColorFragment>(Entity);
+			Color.Color = CampColor;
+			Color.TargetColor = CampColor;
+
+			EntityManager->GetFragmentDataChecked<FFencePostHealthFragment>(Entity).Health = PostHealth;
+
+			// 默认显示时播放出现动画，否则保持缩放为0直到 ShowFencePost
+			FFencePostAnimationFragment& Animation = EntityManager->GetFragmentDataChecked<FFencePostAnimationFragment>(Entity);
+			Animation.ScaleStartTime = bDefaultDisplay ? Now : FenceSplineMass::HiddenScaleStartTime;
+			Animation.ScaleDuration = ScaleTime;
+
+			Spawned[i] = InstanceIndices[i] != INDEX_NONE;
+		}
+	}
+
+	if (Processors.IsEmpty())
+	{
+		for (UClass* ProcessorClass : {UFencePostHitProcessor::StaticClass(), UFencePostRecolorProcessor::StaticClass(),
+		                               UFencePostRemovalProcessor::StaticClass(), UFencePostVisualizationProcessor::StaticClass()})
+		{
+			UFencePostProcessorBase* Processor = NewObject<UFencePostProcessorBase>(this, ProcessorClass);
+			Processor->FenceOwner = this;
+			Processor->CallInitialize(this);
+			Processors.Add(Processor);
+		}
+	}
+
+	if (bAffectNavigation)
+	{
+		BuildNavModifiers(Transforms, Spawned);
+	}
+	SetActorTickEnabled(true);
+	YICHEN_CLOG(Fence, Verbose, "%s 创建 %d 个围栏实体", *GetName(), PostEntities.Num());
+	return Transforms.Num();
+}
+
+// 按顺序执行处理器
+void AFenceSplineMass::Tick(const float DeltaSeconds)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSplineMass::Tick);
+	Super::Tick(DeltaSeconds);
+
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (EntityManager == nullptr) return;
+
+	// 每个处理器结束后立即执行延迟的命令，后面的处理器能看到前面添加的标签
+	for (UMassProcessor* Processor : Processors)
+	{
+		FMassProcessingContext ProcessingContext(*EntityManager, DeltaSeconds);
+		UE::Mass::Executor::Run(*Processor, ProcessingContext);
+	}
+}
+
+void AFenceSplineMass::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DestroyEntities();
+	Super::EndPlay(EndPlayReason);
+}
+
+// 销毁所有实体
+void AFenceSplineMass::DestroyEntities()
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (EntityManager != nullptr)
+	{
+		TArray<FMassEntityHandle> ValidEntities;
+		ValidEntities.Reserve(PostEntities.Num());
+		for (const FMassEntityHandle Entity : PostEntities)
+		{
+			if (EntityManager->IsEntityValid(Entity))
+			{
+				ValidEntities.Add(Entity);
+			}
+		}
+		EntityManager->BatchDestroyEntities(ValidEntities);
+	}
+	PostEntities.Reset();
+}
+
+// 获取围栏的实体
+FMassEntityHandle AFenceSplineMass::GetPostEntity(const int32 PostIndex) const
+{
+	return PostEntities.IsValidIndex(PostIndex) ? PostEntities[PostIndex] : FMassEntityHandle();
+}
+
+// 围栏是否存在
+bool AFenceSplineMass::IsFencePostValid(const int32 PostIndex) const
+{
+	const FMassEntityManager* EntityManager = GetEntityManager();
+	return EntityManager != nullptr && EntityManager->IsEntityValid(GetPostEntity(PostIndex));
+}
+
+// 给实体添加标签
+void AFenceSplineMass::AddTag(const int32 PostIndex, const UScriptStruct* TagType)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	const FMassEntityHandle Entity = GetPostEntity(PostIndex);
+	if (EntityManager != nullptr && EntityManager->IsEntityValid(Entity))
+	{
+		EntityManager->AddTagToEntity(Entity, TagType);
+	}
+}
+
+// 显示围栏
+void AFenceSplineMass::ShowFencePost(const int32 PostIndex)
+{
+	if (!IsFencePostValid(PostIndex)) return;
+
+	FFencePostAnimationFragment& Animation = GetEntityManager()->GetFragmentDataChecked<FFencePostAnimationFragment>(PostEntities[PostIndex]);
+	Animation.ScaleStartTime = GetWorld()->GetTimeSeconds();
+	Animation.ScaleDuration = ScaleTime;
+	AddTag(PostIndex, FFencePostDirtyTag::StaticStruct());
+}
+
+// 围栏被攻击
+void AFenceSplineMass::HitFencePost(const int32 PostIndex, const bool CanShake, const float Angle)
+{
+	if (!IsFencePostValid(PostIndex)) return;
+
+	// 开始时间由命中处理器统一记录
+	FFencePostAnimationFragment& Animation = GetEntityManager()->GetFragmentDataChecked<FFencePostAnimationFragment>(PostEntities[PostIndex]);
+	Animation.ShakeAngle = CanShake ? FMath::DegreesToRadians(Angle) : 0.f;
+	AddTag(PostIndex, FFencePostHitTag::StaticStruct());
+}
+
+// 对围栏造成伤害
+bool AFenceSplineMass::DamageFencePost(const int32 PostIndex, const float Damage)
+{
+	if (!IsFencePostValid(PostIndex)) return false;
+
+	float& Health = GetEntityManager()->GetFragmentDataChecked<FFencePostHealthFragment>(PostEntities[PostIndex]).Health;
+	Health = FMath::Max(Health - Damage, 0.f);
+	if (Health > 0.f) return false;
+
+	RemoveFencePost(PostIndex);
+	return true;
+}
+
+// 移除围栏
+void AFenceSplineMass::RemoveFencePost(const int32 PostIndex)
+{
+	AddTag(PostIndex, FFencePostRemovedTag::StaticStruct());
+}
+
+// 更改所有围栏的颜色
+void AFenceSplineMass::ChangeFenceColor(const FLinearColor NewColor, const float FromDistance)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (EntityManager == nullptr) return;
+
+	CampColor = NewColor;
+	const TArray<float>& Distances = GetBakedLayout().Distances;
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = 0; i < PostEntities.Num(); ++i)
+	{
+		if (!EntityManager->IsEntityValid(PostEntities[i])) continue;
+
+		// 按与起点的距离延迟变色
+		FFencePostColorFragment& Color = EntityManager->GetFragmentDataChecked<FFencePostColorFragment>(PostEntities[i]);
+		Color.TargetColor = NewColor;
+		Color.RecolorTime = RecolorWaveSpeed > 0.f && Distances.IsValidIndex(i) ? Now + FMath::Abs(Distances[i] - FromDistance) / RecolorWaveSpeed : Now;
+		EntityManager->AddTagToEntity(PostEntities[i], FFencePostRecolorTag::StaticStruct());
+	}
+}
+
+// 查找离指定位置最近的围栏
+int32 AFenceSplineMass::FindNearestFencePost(const FVector& Location) const
+{
+	const FMassEntityManager* EntityManager = GetEntityManager();
+	if (EntityManager == nullptr) return INDEX_NONE;
+
+	int32 NearestIndex = INDEX_NONE;
+	double NearestDistSquared = TNumericLimits<double>::Max();
+	for (int32 i = 0; i < PostEntities.Num(); ++i)
+	{
+		if (!EntityManager->IsEntityValid(PostEntities[i])) continue;
+
+		const FTransform& Transform = EntityManager->GetFragmentDataChecked<FFencePostTransformFragment>(PostEntities[i]).Transform;
+		const double DistSquared = FVector::DistSquared(Transform.GetLocation(), Location);
+		if (DistSquared < NearestDistSquared)
+		{
+			NearestDistSquared = DistSquared;
+			NearestIndex = i;
+		}
+	}
+	return NearestIndex;
+}
+
+// 围栏被移除
+void AFenceSplineMass::OnPostRemoved(const int32 PostIndex)
+{
+	if (!PostEntities.IsValidIndex(PostIndex)) return;
+
+	PostEntities[PostIndex] = FMassEntityHandle();
+	SetFencePostRemoved(PostIndex);
+	if (bAffectNavigation)
+	{
+		MarkPostRemovedFromNavigation(PostIndex);
+	}
+}
+
+// 立即更改单个围栏的颜色
+void AFenceSplineMass::SetPostColor(const int32 PostIndex, const FLinearColor& NewColor)
+{
+	if (!IsFencePostValid(PostIndex)) return;
+
+	FFencePostColorFragment& Color = GetEntityManager()->GetFragmentDataChecked<FFencePostColorFragment>(PostEntities[PostIndex]);
+	Color.TargetColor = NewColor;
+	Color.RecolorTime = GetWorld()->GetTimeSeconds();
+	AddTag(PostIndex, FFencePostRecolorTag::StaticStruct());
+}
+
+// 把复制的状态应用到实体上
+void AFenceSplineMass::ApplyPostState(const int32 PostIndex, const uint16 OldState, const uint16 NewState)
+{
+	// 没有 MassEntity 子系统时围栏是 Actor
+	if (GetEntityManager() == nullptr)
+	{
+		Super::ApplyPostState(PostIndex, OldState, NewState);
+		return;
+	}
+
+	if (!(NewState & FencePostState::AliveBit))
+	{
+		RemoveFencePost(PostIndex);
+		return;
+	}
+
+	const uint16 Changed = OldState ^ NewState;
+	if ((Changed & FencePostState::VisibleBit) && (NewState & FencePostState::VisibleBit))
+	{
+		ShowFencePost(PostIndex);
+	}
+	if (FencePostState::GetColorIndex(Changed) != 0)
+	{
+		SetPostColor(PostIndex, GetPaletteColor(FencePostState::GetColorIndex(NewState)));
+	}
+	if (FencePostState::GetHitSequence(Changed) != 0)
+	{
+		HitFencePost(PostIndex, true, HitShakeAngle);
+	}
+}
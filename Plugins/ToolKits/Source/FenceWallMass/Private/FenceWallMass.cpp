@@ -0,0 +1,15 @@
+﻿#include "FenceWallMass.h"
+
+#define LOCTEXT_NAMESPACE "FFenceWallMassModule"
+
+void FFenceWallMassModule::StartupModule()
+{
+}
+
+void FFenceWallMassModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FFenceWallMassModule, FenceWallMass)
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "FenceMassProcessors.generated.h"
+
+class AFenceSplineMass; // Mass 围栏样条线
+
+/**
+ * 围栏处理器基类
+ * 不注册到 Mass 的处理阶段，由 AFenceSplineMass 在 Tick 中按顺序执行，不依赖 MassSimulation
+ */
+UCLASS(Abstract)
+class FENCEWALLMASS_API UFencePostProcessorBase : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UFencePostProcessorBase();
+
+	// 所属的围栏样条线
+	TWeakObjectPtr<AFenceSplineMass> FenceOwner;
+
+protected:
+	// 当前时间，与材质的 Time 节点一致
+	float GetTimeSeconds() const;
+};
+
+/**
+ * 命中处理器
+ * 记录命中开始时间，抖动由材质播放
+ */
+UCLASS()
+class FENCEWALLMASS_API UFencePostHitProcessor : public UFencePostProcessorBase
+{
+	GENERATED_BODY()
+
+public:
+	UFencePostHitProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * 变色处理器
+ * 变色波到达后切换颜色
+ */
+UCLASS()
+class FENCEWALLMASS_API UFencePostRecolorProcessor : public UFencePostProcessorBase
+{
+	GENERATED_BODY()
+
+public:
+	UFencePostRecolorProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * 移除处理器
+ * 隐藏实例，销毁实体并通知样条线更新导航
+ */
+UCLASS()
+class FENCEWALLMASS_API UFencePostRemovalProcessor : public UFencePostProcessorBase
+{
+	GENERATED_BODY()
+
+public:
+	UFencePostRemovalProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * 显示处理器
+ * 把变化的实体写入实例自定义数据，每个组件只标记一次渲染状态
+ */
+UCLASS()
+class FENCEWALLMASS_API UFencePostVisualizationProcessor : public UFencePostProcessorBase
+{
+	GENERATED_BODY()
+
+public:
+	UFencePostVisualizationProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
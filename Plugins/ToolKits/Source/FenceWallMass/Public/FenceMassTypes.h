@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FenceAnimationData.h"
+#include "MassEntityTypes.h"
+#include "FenceMassTypes.generated.h"
+
+/**
+ * 实例自定义数据下标
+ * 0~4 和 8~23 与 FenceAnimationData（Shaders/Fence/FenceAnimation.ush）一致，5~7 为阵营颜色
+ */
+namespace FenceMassCustomData
+{
+	constexpr int32 HitStartTime = FenceAnimationData::HitStartTime;
+	constexpr int32 HitDuration = FenceAnimationData::HitDuration;
+	constexpr int32 ShakeAngle = FenceAnimationData::ShakeAngle;
+	constexpr int32 ScaleStartTime = FenceAnimationData::ScaleStartTime;
+	constexpr int32 ScaleDuration = FenceAnimationData::ScaleDuration;
+	constexpr int32 ColorR = 5;
+	constexpr int32 ColorG = 6;
+	constexpr int32 ColorB = 7;
+	constexpr int32 ScaleCurve = FenceAnimationData::ScaleCurve;
+	constexpr int32 HitCurve = FenceAnimationData::HitCurve;
+	constexpr int32 Num = FenceAnimationData::Num;
+}
+
+// 围栏的世界变换
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostTransformFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FTransform Transform;
+};
+
+// 围栏在实例组件中的位置
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostMeshFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// 布局中的下标
+	UPROPERTY()
+	int32 PostIndex = INDEX_NONE;
+
+	// 模型下标，也是实例组件的下标
+	UPROPERTY()
+	uint8 MeshIndex = 0;
+
+	// 实例下标
+	UPROPERTY()
+	int32 InstanceIndex = INDEX_NONE;
+};
+
+// 阵营颜色，变色波到达时 Color 变为 TargetColor
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostColorFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FLinearColor Color = FLinearColor::Green;
+
+	UPROPERTY()
+	FLinearColor TargetColor = FLinearColor::Green;
+
+	// 变色的时间
+	UPROPERTY()
+	float RecolorTime = 0.f;
+};
+
+// 生命值
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostHealthFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float Health = 1.f;
+};
+
+// 动画状态，写入实例自定义数据后由材质播放
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostAnimationFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float HitStartTime = 0.f;
+
+	UPROPERTY()
+	float HitDuration = 0.f;
+
+	// 抖动角度（弧度）
+	UPROPERTY()
+	float ShakeAngle = 0.f;
+
+	UPROPERTY()
+	float ScaleStartTime = 0.f;
+
+	UPROPERTY()
+	float ScaleDuration = 0.f;
+};
+
+// 被攻击，等待开始抖动
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostHitTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+// 等待变色
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostRecolorTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+// 等待移除
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostRemovedTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+// 实例数据需要更新
+USTRUCT()
+struct FENCEWALLMASS_API FFencePostDirtyTag : public FMassTag
+{
+	GENERATED_BODY()
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FenceSpline.h"
+#include "MassEntityTypes.h"
+#include "FenceSplineMass.generated.h"
+
+class UMassProcessor; // Mass 处理器
+class UCurveFloat; // 浮点曲线
+struct FMassEntityManager; // Mass 实体管理器
+
+/**
+ * Mass 围栏样条线
+ * 每个围栏是一个 Mass 实体而不是 Actor，由实例化网格显示，适合数万个围栏的城墙
+ * 命中、变色和移除由处理器在 Tick 中处理，动画数据写入实例自定义数据后由材质播放（Shaders/Fence/FenceAnimation.ush）
+ * 没有 MassEntity 子系统时退回到 AFenceSpline 的 Actor 生成
+ */
+UCLASS()
+class FENCEWALLMASS_API AFenceSplineMass : public AFenceSpline
+{
+	GENERATED_BODY()
+
+public:
+	AFenceSplineMass();
+
+	// 生命值
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "生命值", ClampMin = 0.f))
+	float PostHealth = 100.f;
+
+	// 命中抖动时间
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "命中时间", ClampMin = 0.f))
+	float HitTime = 0.3f;
+
+	// 出现时的缩放时间
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "缩放时间", ClampMin = 0.f))
+	float ScaleTime = 0.3f;
+
+	// 出现时的缩放曲线（0~1），为空时从0放大并略微回弹到1，起点应为0，未显示的围栏停在起点
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "缩放曲线"))
+	TObjectPtr<UCurveFloat> ScaleCurve;
+
+	// 命中时的抖动曲线（0~1），为空时开始和结束为0、中间最大
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "击中曲线"))
+	TObjectPtr<UCurveFloat> HitCurve;
+
+	// 变色波沿样条线传播的速度（厘米/秒），0为同时变色
+	UPROPERTY(EditAnywhere, Category="Mass", meta=(DisplayName = "变色速度", ClampMin = 0.f))
+	float RecolorWaveSpeed = 2000.f;
+
+	/**
+	 * 显示围栏，播放出现时的缩放
+	 * @param PostIndex		围栏在布局中的下标
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	void ShowFencePost(int32 PostIndex);
+
+	/**
+	 * 围栏被攻击
+	 * @param PostIndex		围栏在布局中的下标
+	 * @param CanShake		可以抖动
+	 * @param Angle			角度
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	void HitFencePost(int32 PostIndex, bool CanShake, float Angle);
+
+	/**
+	 * 对围栏造成伤害，生命值为0时移除
+	 * @param PostIndex		围栏在布局中的下标
+	 * @param Damage		伤害
+	 * @return				是否被移除
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	bool DamageFencePost(int32 PostIndex, float Damage);
+
+	/**
+	 * 移除围栏
+	 * @param PostIndex		围栏在布局中的下标
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	void RemoveFencePost(int32 PostIndex);
+
+	/**
+	 * 更改所有围栏的颜色，从指定位置沿样条线向两边传播
+	 * @param NewColor		新的颜色
+	 * @param FromDistance	变色开始的位置（沿样条线的距离）
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	void ChangeFenceColor(FLinearColor NewColor, float FromDistance = 0.f);
+
+	/**
+	 * 查找离指定位置最近的围栏
+	 * @param Location		世界坐标
+	 * @return				围栏在布局中的下标，没有时为-1
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	int32 FindNearestFencePost(const FVector& Location) const;
+
+	// 围栏是否存在
+	UFUNCTION(BlueprintPure, Category="YC|城墙围栏相关")
+	bool IsFencePostValid(int32 PostIndex) const;
+
+	// 获取围栏的实体
+	FMassEntityHandle GetPostEntity(int32 PostIndex) const;
+
+	// 围栏被移除，由移除处理器调用
+	void OnPostRemoved(int32 PostIndex);
+
+	// 缩放曲线和击中曲线的采样，每个实例写入相同的值
+	FORCEINLINE TConstArrayView<float> GetCurveSamples() const { return CurveSamples; }
+
+protected:
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 为每个围栏创建实体，批量创建很快，一次全部完成
+	virtual int32 RealizeFences(const TArray<FTransform>& Transforms, int32 FirstPost, double EndTime) override;
+
+	// 把复制的状态应用到实体上
+	virtual void ApplyPostState(int32 PostIndex, uint16 OldState, uint16 NewState) override;
+
+private:
+	// 获取实体管理器，没有 MassEntity 子系统时为空
+	FMassEntityManager* GetEntityManager() const;
+
+	// 销毁所有实体
+	void DestroyEntities();
+
+	// 给实体添加标签
+	void AddTag(int32 PostIndex, const UScriptStruct* TagType);
+
+	// 立即更改单个围栏的颜色
+	void SetPostColor(int32 PostIndex, const FLinearColor& NewColor);
+
+	// 每个围栏的实体，被移除后无效
+	TArray<FMassEntityHandle> PostEntities;
+
+	// 缩放曲线和击中曲线的采样，生成时计算
+	TArray<float> CurveSamples;
+
+	// 处理器，按命中、变色、移除、显示的顺序执行
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMassProcessor>> Processors;
+};
@@ -20,8 +20,16 @@ public class FenceWallRelated : ModuleRules
                 "Engine",
                 "Slate",
                 "SlateCore",
+                "NavigationSystem",
+                "NetCore",
                 "ToolKits"
             }
         );
+
+        // 联机PIE自动化测试
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("UnrealEd");
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "FenceAnimationData.h"
+
+#include "Curves/CurveFloat.h"
+
+// 采样曲线
+void FenceAnimationData::SampleCurve(const UCurveFloat* Curve, const TFunctionRef<float(float)> Fallback, const TArrayView<float> OutSamples)
+{
+	check(OutSamples.Num() == CurveSamples);
+	for (int32 i = 0; i < CurveSamples; ++i)
+	{
+		const float Alpha = static_cast<float>(i) / (CurveSamples - 1);
+		OutSamples[i] = Curve != nullptr ? Curve->GetFloatValue(Alpha) : Fallback(Alpha);
+	}
+}
+
+// 默认的出现缩放（easeOutBack）
+float FenceAnimationData::DefaultSpawnScale(const float Alpha)
+{
+	constexpr float C1 = 1.70158f;
+	constexpr float C3 = C1 + 1.f;
+	const float T = Alpha - 1.f;
+	return 1.f + C3 * T * T * T + C1 * T * T;
+}
+
+// 默认的命中强度
+float FenceAnimationData::DefaultHitAmount(const float Alpha)
+{
+	return FMath::Sin(Alpha * UE_PI);
+}
@@ -0,0 +1,264 @@
+#include "FenceGenerationSubsystem.h"
+
+#include "FenceSpline.h"
+#include "HelicalFence.h"
+#include "ToolKitsStats.h"
+#include "YC_Log.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+void UFenceGenerationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!IsGenerating()) return;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFenceGenerationSubsystem::Tick);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FenceGenerationSchedule);
+
+	if (!PendingRequests.IsEmpty())
+	{
+		PrepareJobs();
+	}
+
+	const int32 OldCompletedPosts = CompletedPosts;
+	UpdateSnappingJobs();
+
+	// 在预算内由近到远逐个生成围栏，每帧至少生成一个
+	const double EndTime = FPlatformTime::Seconds() + FrameBudgetMs / 1000.0;
+	while (!Jobs.IsEmpty())
+	{
+		// 预算用完时任务留在末尾，下一帧从停下的围栏继续
+		if (!RealizeJob(Jobs.Last(), EndTime)) break;
+
+		FFenceGenerationJob Job = Jobs.Pop(false);
+		const AFenceSpline* FenceSpline = Cast<AFenceSpline>(Job.Fence.Get());
+		if (FenceSpline && FenceSpline->IsSnappingToGround())
+		{
+			SnappingJobs.Add(MoveTemp(Job));
+		}
+		else
+		{
+			CompleteJob(Job);
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime) break;
+	}
+
+	if (CompletedPosts != OldCompletedPosts)
+	{
+		OnGenerationProgress.Broadcast(CompletedPosts, TotalPosts);
+	}
+	if (!IsGenerating())
+	{
+		YICHEN_CLOG(Fence, Log, "围栏生成完成，共 %d 个围栏", TotalPosts);
+		OnGenerationFinished.Broadcast();
+	}
+}
+
+TStatId UFenceGenerationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFenceGenerationSubsystem, STATGROUP_Tickables);
+}
+
+// 提交生成请求
+void UFenceGenerationSubsystem::RequestGeneration(AActor* Fence)
+{
+	if (Fence == nullptr) return;
+
+	// 上一轮已经完成，重新统计进度
+	if (!IsGenerating())
+	{
+		CompletedPosts = 0;
+		TotalPosts = 0;
+	}
+	PendingRequests.AddUnique(Fence);
+}
+
+// 生成进度
+float UFenceGenerationSubsystem::GetGenerationProgress() const
+{
+	if (!IsGenerating()) return 1.f;
+	return TotalPosts > 0 ? static_cast<float>(CompletedPosts) / TotalPosts : 0.f;
+}
+
+// 设置每帧生成的耗时预算
+void UFenceGenerationSubsystem::SetFrameBudget(const float Milliseconds)
+{
+	FrameBudgetMs = FMath::Max(Milliseconds, 0.f);
+}
+
+// 并行计算新请求的变换
+void UFenceGenerationSubsystem::PrepareJobs()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFenceGenerationSubsystem::PrepareJobs);
+
+	const int32 FirstNew = Jobs.Num();
+	for (const TWeakObjectPtr<AActor>& Request : PendingRequests)
+	{
+		if (Request.IsValid())
+		{
+			FFenceGenerationJob& Job = Jobs.AddDefaulted_GetRef();
+			Job.Fence = Request;
+		}
+	}
+	PendingRequests.Reset();
+
+	// 在游戏线程上检查烘焙的布局并收集模型长度，不能直接使用烘焙布局的围栏样条线需要重新采样
+	struct FLayoutSample
+	{
+		AFenceSpline* FenceSpline = nullptr;
+		uint32 Hash = 0;
+		TArray<float> ModelLengths;
+		FFenceLayout Layout;
+	};
+	TArray<FLayoutSample> Samples;
+	for (int32 i = FirstNew; i < Jobs.Num(); ++i)
+	{
+		AFenceSpline* FenceSpline = Cast<AFenceSpline>(Jobs[i].Fence.Get());
+		if (FenceSpline == nullptr) continue;
+
+		uint32 Hash;
+		if (FenceSpline->CanUseBakedLayout(Hash)) continue;
+
+		FLayoutSample Sample;
+		Sample.FenceSpline = FenceSpline;
+		Sample.Hash = Hash;
+		if (FenceSpline->GetLayoutModelLengths(Sample.ModelLengths))
+		{
+			Samples.Add(MoveTemp(Sample));
+		}
+	}
+
+	// 工作线程只采样样条线，结果写入局部的布局
+	ParallelFor(Samples.Num(), [&Samples](const int32 Index)
+	{
+		FLayoutSample& Sample = Samples[Index];
+		Sample.FenceSpline->SampleLayout(Sample.ModelLengths, Sample.Layout);
+	});
+
+	// 回到游戏线程保存布局，再转换为世界变换
+	for (FLayoutSample& Sample : Samples)
+	{
+		Sample.Layout.SourceHash = Sample.Hash;
+		Sample.FenceSpline->BakedLayout = MoveTemp(Sample.Layout);
+	}
+	for (int32 i = FirstNew; i < Jobs.Num(); ++i)
+	{
+		if (AFenceSpline* FenceSpline = Cast<AFenceSpline>(Jobs[i].Fence.Get()))
+		{
+			Jobs[i].Transforms = FenceSpline->PrepareFenceTransforms();
+		}
+	}
+
+	// 统计新任务的围栏数量，螺旋围栏借用围栏样条线的围栏时只算一个
+	for (int32 i = FirstNew; i < Jobs.Num(); ++i)
+	{
+		FFenceGenerationJob& Job = Jobs[i];
+		const AHelicalFence* HelicalFence = Cast<AHelicalFence>(Job.Fence.Get());
+		Job.PostNum = HelicalFence != nullptr && HelicalFence->FenceSpline == nullptr ? HelicalFence->DisplayNum : Job.Transforms.Num();
+		Job.PostNum = FMath::Max(Job.PostNum, 1);
+		TotalPosts += Job.PostNum;
+	}
+
+	// 玩家的视点
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+			ViewLocations.Add(Location);
+		}
+	}
+
+	// 所有未完成的任务重新排序，由远到近排列，从末尾取出
+	for (FFenceGenerationJob& Job : Jobs)
+	{
+		Job.DistanceSquared = GetDistanceSquaredToPlayers(Job.Fence.Get(), ViewLocations);
+	}
+	Jobs.Sort([](const FFenceGenerationJob& A, const FFenceGenerationJob& B)
+	{
+		return A.DistanceSquared > B.DistanceSquared;
+	});
+	YICHEN_CLOG(Fence, Verbose, "围栏生成调度：%d 个任务，%d 个玩家视点", Jobs.Num(), ViewLocations.Num());
+}
+
+// 生成一个任务
+bool UFenceGenerationSubsystem::RealizeJob(FFenceGenerationJob& Job, const double EndTime)
+{
+	AActor* Fence = Job.Fence.Get();
+	if (Fence == nullptr || Fence->IsActorBeingDestroyed()) return true;
+
+	if (AFenceSpline* FenceSpline = Cast<AFenceSpline>(Fence))
+	{
+		// 第一次处理时开始生成，贴合地面时要等检测结果返回
+		if (!Job.bStarted)
+		{
+			Job.bStarted = true;
+			FenceSpline->GenerateFromTransforms(MoveTemp(Job.Transforms), false);
+		}
+
+		const int32 RealizedNum = FenceSpline->ContinueRealizeFences(EndTime);
+		Job.CompletedPosts += RealizedNum;
+		CompletedPosts += RealizedNum;
+		return !FenceSpline->IsRealizingFences();
+	}
+	if (AHelicalFence* HelicalFence = Cast<AHelicalFence>(Fence))
+	{
+		HelicalFence->GeneratingFences();
+	}
+	return true;
+}
+
+// 任务完成
+void UFenceGenerationSubsystem::CompleteJob(FFenceGenerationJob& Job)
+{
+	CompletedPosts += FMath::Max(Job.PostNum - Job.CompletedPosts, 0);
+	Job.CompletedPosts = Job.PostNum;
+}
+
+// 检查贴合地面的任务
+void UFenceGenerationSubsystem::UpdateSnappingJobs()
+{
+	for (int32 i = SnappingJobs.Num() - 1; i >= 0; --i)
+	{
+		const AFenceSpline* FenceSpline = Cast<AFenceSpline>(SnappingJobs[i].Fence.Get());
+		if (FenceSpline && FenceSpline->IsSnappingToGround()) continue;
+
+		// 检测结果全部返回后放回队列末尾，优先分帧生成；围栏样条线被销毁时直接完成
+		if (FenceSpline && FenceSpline->IsRealizingFences())
+		{
+			Jobs.Add(MoveTemp(SnappingJobs[i]));
+		}
+		else
+		{
+			CompleteJob(SnappingJobs[i]);
+		}
+		SnappingJobs.RemoveAtSwap(i, 1, false);
+	}
+}
+
+// 最近玩家视点的距离平方
+double UFenceGenerationSubsystem::GetDistanceSquaredToPlayers(const AActor* Fence, const TConstArrayView<FVector> ViewLocations) const
+{
+	if (Fence == nullptr) return 0.0;
+
+	// 长城墙按包围盒计算，玩家站在城墙中段时也会优先生成
+	const FBox Bounds = Fence->GetComponentsBoundingBox(true);
+	auto DistanceSquaredTo = [&Bounds, Fence](const FVector& Location)
+	{
+		return Bounds.IsValid ? Bounds.ComputeSquaredDistanceToPoint(Location) : FVector::DistSquared(Fence->GetActorLocation(), Location);
+	};
+
+	if (ViewLocations.IsEmpty()) return DistanceSquaredTo(FVector::ZeroVector);
+
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& Location : ViewLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, DistanceSquaredTo(Location));
+	}
+	return MinDistanceSquared;
+}
@@ -0,0 +1,170 @@
+#include "FenceInstanceSync.h"
+
+#include "ToolKitsStats.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+
+namespace FenceInstanceSync
+{
+	// 位置的比较精度
+	static constexpr float LocationTolerance = 0.01f;
+
+	// 旋转和缩放的比较精度
+	static constexpr float RotationTolerance = 1.e-4f;
+
+	// 两个变化区间之间未变化的实例不超过这个数量时合并提交
+	static constexpr int32 MergeGap = 16;
+
+	// 同步实例组件
+	void SyncComponents(AActor* Owner, TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>>& Components, const TArray<TObjectPtr<UStaticMesh>>& Models,
+	                    TFunctionRef<void(UHierarchicalInstancedStaticMeshComponent*, UStaticMesh*)> Initialize)
+	{
+		const int32 ModelNum = Models.Num();
+
+		// 销毁多余的组件
+		for (int32 i = ModelNum; i < Components.Num(); ++i)
+		{
+			if (Components[i] != nullptr)
+			{
+				Components[i]->DestroyComponent();
+			}
+		}
+		Components.SetNum(ModelNum);
+
+		for (int32 i = 0; i < ModelNum; ++i)
+		{
+			UStaticMesh* Model = Models[i];
+			TObjectPtr<UHierarchicalInstancedStaticMeshComponent>& Component = Components[i];
+
+			// 模型为空时不需要组件
+			if (Model == nullptr)
+			{
+				if (Component != nullptr)
+				{
+					Component->DestroyComponent();
+					Component = nullptr;
+				}
+				continue;
+			}
+
+			// 复用已有组件，只在模型变化时替换
+			if (IsValid(Component))
+			{
+				if (Component->GetStaticMesh() != Model)
+				{
+					Component->SetStaticMesh(Model);
+				}
+				continue;
+			}
+
+			const FName ComponentName = MakeUniqueObjectName(Owner, UHierarchicalInstancedStaticMeshComponent::StaticClass(), *FString::Printf(TEXT("HISMComponent_%d"), i));
+			Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(Owner, UHierarchicalInstancedStaticMeshComponent::StaticClass(), ComponentName);
+			// 集群树由 SyncInstances 在最后统一重建
+			Component->bAutoRebuildTreeOnInstanceChanges = false;
+			Initialize(Component, Model);
+		}
+	}
+
+	// 同步实例
+	int32 SyncInstances(UHierarchicalInstancedStaticMeshComponent* Component, const TArrayView<const FTransform> Transforms)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FenceInstanceSync::SyncInstances);
+
+		if (Component == nullptr) return 0;
+		Component->bAutoRebuildTreeOnInstanceChanges = false;
+
+		// 转换到组件空间后再对比，避免世界坐标较大时的精度问题
+		const FTransform& ComponentTransform = Component->GetComponentTransform();
+		TArray<FTransform> LocalTransforms;
+		LocalTransforms.SetNumUninitialized(Transforms.Num());
+		for (int32 i = 0; i < Transforms.Num(); ++i)
+		{
+			LocalTransforms[i] = Transforms[i].GetRelativeTransform(ComponentTransform);
+		}
+
+		const int32 OldNum = Component->GetInstanceCount();
+		const int32 NewNum = LocalTransforms.Num();
+		const int32 CommonNum = FMath::Min(OldNum, NewNum);
+		int32 UpdatedNum = 0;
+
+		// 提交 [RunStart, RunEnd) 区间
+		TArray<FTransform> RunTransforms;
+		auto FlushRun = [&](const int32 RunStart, const int32 RunEnd)
+		{
+			RunTransforms.Reset(RunEnd - RunStart);
+			RunTransforms.Append(LocalTransforms.GetData() + RunStart, RunEnd - RunStart);
+			Component->BatchUpdateInstancesTransforms(RunStart, RunTransforms, false, false, true);
+			UpdatedNum += RunEnd - RunStart;
+		};
+
+		// 逐个对比，相近的变化区间合并
+		int32 RunStart = INDEX_NONE;
+		int32 RunEnd = INDEX_NONE;
+		for (int32 i = 0; i < CommonNum; ++i)
+		{
+			FTransform Existing;
+			Component->GetInstanceTransform(i, Existing, false);
+			const FTransform& Target = LocalTransforms[i];
+			if (Existing.TranslationEquals(Target, LocationTolerance) && Existing.RotationEquals(Target, RotationTolerance) && Existing.Scale3DEquals(Target, RotationTolerance))
+			{
+				continue;
+			}
+
+			if (RunStart != INDEX_NONE && i - RunEnd > MergeGap)
+			{
+				FlushRun(RunStart, RunEnd);
+				RunStart = INDEX_NONE;
+			}
+			if (RunStart == INDEX_NONE)
+			{
+				RunStart = i;
+			}
+			RunEnd = i + 1;
+		}
+		if (RunStart != INDEX_NONE)
+		{
+			FlushRun(RunStart, RunEnd);
+		}
+
+		// 尾部新增或删除
+		int32 AddedNum = 0;
+		int32 RemovedNum = 0;
+		if (NewNum > OldNum)
+		{
+			RunTransforms.Reset(NewNum - OldNum);
+			RunTransforms.Append(LocalTransforms.GetData() + OldNum, NewNum - OldNum);
+			Component->AddInstances(RunTransforms, false, false);
+			AddedNum = NewNum - OldNum;
+		}
+		else if (NewNum == 0 && OldNum > 0)
+		{
+			Component->ClearInstances();
+			RemovedNum = OldNum;
+		}
+		else if (NewNum < OldNum)
+		{
+			TArray<int32> Removed;
+			Removed.Reserve(OldNum - NewNum);
+			for (int32 i = OldNum - 1; i >= NewNum; --i)
+			{
+				Removed.Add(i);
+			}
+			Component->RemoveInstances(Removed);
+			RemovedNum = OldNum - NewNum;
+		}
+
+		INC_DWORD_STAT_BY(STAT_ToolKits_FenceInstancesAdded, AddedNum);
+		INC_DWORD_STAT_BY(STAT_ToolKits_FenceInstancesUpdated, UpdatedNum);
+		INC_DWORD_STAT_BY(STAT_ToolKits_FenceInstancesRemoved, RemovedNum);
+
+		const int32 ChangedNum = UpdatedNum + AddedNum + RemovedNum;
+		if (ChangedNum > 0)
+		{
+			Component->MarkRenderStateDirty();
+			// 异步重建集群树，完成前使用未剔除的实例渲染
+			Component->BuildTreeIfOutdated(true, false);
+		}
+		return ChangedNum;
+	}
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FenceNavModifierComponent.h"
+
+#include "AI/NavigationModifier.h"
+#include "AI/Navigation/NavigationRelevantData.h"
+#include "NavAreas/NavArea_Null.h"
+
+UFenceNavModifierComponent::UFenceNavModifierComponent()
+{
+	AreaClass = UNavArea_Null::StaticClass();
+}
+
+// 设置围栏
+void UFenceNavModifierComponent::SetPosts(const TArrayView<const FTransform> InTransforms, const TArrayView<const FBox> InBoxes)
+{
+	check(InTransforms.Num() == InBoxes.Num());
+
+	PostTransforms = InTransforms;
+	PostBoxes = InBoxes;
+	AlivePosts.Init(true, PostTransforms.Num());
+	SetNavigationRelevancy(!PostTransforms.IsEmpty());
+}
+
+// 设置围栏是否存在
+void UFenceNavModifierComponent::SetPostAlive(const int32 Index, const bool bAlive)
+{
+	if (!AlivePosts.IsValidIndex(Index)) return;
+
+	AlivePosts[Index] = bAlive;
+	// 全部被移除后不再参与导航
+	SetNavigationRelevancy(AlivePosts.Contains(true));
+}
+
+// 计算包围盒
+void UFenceNavModifierComponent::CalcAndCacheBounds() const
+{
+	Bounds.Init();
+	for (TConstSetBitIterator<> It(AlivePosts); It; ++It)
+	{
+		Bounds += PostBoxes[It.GetIndex()].TransformBy(PostTransforms[It.GetIndex()]);
+	}
+}
+
+// 导出导航数据，每个存在的围栏一个包围盒
+void UFenceNavModifierComponent::GetNavigationData(FNavigationRelevantData& Data) const
+{
+	for (TConstSetBitIterator<> It(AlivePosts); It; ++It)
+	{
+		const int32 Index = It.GetIndex();
+		Data.Modifiers.Add(FAreaNavModifier(PostBoxes[Index], PostTransforms[Index], AreaClass));
+	}
+}
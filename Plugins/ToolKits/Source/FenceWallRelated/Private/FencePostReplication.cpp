@@ -0,0 +1,150 @@
+#include "FencePostReplication.h"
+
+#include "FenceSpline.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/BitWriter.h"
+
+// 客户端收到新的组
+void FFencePostStateChunk::PostReplicatedAdd(const FFencePostStateArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->ApplyPostStateChunk(*this);
+	}
+}
+
+// 客户端收到组的变化
+void FFencePostStateChunk::PostReplicatedChange(const FFencePostStateArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner != nullptr)
+	{
+		InArraySerializer.Owner->ApplyPostStateChunk(*this);
+	}
+}
+
+// 网络序列化
+bool FFencePostStateChunk::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 Index = ChunkIndex;
+	Ar.SerializeIntPacked(Index);
+	ChunkIndex = static_cast<uint16>(Index);
+
+	for (uint16& State : States)
+	{
+		if (Ar.IsLoading())
+		{
+			State = 0;
+		}
+		Ar.SerializeBits(&State, FencePostState::NumBits);
+	}
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+// 初始化
+void FFencePostStateArray::Init(const int32 PostCount, const uint16 DefaultState)
+{
+	const int32 ChunkNum = FMath::DivideAndRoundUp(PostCount, FFencePostStateChunk::PostNum);
+	Chunks.SetNum(ChunkNum);
+	for (int32 i = 0; i < ChunkNum; ++i)
+	{
+		FFencePostStateChunk& Chunk = Chunks[i];
+		Chunk.ChunkIndex = static_cast<uint16>(i);
+		for (uint16& State : Chunk.States)
+		{
+			State = DefaultState;
+		}
+		MarkItemDirty(Chunk);
+	}
+	MarkArrayDirty();
+}
+
+// 获取围栏的状态
+uint16 FFencePostStateArray::GetState(const int32 PostIndex) const
+{
+	const int32 Chunk = PostIndex / FFencePostStateChunk::PostNum;
+	return PostIndex >= 0 && Chunks.IsValidIndex(Chunk) ? Chunks[Chunk].States[PostIndex % FFencePostStateChunk::PostNum] : 0;
+}
+
+// 设置围栏的状态
+bool FFencePostStateArray::SetState(const int32 PostIndex, const uint16 NewState)
+{
+	const int32 Chunk = PostIndex / FFencePostStateChunk::PostNum;
+	if (PostIndex < 0 || !Chunks.IsValidIndex(Chunk)) return false;
+
+	uint16& State = Chunks[Chunk].States[PostIndex % FFencePostStateChunk::PostNum];
+	if (State == NewState) return false;
+
+	State = NewState;
+	MarkItemDirty(Chunks[Chunk]);
+	return true;
+}
+
+#if !UE_BUILD_SHIPPING
+// 估算一次更新发送的字节数：每个变化的组写入复制ID和组内容，不含数据包头
+static FAutoConsoleCommand FencePostReplicationBytesCommand(
+	TEXT("ToolKits.Fence.ReplicationBytes"),
+	TEXT("输出 2000 个围栏中 10% 变化（连续缺口 / 随机分布）时一次复制更新的字节数"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		constexpr int32 PostCount = 2000;
+		constexpr int32 ChangedCount = PostCount / 10;
+		const uint16 DefaultState = FencePostState::AliveBit | FencePostState::VisibleBit;
+
+		// 按变化的围栏统计需要发送的组
+		auto Measure = [DefaultState, &Ar](const TCHAR* Name, const TArray<int32>& ChangedPosts)
+		{
+			FFencePostStateArray StateArray;
+			StateArray.Init(PostCount, DefaultState);
+
+			TBitArray<> DirtyChunks(false, StateArray.Chunks.Num());
+			for (const int32 PostIndex : ChangedPosts)
+			{
+				if (StateArray.SetState(PostIndex, StateArray.GetState(PostIndex) & ~FencePostState::AliveBit))
+				{
+					DirtyChunks[PostIndex / FFencePostStateChunk::PostNum] = true;
+				}
+			}
+
+			FBitWriter Writer(0, true);
+			for (TConstSetBitIterator<> It(DirtyChunks); It; ++It)
+			{
+				FFencePostStateChunk& Chunk = StateArray.Chunks[It.GetIndex()];
+				uint32 ReplicationID = It.GetIndex();
+				Writer.SerializeIntPacked(ReplicationID);
+				bool bSuccess = false;
+				Chunk.NetSerialize(Writer, nullptr, bSuccess);
+			}
+
+			const int32 FullBytes = FMath::DivideAndRoundUp(StateArray.Chunks.Num() * (FFencePostStateChunk::PostNum * FencePostState::NumBits + 16), 8);
+			Ar.Logf(TEXT("%s: %d 组变化, %lld 字节 (完整同步 %d 字节, 每个围栏一个 Actor 约 %d 个通道)"),
+			        Name, DirtyChunks.CountSetBits(), Writer.GetNumBytes(), FullBytes, ChangedCount);
+		};
+
+		TArray<int32> ChangedPosts;
+		ChangedPosts.Reserve(ChangedCount);
+
+		// 连续缺口
+		const int32 First = PostCount / 3;
+		for (int32 i = 0; i < ChangedCount; ++i)
+		{
+			ChangedPosts.Add(First + i);
+		}
+		Measure(TEXT("连续缺口"), ChangedPosts);
+
+		// 随机分布
+		FRandomStream Random(PostCount);
+		TBitArray<> Picked(false, PostCount);
+		ChangedPosts.Reset();
+		while (ChangedPosts.Num() < ChangedCount)
+		{
+			const int32 PostIndex = Random.RandRange(0, PostCount - 1);
+			if (!Picked[PostIndex])
+			{
+				Picked[PostIndex] = true;
+				ChangedPosts.Add(PostIndex);
+			}
+		}
+		Measure(TEXT("随机分布"), ChangedPosts);
+	}));
+#endif
@@ -4,14 +4,24 @@
 #include "FenceSpline.h"
 
 #include "SingleFence_Base.h"
+#include "FenceInstanceSync.h"
+#include "FenceNavModifierComponent.h"
+#include "FenceGenerationSubsystem.h"
+#include "ToolKitsStats.h"
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Components/SplineComponent.h"
 #include "YCTArray.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/World.h"
+#include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
+#include "YC_Log.h"
+#if WITH_EDITOR
+#include "UObject/ObjectSaveContext.h"
+#endif
 
 // Sets default values
-AFenceSpline::AFenceSpline(): bDefaultDisplay(true)
+AFenceSpline::AFenceSpline(): bDefaultDisplay(true), bSnapToGround(false), bAffectNavigation(true), bReplicatePostStates(false), bRealizeImmediately(true), bNavFlushPending(false)
 {
 	// 关闭Tick
 	PrimaryActorTick.bCanEverTick = false;
@@ -24,15 +34,40 @@ AFenceSpline::AFenceSpline(): bDefaultDisplay(true)
 	Spline->SetupAttachment(RootComponent);
 }
 
+void AFenceSpline::PostInitProperties()
+{
+	Super::PostInitProperties();
+	PostStates.Owner = this;
+}
+
+void AFenceSpline::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AFenceSpline, PostStates);
+}
+
 void AFenceSpline::BeginPlay()
 {
 	Super::BeginPlay();
+	// 由调度统一安排生成顺序和每帧的耗时
+	if (UFenceGenerationSubsystem* GenerationSubsystem = GetWorld()->GetSubsystem<UFenceGenerationSubsystem>())
+	{
+		GenerationSubsystem->RequestGeneration(this);
+		return;
+	}
 	GeneratingFences();
 }
 
 void AFenceSpline::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
+
+	// 围栏在各端按烘焙的布局生成，只复制每个围栏的状态，城墙通常横跨整个关卡，不按距离剔除
+	bAlwaysRelevant = bReplicatePostStates;
+	if (GetIsReplicated() != static_cast<bool>(bReplicatePostStates))
+	{
+		SetReplicates(bReplicatePostStates);
+	}
 	AddDisplayModel();
 }
 
@@ -78,52 +113,211 @@ FVector AFenceSpline::GetMeshLength(int32 Index)
 	}
 }
 
-// 获取临时变换数组
-TArray<FTransform> AFenceSpline::GetTempTransforms()
+// 布局格式版本，计算方式改变时递增，旧的烘焙数据会自动失效
+static constexpr uint32 FenceLayoutVersion = 1;
+
+// 计算样条线和参数的哈希
+uint32 AFenceSpline::ComputeLayoutHash() const
+{
+	uint32 Hash = FCrc::MemCrc32(&FenceLayoutVersion, sizeof(FenceLayoutVersion));
+	auto HashValue = [&Hash](const auto& Value)
+	{
+		Hash = FCrc::MemCrc32(&Value, sizeof(Value), Hash);
+	};
+
+	HashValue(DisplayNum);
+	HashValue(Size);
+	HashValue(Interval);
+
+	// 模型的路径和长度
+	for (const UStaticMesh* Model : DisplayModels)
+	{
+		if (Model == nullptr)
+		{
+			HashValue(0u);
+			continue;
+		}
+		Hash = FCrc::StrCrc32(*Model->GetPathName(), Hash);
+		HashValue(Model->GetBounds().BoxExtent);
+	}
+
+	if (!Spline) return Hash;
+
+	// 样条线相对于 Actor 的变换和每个点
+	const FTransform SplineTransform = Spline->GetRelativeTransform();
+	HashValue(SplineTransform.GetLocation());
+	HashValue(SplineTransform.GetRotation());
+	HashValue(SplineTransform.GetScale3D());
+	HashValue(Spline->IsClosedLoop());
+	const int32 PointNum = Spline->GetNumberOfSplinePoints();
+	HashValue(PointNum);
+	for (int32 i = 0; i < PointNum; ++i)
+	{
+		HashValue(Spline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local));
+		HashValue(Spline->GetArriveTangentAtSplinePoint(i, ESplineCoordinateSpace::Local));
+		HashValue(Spline->GetLeaveTangentAtSplinePoint(i, ESplineCoordinateSpace::Local));
+		HashValue(Spline->GetQuaternionAtSplinePoint(i, ESplineCoordinateSpace::Local));
+		HashValue(Spline->GetScaleAtSplinePoint(i));
+		HashValue(static_cast<uint8>(Spline->GetSplinePointType(i)));
+	}
+	return Hash;
+}
+
+// 沿样条线计算布局
+void AFenceSpline::ComputeLayout(FFenceLayout& OutLayout)
 {
+	OutLayout.Reset();
+
+	// 缓存模型长度
+	TArray<float> ModelLengths;
+	if (!GetLayoutModelLengths(ModelLengths)) return;
+
+	// 创建一个异步任务，处理坐标数组
+	FGraphEventRef TransformsTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,&ModelLengths,&OutLayout]()
+	{
+		SampleLayout(ModelLengths, OutLayout);
+	}, GET_STATID(STAT_ToolKits_FenceTransformsTask), nullptr, ENamedThreads::Type::AnyThread);
+	// 等待任务完成
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(TransformsTask);
+
+	OutLayout.SourceHash = ComputeLayoutHash();
+}
+
+// 收集计算布局需要的模型长度
+bool AFenceSpline::GetLayoutModelLengths(TArray<float>& OutModelLengths)
+{
+	OutModelLengths.Reset();
 	// 模型数量为0 或者 显示数量为0
-	if (DisplayModels.Num() <= 0 || DisplayNum <= 0) return TArray<FTransform>();
+	if (DisplayModels.Num() <= 0 || DisplayNum <= 0) return false;
 	// 获取曲线
-	if (!Spline) return TArray<FTransform>();
-	// 模型数量
-	int32 ModelNum = DisplayModels.Num();
-	// 临时坐标数组
-	TArray<FTransform> TempTransforms = TArray<FTransform>();
+	if (!Spline) return false;
+	// 模型数量，下标用 uint8 保存
+	const int32 ModelNum = DisplayModels.Num();
+	if (!ensureMsgf(ModelNum <= MAX_uint8 + 1, TEXT("围栏模型数量不能超过 %d"), MAX_uint8 + 1)) return false;
+
+	for (int32 i = 0; i < ModelNum; ++i)
+	{
+		OutModelLengths.Add(GetMeshLength(i).X);
+	}
+	return true;
+}
+
+// 沿样条线采样布局
+void AFenceSpline::SampleLayout(const TConstArrayView<float> ModelLengths, FFenceLayout& OutLayout) const
+{
+	OutLayout.Reset();
+	const int32 ModelNum = ModelLengths.Num();
+	if (ModelNum <= 0 || DisplayNum <= 0 || !Spline) return;
+
+	OutLayout.Transforms.Reserve(DisplayNum);
+	OutLayout.MeshIndices.Reserve(DisplayNum);
+	OutLayout.Distances.Reserve(DisplayNum);
+
+	// 样条线相对于 Actor 的变换，布局保存为相对于 Actor 的变换
+	const FTransform SplineTransform = Spline->GetRelativeTransform();
+
 	// 当前所在的临时距离
 	float CurrentDistance = 0.f;
-	// 缓存模型长度
-	TArray<float> ModelLengths;
-	for (int32 i = 0; i < ModelNum; ++i)
+	// 根据显示数量生成临时坐标
+	for (int i = 0; i <= DisplayNum - 1; i++)
 	{
-		ModelLengths.Add(GetMeshLength(i).X);
+		// 余数
+		int32 TempIndex = i % ModelNum;
+		// 实际编号
+		int32 ActualNumber = TempIndex == 0 ? ModelNum - 1 : TempIndex - 1;
+		// 实际间隔
+		float ActualInterval = i == 0 ? 0.f : Interval;
+		// 当前模型长度
+		float IntervalModelLength = i == 0 ? 0.f : ModelLengths[ActualNumber];
+		// 当前距离
+		CurrentDistance += ActualInterval + IntervalModelLength;
+		// 临时坐标
+		FTransform ATransforms = Spline->GetTransformAtDistanceAlongSpline(CurrentDistance, ESplineCoordinateSpace::Local, true);
+		// 设置缩放
+		ATransforms.SetScale3D(ATransforms.GetScale3D() * Size);
+		// 添加到数组
+		OutLayout.Transforms.Add(ATransforms * SplineTransform);
+		OutLayout.MeshIndices.Add(static_cast<uint8>(TempIndex));
+		OutLayout.Distances.Add(CurrentDistance);
 	}
+}
 
-	// 创建一个异步任务，处理坐标数组
-	FGraphEventRef TransformsTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,ModelNum,ModelLengths,&CurrentDistance,&TempTransforms]()
+// 烘焙的布局是否可以直接使用
+bool AFenceSpline::CanUseBakedLayout(uint32& OutHash) const
+{
+	OutHash = 0;
+	bool bTrustBakedLayout = BakedLayout.Num() > 0;
+#if WITH_EDITOR
+	// 编辑器中样条线随时可能被修改，PIE 也可能使用未保存的修改，保持按哈希重新采样
+	bTrustBakedLayout &= !GIsEditor;
+#endif
+	if (bTrustBakedLayout)
 	{
-		// 根据显示数量生成临时坐标
-		for (int i = 0; i <= DisplayNum - 1; i++)
+#if !UE_BUILD_SHIPPING
+		// 发行版本不计算哈希，其他版本提示重新烘焙
+		if (BakedLayout.SourceHash != ComputeLayoutHash())
 		{
-			// 余数
-			int32 TempIndex = i % ModelNum;
-			// 实际编号
-			int32 ActualNumber = TempIndex == 0 ? ModelNum - 1 : TempIndex - 1;
-			// 实际间隔
-			float ActualInterval = i == 0 ? 0.f : Interval;
-			// 当前模型长度
-			float IntervalModelLength = i == 0 ? 0.f : ModelLengths[ActualNumber];
-			// 当前距离
-			CurrentDistance += ActualInterval + IntervalModelLength;
-			// 临时坐标
-			FTransform ATransforms = Spline->GetTransformAtDistanceAlongSpline(CurrentDistance, ESplineCoordinateSpace::World, true);
-			// 设置缩放
-			ATransforms.SetScale3D(ATransforms.GetScale3D() * Size);
-			// 添加到数组
-			TempTransforms.Add(ATransforms);
+			YICHEN_CLOG(Fence, Warning, "%s 烘焙的布局已过期，仍使用烘焙的 %d 个围栏，请在编辑器中重新烘焙", *GetName(), BakedLayout.Num());
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::AnyThread);
-	// 等待任务完成
-	FTaskGraphInterface::Get().WaitUntilTaskCompletes(TransformsTask);
+#endif
+		return true;
+	}
+
+	// 没有烘焙的布局（例如运行时生成的围栏样条线）或在编辑器中，哈希只遍历样条线的点，比沿样条线计算布局便宜得多
+	OutHash = ComputeLayoutHash();
+	return IsLayoutValid(OutHash);
+}
+
+// 获取布局
+const FFenceLayout& AFenceSpline::GetLayout()
+{
+	uint32 Hash;
+	if (!CanUseBakedLayout(Hash))
+	{
+		ComputeLayout(BakedLayout);
+	}
+	else
+	{
+		YICHEN_CLOG(Fence, Verbose, "%s 使用烘焙的布局，共 %d 个围栏", *GetName(), BakedLayout.Num());
+	}
+	return BakedLayout;
+}
+
+// 烘焙布局
+void AFenceSpline::BakeLayout()
+{
+	if (IsLayoutValid(ComputeLayoutHash())) return;
+
+	Modify();
+	ComputeLayout(BakedLayout);
+	YICHEN_CLOG(Fence, Log, "%s 烘焙布局，共 %d 个围栏", *GetName(), BakedLayout.Num());
+}
+
+#if WITH_EDITOR
+// 保存和烘焙前更新布局
+void AFenceSpline::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		BakeLayout();
+	}
+}
+#endif
+
+// 获取临时变换数组
+TArray<FTransform> AFenceSpline::GetTempTransforms()
+{
+	const FFenceLayout& Layout = GetLayout();
+
+	// 转换为世界坐标
+	const FTransform ActorTransform = GetActorTransform();
+	TArray<FTransform> TempTransforms;
+	TempTransforms.Reserve(Layout.Num());
+	for (const FTransform& Transform : Layout.Transforms)
+	{
+		TempTransforms.Add(Transform * ActorTransform);
+	}
 
 	// 返回临时坐标数组
 	return TempTransforms;
@@ -133,107 +327,235 @@ TArray<FTransform> AFenceSpline::GetTempTransforms()
 // 本函数负责将DisplayModel数组中的模型添加到InstancedStaticMeshComponents中，并根据临时变换数组生成实例
 void AFenceSpline::AddDisplayModel()
 {
-	// 清空实例数组
-	if (!InstancedStaticMeshComponents.IsEmpty())
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::AddDisplayModel);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_AddDisplayModel);
+
+	// 如果显示模型数组为空或显示数量小于等于0，则移除所有组件后直接返回
+	if (DisplayModels.IsEmpty() || DisplayNum <= 0)
 	{
-		for (auto& StaticMeshComponent : InstancedStaticMeshComponents)
-		{
-			// 添加空指针检查,清除实例并清空数组
-			if (StaticMeshComponent != nullptr)
-			{
-				// 清除实例
-				StaticMeshComponent->ClearInstances();
-				if (StaticMeshComponent->IsRegistered()) // 检查是否已注册
-				{
-					StaticMeshComponent->UnregisterComponent(); // 卸载组件
-				}
-				StaticMeshComponent->DestroyComponent();
-			}
-		}
-		InstancedStaticMeshComponents.Empty();
+		FenceInstanceSync::SyncComponents(this, InstancedStaticMeshComponents, {}, [](UHierarchicalInstancedStaticMeshComponent*, UStaticMesh*) {});
+		return;
 	}
 
-	// 如果显示模型数组为空或显示数量小于等于0，则直接返回
-	if (DisplayModels.IsEmpty() || DisplayNum <= 0)return;
-
-	// 模型数量
-	int32 ModelNum = DisplayModels.Num();
-
-	// 预分配实例数组
-	InstancedStaticMeshComponents.Reserve(ModelNum);
-
-	// 创建一个异步任务，处理实例静态网格组件
-	FGraphEventRef ComponentTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,ModelNum]()
+	// 创建一个异步任务，同步实例静态网格组件，上次构造时创建的组件会被复用
+	FGraphEventRef ComponentTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
 	{
-		// 遍历显示模型数组，为每个模型创建一个层级实例静态网格组件
-		for (int32 i = 0; i < ModelNum; i++)
+		FenceInstanceSync::SyncComponents(this, InstancedStaticMeshComponents, DisplayModels, [this](UHierarchicalInstancedStaticMeshComponent* Component, UStaticMesh* Model)
 		{
-			// 确保模型指针不为空
-			if (DisplayModels[i] != nullptr)
+			InitializeComponent(Component, Model);
+		});
+
+		// 复用的组件也需要更新阵营颜色
+		for (UHierarchicalInstancedStaticMeshComponent* Component : InstancedStaticMeshComponents)
+		{
+			if (Component != nullptr)
 			{
-				FString ComponentName = FString::Printf(TEXT("HISMComponent_%d"), i);
-				// 创建层级实例静态网格组件
-				UHierarchicalInstancedStaticMeshComponent* HISMComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, UHierarchicalInstancedStaticMeshComponent::StaticClass(), *ComponentName);
-				if (HISMComponent)
-				{
-					InitializeComponent(HISMComponent, DisplayModels[i]);
-					InstancedStaticMeshComponents.Add(HISMComponent);
-				}
+				Component->SetVectorParameterValueOnMaterials("CampColor", FVector(CampColor.R, CampColor.G, CampColor.B));
 			}
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
+	}, GET_STATID(STAT_ToolKits_FenceComponentsTask), nullptr, ENamedThreads::Type::GameThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(ComponentTask);
 
-	FGraphEventRef AddMeshTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,ModelNum]()
+	FGraphEventRef AddMeshTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
 	{
 		// 获取临时变换数组
 		TArray<FTransform> TempFTransforms = GetTempTransforms();
+		const TArray<uint8>& MeshIndices = BakedLayout.MeshIndices;
 
-		// 临时变量，用于记录当前实例化的模型编号
-		int TempNum = 0;
-		// 遍历临时变换数组，为每个变换添加实例
-		for (auto StaticMeshTransform : TempFTransforms)
+		// 按模型分组，组件与模型一一对应
+		TArray<TArray<FTransform>> GroupedTransforms;
+		GroupedTransforms.SetNum(InstancedStaticMeshComponents.Num());
+		for (int32 i = 0; i < TempFTransforms.Num(); ++i)
 		{
-			// 确保数组索引有效
-			if (InstancedStaticMeshComponents.IsValidIndex(TempNum % ModelNum))
+			if (GroupedTransforms.IsValidIndex(MeshIndices[i]))
 			{
-				InstancedStaticMeshComponents[TempNum % ModelNum]->AddInstance(StaticMeshTransform, true);
-				TempNum++;
+				GroupedTransforms[MeshIndices[i]].Add(TempFTransforms[i]);
 			}
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
+
+		// 与已有实例对比，只提交变化的部分
+		for (int32 i = 0; i < InstancedStaticMeshComponents.Num(); ++i)
+		{
+			FenceInstanceSync::SyncInstances(InstancedStaticMeshComponents[i], GroupedTransforms[i]);
+		}
+	}, GET_STATID(STAT_ToolKits_FenceInstancesTask), nullptr, ENamedThreads::Type::GameThread);
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(AddMeshTask);
 }
 
 // 生成围栏
 void AFenceSpline::GeneratingFences()
 {
-	if (DisplayModels.IsEmpty() || SingleFenceClass == nullptr) return;
-	TArray<FTransform> TempTransforms = GetTempTransforms();
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::GeneratingFences);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_GeneratingFences);
+
+	GenerateFromTransforms(PrepareFenceTransforms());
+}
+
+// 计算生成用的世界变换
+TArray<FTransform> AFenceSpline::PrepareFenceTransforms()
+{
+	if (DisplayModels.IsEmpty()) return TArray<FTransform>();
+	return GetTempTransforms();
+}
+
+// 按计算好的变换生成围栏
+void AFenceSpline::GenerateFromTransforms(TArray<FTransform>&& TempTransforms, const bool bRealizeNow)
+{
+	if (TempTransforms.IsEmpty() || GetWorld() == nullptr) return;
+
+	// 服务器重置复制的状态，客户端等待生成后再应用
+	AppliedPostStates.Reset();
+	if (HasAuthority())
+	{
+		PostStates.Init(TempTransforms.Num(), GetDefaultPostState());
+	}
+
+	// 贴合地面时等检测结果返回后再生成
+	bRealizeImmediately = bRealizeNow;
+	if (bSnapToGround)
+	{
+		StartGroundSnap(MoveTemp(TempTransforms));
+		return;
+	}
+	BeginRealizeFences(MoveTemp(TempTransforms));
+}
+
+// 开始生成围栏
+void AFenceSpline::BeginRealizeFences(TArray<FTransform>&& Transforms)
+{
+	RealizeTransforms = MoveTemp(Transforms);
+	NextRealizePost = 0;
+	if (bRealizeImmediately)
+	{
+		ContinueRealizeFences(TNumericLimits<double>::Max());
+	}
+}
+
+// 继续分帧生成围栏
+int32 AFenceSpline::ContinueRealizeFences(const double EndTime)
+{
+	if (!IsRealizingFences()) return 0;
+
+	const int32 FirstPost = NextRealizePost;
+	NextRealizePost = RealizeFences(RealizeTransforms, FirstPost, EndTime);
+	const int32 RealizedNum = NextRealizePost - FirstPost;
+	if (NextRealizePost >= RealizeTransforms.Num())
+	{
+		NextRealizePost = INDEX_NONE;
+		RealizeTransforms.Empty();
+		ApplyReplicatedPostStates();
+	}
+	return RealizedNum;
+}
+
+// 开始贴合地面
+void AFenceSpline::StartGroundSnap(TArray<FTransform>&& Transforms)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+
+	if (!GroundTraceDelegate.IsBound())
+	{
+		GroundTraceDelegate.BindUObject(this, &AFenceSpline::OnGroundTraceDone);
+	}
+
+	// 之前未完成的检测会因为句柄不一致而被忽略
+	GroundSnapTransforms = MoveTemp(Transforms);
+	GroundTraceHandles.SetNum(GroundSnapTransforms.Num());
+	PendingGroundTraces = GroundSnapTransforms.Num();
+
+	// 所有检测在同一帧提交，由物理线程批量执行，下一帧返回结果
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FenceGroundSnap), false, this);
+	for (int32 i = 0; i < GroundSnapTransforms.Num(); ++i)
+	{
+		const FVector Location = GroundSnapTransforms[i].GetLocation();
+		const FVector Offset = FVector::UpVector * GroundTraceDistance;
+		GroundTraceHandles[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Location + Offset, Location - Offset, GroundTraceChannel,
+		                                                       QueryParams, FCollisionResponseParams::DefaultResponseParam, &GroundTraceDelegate, i);
+	}
+	YICHEN_CLOG(Fence, Verbose, "%s 提交 %d 个贴合地面检测", *GetName(), PendingGroundTraces);
+}
+
+// 异步检测完成
+void AFenceSpline::OnGroundTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::OnGroundTraceDone);
+
+	const int32 Index = static_cast<int32>(TraceDatum.UserData);
+	if (!GroundTraceHandles.IsValidIndex(Index) || !(GroundTraceHandles[Index] == TraceHandle)) return;
+
+	// 命中时调整高度，并按倾斜程度把向上方向转向地面法线
+	if (!TraceDatum.OutHits.IsEmpty() && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		const FHitResult& Hit = TraceDatum.OutHits[0];
+		FTransform& Transform = GroundSnapTransforms[Index];
+		FVector Location = Transform.GetLocation();
+		Location.Z = Hit.ImpactPoint.Z + GroundOffset;
+		Transform.SetLocation(Location);
+
+		const FVector Up = FMath::Lerp(FVector::UpVector, FVector(Hit.ImpactNormal), GroundAlignment).GetSafeNormal();
+		if (!Up.IsNearlyZero())
+		{
+			Transform.SetRotation(FQuat::FindBetweenNormals(FVector::UpVector, Up) * Transform.GetRotation());
+		}
+	}
+	GroundTraceHandles[Index] = FTraceHandle();
+
+	if (--PendingGroundTraces > 0) return;
+
+	// 全部返回后生成围栏
+	GroundTraceHandles.Reset();
+	BeginRealizeFences(MoveTemp(GroundSnapTransforms));
+}
+
+// 生成围栏单体
+int32 AFenceSpline::RealizeFences(const TArray<FTransform>& Transforms, const int32 FirstPost, const double EndTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::RealizeFences);
+
 	UWorld* World = GetWorld();
-	if (TempTransforms.IsEmpty() || World == nullptr) return;
+	if (World == nullptr || SingleFenceClass == nullptr || Transforms.Num() != BakedLayout.Num()) return Transforms.Num();
+
+	// 第一次调用时重置
+	if (FirstPost == 0)
+	{
+		PostsByIndex.Reset();
+		PostsByIndex.SetNum(Transforms.Num());
+		SpawnedPosts.Init(false, Transforms.Num());
+	}
 
 	// 创建一个异步任务，用于生成围栏对象
-	FGraphEventRef SpawnTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,World,&TempTransforms]()
+	int32 NextPost = FirstPost;
+	FGraphEventRef SpawnTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,World,&Transforms,&NextPost,EndTime]()
 	{
-		// 模型数量
-		int32 ModelNum = DisplayModels.Num();
-		int index = 0;
+		// 每个围栏的模型下标
+		const TArray<uint8>& MeshIndices = BakedLayout.MeshIndices;
 		FActorSpawnParameters SpawnParameters;
 		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		// 导航由分段的修改器统一处理时，延迟构造以便在组件注册前关闭单个围栏的导航
+		SpawnParameters.bDeferConstruction = bAffectNavigation;
 
-		// 遍历临时变换数组，用于在特定位置生成单个围栏对象
-		for (auto SpawnTransform : TempTransforms)
+		// 遍历临时变换数组，用于在特定位置生成单个围栏对象，每个围栏生成后检查截止时间
+		while (NextPost < Transforms.Num())
 		{
+			const int32 i = NextPost++;
 			// 在指定的位置和参数下生成单个围栏对象
-			if (ASingleFence_Base* SingleFence_Base = World->SpawnActor<ASingleFence_Base>(SingleFenceClass, SpawnTransform, SpawnParameters))
+			if (ASingleFence_Base* SingleFence_Base = World->SpawnActor<ASingleFence_Base>(SingleFenceClass, Transforms[i], SpawnParameters))
 			{
+				INC_DWORD_STAT(STAT_ToolKits_FencePostsSpawned);
+
+				if (bAffectNavigation)
+				{
+					SingleFence_Base->SetAffectNavigation(false);
+					SingleFence_Base->FinishSpawning(Transforms[i]);
+				}
+
 				// 将生成的围栏对象附加到当前对象上，保持其在世界中的变换
 				SingleFence_Base->AttachToComponent(Spline, FAttachmentTransformRules::KeepWorldTransform);
 
-				// 设置围栏对象的显示模型，根据索引选择合适的模型
-				SingleFence_Base->SetFenceMesh(DisplayModels[index % ModelNum]);
+				// 设置围栏对象的显示模型，使用布局中的模型下标
+				SingleFence_Base->SetFenceMesh(DisplayModels[MeshIndices[i]]);
 
 				// 设置围栏对象的阵营颜色，使其与当前对象一致
 				SingleFence_Base->SetCampColor(CampColor);
@@ -247,21 +569,35 @@ void AFenceSpline::GeneratingFences()
 				// 将围栏对象添加到列表中，便于后续管理
 				AllSingleFences.AddUnique(SingleFence_Base);
 
-				// 增加索引，用于选择下一个模型或颜色等
-				index++;
+				// 记录下标，被移除时更新复制的状态和所在分段的导航
+				SpawnedPosts[i] = true;
+				PostsByIndex[i] = SingleFence_Base;
+				PostIndices.Add(SingleFence_Base, i);
+				SingleFence_Base->OnDestroyed.AddDynamic(this, &AFenceSpline::OnFencePostDestroyed);
 			}
+
+			if (FPlatformTime::Seconds() >= EndTime) break;
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
+	}, GET_STATID(STAT_ToolKits_FenceSpawnTask), nullptr, ENamedThreads::Type::GameThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(SpawnTask);
 
+	// 还有没生成的围栏，下次继续
+	if (NextPost < Transforms.Num()) return NextPost;
+
+	if (bAffectNavigation)
+	{
+		BuildNavModifiers(Transforms, SpawnedPosts);
+	}
+	SpawnedPosts.Empty();
+
 	// 反转数组
 	ReverseTArray(AllSingleFences);
 
 	// 如果实例静态网格组件数组不为空，则清除所有实例并清空数组
 	if (!InstancedStaticMeshComponents.IsEmpty())
 	{
-		for (auto* StaticMeshComponent : InstancedStaticMeshComponents)
+		for (auto& StaticMeshComponent : InstancedStaticMeshComponents)
 		{
 			// 添加空指针检查,清除实例并清空数组
 			if (StaticMeshComponent != nullptr)
@@ -269,4 +605,222 @@ void AFenceSpline::GeneratingFences()
 		}
 		InstancedStaticMeshComponents.Empty();
 	}
+	return NextPost;
+}
+
+// 按分段创建导航修改器
+void AFenceSpline::BuildNavModifiers(const TArray<FTransform>& Transforms, const TBitArray<>& Spawned)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::BuildNavModifiers);
+
+	for (UFenceNavModifierComponent* Component : NavModifierComponents)
+	{
+		if (Component != nullptr)
+		{
+			Component->DestroyComponent();
+		}
+	}
+	NavModifierComponents.Reset();
+	DirtyNavSegments.Reset();
+
+	// 每个围栏的局部包围盒
+	const TArray<uint8>& MeshIndices = BakedLayout.MeshIndices;
+	TArray<FBox> Boxes;
+	Boxes.Reserve(Transforms.Num());
+	for (int32 i = 0; i < Transforms.Num(); ++i)
+	{
+		const UStaticMesh* Model = DisplayModels[MeshIndices[i]];
+		Boxes.Add(Model != nullptr ? Model->GetBounds().GetBox() : FBox(FVector::ZeroVector, FVector::ZeroVector));
+	}
+
+	const int32 SegmentSize = FMath::Max(NavPostsPerSegment, 1);
+	const int32 SegmentNum = FMath::DivideAndRoundUp(Transforms.Num(), SegmentSize);
+	NavModifierComponents.Reserve(SegmentNum);
+	for (int32 Segment = 0; Segment < SegmentNum; ++Segment)
+	{
+		const int32 First = Segment * SegmentSize;
+		const int32 Count = FMath::Min(SegmentSize, Transforms.Num() - First);
+
+		UFenceNavModifierComponent* Component = NewObject<UFenceNavModifierComponent>(this, MakeUniqueObjectName(this, UFenceNavModifierComponent::StaticClass(), TEXT("FenceNavModifier")));
+		if (NavAreaClass)
+		{
+			Component->AreaClass = NavAreaClass;
+		}
+		Component->SetPosts(MakeArrayView(Transforms.GetData() + First, Count), MakeArrayView(Boxes.GetData() + First, Count));
+		// 生成失败的围栏不参与导航
+		for (int32 i = 0; i < Count; ++i)
+		{
+			if (!Spawned[First + i])
+			{
+				Component->SetPostAlive(i, false);
+			}
+		}
+		// 注册时加入导航八叉树
+		Component->RegisterComponent();
+		NavModifierComponents.Add(Component);
+	}
+	YICHEN_CLOG(Fence, Verbose, "%s 创建 %d 个导航修改器", *GetName(), SegmentNum);
+}
+
+// 围栏被销毁
+void AFenceSpline::OnFencePostDestroyed(AActor* DestroyedActor)
+{
+	int32 Index;
+	if (PostIndices.RemoveAndCopyValue(DestroyedActor, Index))
+	{
+		SetFencePostRemoved(Index);
+		MarkPostRemovedFromNavigation(Index);
+	}
+}
+
+// 围栏被移除
+void AFenceSpline::MarkPostRemovedFromNavigation(const int32 PostIndex)
+{
+	// 关卡卸载时不需要更新导航
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->bIsTearingDown || IsActorBeingDestroyed()) return;
+
+	const int32 SegmentSize = FMath::Max(NavPostsPerSegment, 1);
+	const int32 Segment = PostIndex / SegmentSize;
+	if (!NavModifierComponents.IsValidIndex(Segment) || NavModifierComponents[Segment] == nullptr) return;
+
+	NavModifierComponents[Segment]->SetPostAlive(PostIndex % SegmentSize, false);
+	DirtyNavSegments.Add(Segment);
+
+	// 同一帧内的移除合并为一次更新
+	if (!bNavFlushPending)
+	{
+		bNavFlushPending = true;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AFenceSpline::FlushNavModifiers);
+	}
+}
+
+// 更新有围栏被移除的分段
+void AFenceSpline::FlushNavModifiers()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AFenceSpline::FlushNavModifiers);
+
+	bNavFlushPending = false;
+	for (const int32 Segment : DirtyNavSegments)
+	{
+		if (NavModifierComponents.IsValidIndex(Segment) && NavModifierComponents[Segment] != nullptr)
+		{
+			NavModifierComponents[Segment]->RefreshNavigationModifiers();
+		}
+	}
+	YICHEN_CLOG(Fence, Verbose, "%s 更新 %d 个导航分段", *GetName(), DirtyNavSegments.Num());
+	DirtyNavSegments.Reset();
+}
+
+// 围栏的初始状态
+uint16 AFenceSpline::GetDefaultPostState() const
+{
+	return FencePostState::AliveBit | (bDefaultDisplay ? FencePostState::VisibleBit : 0);
+}
+
+// 获取颜色下标对应的颜色
+FLinearColor AFenceSpline::GetPaletteColor(const uint8 ColorIndex) const
+{
+	return CampColorPalette.IsValidIndex(ColorIndex - 1) ? CampColorPalette[ColorIndex - 1] : CampColor;
+}
+
+// 设置围栏是否显示
+void AFenceSpline::SetFencePostVisible(const int32 PostIndex, const bool bVisible)
+{
+	const uint16 State = PostStates.GetState(PostIndex);
+	SetPostState(PostIndex, bVisible ? State | FencePostState::VisibleBit : State & ~FencePostState::VisibleBit);
+}
+
+// 设置围栏的颜色
+void AFenceSpline::SetFencePostColorIndex(const int32 PostIndex, const uint8 ColorIndex)
+{
+	SetPostState(PostIndex, FencePostState::WithColorIndex(PostStates.GetState(PostIndex), ColorIndex));
+}
+
+// 围栏被攻击
+void AFenceSpline::NotifyFencePostHit(const int32 PostIndex)
+{
+	const uint16 State = PostStates.GetState(PostIndex);
+	SetPostState(PostIndex, FencePostState::WithHitSequence(State, FencePostState::GetHitSequence(State) + 1));
+}
+
+// 移除围栏
+void AFenceSpline::SetFencePostRemoved(const int32 PostIndex)
+{
+	SetPostState(PostIndex, PostStates.GetState(PostIndex) & ~FencePostState::AliveBit);
+}
+
+// 修改围栏的状态
+void AFenceSpline::SetPostState(const int32 PostIndex, const uint16 NewState)
+{
+	if (!HasAuthority()) return;
+
+	// 被移除的围栏不再变化
+	const uint16 OldState = PostStates.GetState(PostIndex);
+	if (!(OldState & FencePostState::AliveBit) || !PostStates.SetState(PostIndex, NewState)) return;
+
+	if (AppliedPostStates.IsValidIndex(PostIndex))
+	{
+		AppliedPostStates[PostIndex] = NewState;
+		ApplyPostState(PostIndex, OldState, NewState);
+	}
+}
+
+// 应用一组复制的状态
+void AFenceSpline::ApplyPostStateChunk(const FFencePostStateChunk& Chunk)
+{
+	const int32 First = Chunk.ChunkIndex * FFencePostStateChunk::PostNum;
+	for (int32 i = 0; i < FFencePostStateChunk::PostNum && AppliedPostStates.IsValidIndex(First + i); ++i)
+	{
+		const uint16 OldState = AppliedPostStates[First + i];
+		if (OldState != Chunk.States[i])
+		{
+			AppliedPostStates[First + i] = Chunk.States[i];
+			ApplyPostState(First + i, OldState, Chunk.States[i]);
+		}
+	}
+}
+
+// 围栏生成后应用已经收到的状态
+void AFenceSpline::ApplyReplicatedPostStates()
+{
+	AppliedPostStates.Init(GetDefaultPostState(), BakedLayout.Num());
+	for (const FFencePostStateChunk& Chunk : PostStates.Chunks)
+	{
+		ApplyPostStateChunk(Chunk);
+	}
+}
+
+// 把复制的状态应用到围栏上
+void AFenceSpline::ApplyPostState(const int32 PostIndex, const uint16 OldState, const uint16 NewState)
+{
+	ASingleFence_Base* Post = PostsByIndex.IsValidIndex(PostIndex) ? PostsByIndex[PostIndex].Get() : nullptr;
+	if (Post == nullptr || Post->IsActorBeingDestroyed()) return;
+
+	if (!(NewState & FencePostState::AliveBit))
+	{
+		IFenceInterface::Execute_RemoveFence(Post);
+		return;
+	}
+
+	const uint16 Changed = OldState ^ NewState;
+	if (Changed & FencePostState::VisibleBit)
+	{
+		if (NewState & FencePostState::VisibleBit)
+		{
+			IFenceInterface::Execute_ShowFence(Post);
+		}
+		else
+		{
+			Post->SetActorHiddenInGame(true);
+		}
+	}
+	if (FencePostState::GetColorIndex(Changed) != 0)
+	{
+		IFenceInterface::Execute_ChangeFenceColor(Post, GetPaletteColor(FencePostState::GetColorIndex(NewState)));
+	}
+	if (FencePostState::GetHitSequence(Changed) != 0)
+	{
+		IFenceInterface::Execute_FenceHit(Post, true, HitShakeAngle);
+	}
 }
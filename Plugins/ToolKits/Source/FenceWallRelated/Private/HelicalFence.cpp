@@ -4,12 +4,21 @@
 #include "HelicalFence.h"
 
 #include "FenceSpline.h"
+#include "FenceGenerationSubsystem.h"
+#include "FenceInstanceSync.h"
 #include "SingleFence_Base.h"
+#include "ToolKitsStats.h"
 #include "YCTArray.h"
+#include "Algo/BinarySearch.h"
 #include "Components/BoxComponent.h"
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Components/SplineComponent.h"
 
+namespace HelicalFencePose
+{
+	// 相邻两个螺旋线点之间的采样数量，每段转过的角度相同，内圈和外圈的朝向精度一致
+	constexpr int32 SamplesPerPoint = 4;
+}
 
 AHelicalFence::AHelicalFence():
 	Around(true)
@@ -58,6 +67,17 @@ float AHelicalFence::GetCentreDistance() const
 void AHelicalFence::BeginPlay()
 {
 	Super::BeginPlay();
+	// 进度表不保存，关卡里放置的螺旋线加载后不会重新构造
+	if (SplinePoseTable.IsEmpty())
+	{
+		BuildSplinePoseTable();
+	}
+	// 由调度统一安排生成顺序和每帧的耗时
+	if (UFenceGenerationSubsystem* GenerationSubsystem = GetWorld()->GetSubsystem<UFenceGenerationSubsystem>())
+	{
+		GenerationSubsystem->RequestGeneration(this);
+		return;
+	}
 	GeneratingFences();
 }
 
@@ -96,22 +116,26 @@ void AHelicalFence::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	SetSplineLocation();
+
+	// 围栏样条线的围栏可能晚于本Actor生成（例如等待贴合地面或分帧生成）
+	if (FenceSpline && AllSingleFences.IsEmpty() && !SpiralSlots.IsEmpty())
+	{
+		LinkFenceSplinePosts();
+	}
+
 	if (bStart)
 	{
 		FenceHidden();
 	}
 	else
 	{
-		if (!AllSingleFences.IsEmpty())
+		// 只处理螺旋线当前拥有的围栏，城墙上的围栏由围栏样条线管理
+		for (int32 i = 0; i < AllSingleFences.Num(); ++i)
 		{
-			for (auto& SingleFences : AllSingleFences)
-			{
-				if (!SingleFences->IsValidLowLevel()) continue;
-				if (SingleFences)
-				{
-					SingleFences->SetActorHiddenInGame(IsHidden()); // 隐藏
-				}
-			}
+			ASingleFence_Base* SingleFences = AllSingleFences[i];
+			if (!IsValid(SingleFences)) continue;
+			if (FenceSpline && (!PostAlphas.IsValidIndex(i) || PostAlphas[i] >= 1.f)) continue;
+			SingleFences->SetActorHiddenInGame(IsHidden()); // 隐藏
 		}
 	}
 }
@@ -182,7 +206,7 @@ TArray<FTransform> AHelicalFence::GetTempTransforms()
 			// 添加到数组
 			TempTransforms.Add(ATransforms);
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::AnyThread);
+	}, GET_STATID(STAT_ToolKits_FenceTransformsTask), nullptr, ENamedThreads::Type::AnyThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(TransformsTask);
 
@@ -190,68 +214,107 @@ TArray<FTransform> AHelicalFence::GetTempTransforms()
 	return TempTransforms;
 }
 
-// 设置样条线位置
-void AHelicalFence::SetSplineLocation()
+// 计算进度对应的样条线位置
+FVector2D AHelicalFence::ComputeSplinePose(const float InProgress) const
 {
-	float NewTime = 1 + Progress * (0 - 1);
+	float NewTime = 1 + InProgress * (0 - 1);
 	FVector NewTimeLocation = Spline->GetLocationAtTime(NewTime, ESplineCoordinateSpace::Local, true);
 	float NewLocationX = FMath::Sqrt(FMath::Square(NewTimeLocation.X) + FMath::Square(NewTimeLocation.Y)) * GeAround();
 	float NewRotationYay = (180.0) / UE_DOUBLE_PI * FMath::Atan2(NewTimeLocation.Y, NewTimeLocation.X) * -1.f + (Around ? 180.f : 0.f);
-	Spline->SetRelativeLocationAndRotation(FVector(NewLocationX, 0.f, 0.f), FRotator(0.f, NewRotationYay, 0.f));
+	return FVector2D(NewLocationX, NewRotationYay);
 }
 
-// 添加显示模型
-void AHelicalFence::AddDisplayModel()
+// 构建进度表
+void AHelicalFence::BuildSplinePoseTable()
 {
-	// 清空实例数组
-	if (!InstancedStaticMeshComponents.IsEmpty())
+	TRACE_CPUPROFILER_EVENT_SCOPE(AHelicalFence::BuildSplinePoseTable);
+
+	// 螺旋线变化后需要重新应用
+	AppliedPoseProgress = -1.f;
+	SplinePoseTable.Reset();
+	const float SplineLength = Spline->GetSplineLength();
+	const int32 SegmentNum = Spline->GetNumberOfSplineSegments();
+	if (SplineLength <= 0.f || SegmentNum <= 0) return;
+
+	// 按螺旋线的点采样，而不是按距离均匀采样，内圈很短的几段也有足够的采样
+	// 进度 0 对应样条线末端，从末端向起点采样，进度递增
+	const int32 SampleNum = SegmentNum * HelicalFencePose::SamplesPerPoint + 1;
+	SplinePoseTable.SetNumUninitialized(SampleNum);
+	for (int32 i = 0; i < SampleNum; ++i)
 	{
-		for (auto& StaticMeshComponent : InstancedStaticMeshComponents)
+		const float InputKey = static_cast<float>(SampleNum - 1 - i) / HelicalFencePose::SamplesPerPoint;
+		const float SampleProgress = 1.f - Spline->GetDistanceAlongSplineAtSplineInputKey(InputKey) / SplineLength;
+		FVector2D Pose = ComputeSplinePose(SampleProgress);
+		// 朝向与上一个采样连续，插值时不会绕一整圈
+		if (i > 0)
 		{
-			// 添加空指针检查,清除实例并清空数组
-			if (StaticMeshComponent != nullptr)
-			{
-				// 清除实例
-				StaticMeshComponent->ClearInstances();
-				if (StaticMeshComponent->IsRegistered()) // 检查是否已注册
-				{
-					StaticMeshComponent->UnregisterComponent(); // 卸载组件
-				}
-				StaticMeshComponent->DestroyComponent();
-			}
+			const double PrevYaw = SplinePoseTable[i - 1].Z;
+			Pose.Y = PrevYaw + FMath::UnwindDegrees(Pose.Y - PrevYaw);
 		}
-		InstancedStaticMeshComponents.Empty();
+		SplinePoseTable[i] = FVector(SampleProgress, Pose.X, Pose.Y);
+	}
+}
+
+// 设置样条线位置
+void AHelicalFence::SetSplineLocation()
+{
+	// 进度没有变化时不需要移动样条线
+	if (Progress == AppliedPoseProgress) return;
+	AppliedPoseProgress = Progress;
+
+	// 从进度表插值，没有进度表时直接计算
+	FVector2D Pose;
+	if (SplinePoseTable.Num() >= 2)
+	{
+		// 采样不均匀，按进度二分查找所在的区间
+		const double ClampedProgress = FMath::Clamp(Progress, 0.f, 1.f);
+		const int32 Upper = Algo::UpperBoundBy(SplinePoseTable, ClampedProgress, [](const FVector& Sample) { return Sample.X; });
+		const int32 Index = FMath::Clamp(Upper - 1, 0, SplinePoseTable.Num() - 2);
+		const FVector& A = SplinePoseTable[Index];
+		const FVector& B = SplinePoseTable[Index + 1];
+		const double Alpha = B.X > A.X ? FMath::Clamp((ClampedProgress - A.X) / (B.X - A.X), 0.0, 1.0) : 0.0;
+		Pose = FMath::Lerp(FVector2D(A.Y, A.Z), FVector2D(B.Y, B.Z), Alpha);
+	}
+	else
+	{
+		Pose = ComputeSplinePose(Progress);
 	}
+	Spline->SetRelativeLocationAndRotation(FVector(Pose.X, 0.f, 0.f), FRotator(0.f, Pose.Y, 0.f));
+}
 
-	// 如果显示模型数组为空或显示数量小于等于0，则直接返回
-	if (DisplayModels.IsEmpty() || DisplayNum <= 0 || Spline == nullptr) return;
+// 添加显示模型
+void AHelicalFence::AddDisplayModel()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AHelicalFence::AddDisplayModel);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_AddDisplayModel);
+
+	// 如果显示模型数组为空或显示数量小于等于0，则移除所有组件后直接返回
+	if (DisplayModels.IsEmpty() || DisplayNum <= 0 || Spline == nullptr)
+	{
+		FenceInstanceSync::SyncComponents(this, InstancedStaticMeshComponents, {}, [](UHierarchicalInstancedStaticMeshComponent*, UStaticMesh*) {});
+		return;
+	}
 
 	// 模型数量
 	int32 ModelNum = DisplayModels.Num();
 
-	// 预分配实例数组
-	InstancedStaticMeshComponents.Reserve(ModelNum);
-
-	// 创建一个异步任务，处理实例静态网格组件
-	FGraphEventRef ComponentTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,ModelNum]()
+	// 创建一个异步任务，同步实例静态网格组件，上次构造时创建的组件会被复用
+	FGraphEventRef ComponentTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
 	{
-		// 遍历显示模型数组，为每个模型创建一个层级实例静态网格组件
-		for (int32 i = 0; i < ModelNum; i++)
+		FenceInstanceSync::SyncComponents(this, InstancedStaticMeshComponents, DisplayModels, [this](UHierarchicalInstancedStaticMeshComponent* Component, UStaticMesh* Model)
+		{
+			InitializeComponent(Component, Model);
+		});
+
+		// 复用的组件也需要更新阵营颜色
+		for (UHierarchicalInstancedStaticMeshComponent* Component : InstancedStaticMeshComponents)
 		{
-			// 确保模型指针不为空
-			if (DisplayModels[i] != nullptr)
+			if (Component != nullptr)
 			{
-				FString ComponentName = FString::Printf(TEXT("HISMComponent_%d"), i);
-				// 创建层级实例静态网格组件
-				UHierarchicalInstancedStaticMeshComponent* HISMComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, UHierarchicalInstancedStaticMeshComponent::StaticClass(), *ComponentName);
-				if (HISMComponent)
-				{
-					InitializeComponent(HISMComponent, DisplayModels[i]);
-					InstancedStaticMeshComponents.Add(HISMComponent);
-				}
+				Component->SetVectorParameterValueOnMaterials("CampColor", FVector(CampColor.R, CampColor.G, CampColor.B));
 			}
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
+	}, GET_STATID(STAT_ToolKits_FenceComponentsTask), nullptr, ENamedThreads::Type::GameThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(ComponentTask);
 
@@ -282,7 +345,10 @@ void AHelicalFence::AddDisplayModel()
 			Spline->SetSplinePoints(Points, ESplineCoordinateSpace::Local, true);
 			Index++;
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::AnyThread);
+
+		// 螺旋线确定后采样进度表，运行时只需要查表
+		BuildSplinePoseTable();
+	}, GET_STATID(STAT_ToolKits_HelicalSplineTask), nullptr, ENamedThreads::Type::AnyThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(SplineTask);
 
@@ -290,7 +356,7 @@ void AHelicalFence::AddDisplayModel()
 	FGraphEventRef SolineSetPoint = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
 	{
 		SetSplineLocation();
-	}, TStatId(), nullptr, ENamedThreads::Type::AnyThread);
+	}, GET_STATID(STAT_ToolKits_HelicalSplineTask), nullptr, ENamedThreads::Type::AnyThread);
 	// 等待任务完成
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(SolineSetPoint);
 
@@ -300,72 +366,95 @@ void AHelicalFence::AddDisplayModel()
 		// 获取临时变换数组
 		TArray<FTransform> TempFTransforms = GetTempTransforms();
 
-		// 临时变量，用于记录当前实例化的模型编号
-		int TempNum = 0;
-		// 遍历临时变换数组，为每个变换添加实例
-		for (auto& StaticMeshTransform : TempFTransforms)
+		// 按模型分组，组件与模型一一对应
+		TArray<TArray<FTransform>> GroupedTransforms;
+		GroupedTransforms.SetNum(InstancedStaticMeshComponents.Num());
+		for (int32 i = 0; i < TempFTransforms.Num(); ++i)
 		{
-			// 确保数组索引有效
-			if (InstancedStaticMeshComponents.IsValidIndex(TempNum % ModelNum))
+			if (GroupedTransforms.IsValidIndex(i % ModelNum))
 			{
-				InstancedStaticMeshComponents[TempNum % ModelNum]->AddInstance(StaticMeshTransform, true);
-				TempNum++;
+				GroupedTransforms[i % ModelNum].Add(TempFTransforms[i]);
 			}
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
+
+		// 与已有实例对比，只提交变化的部分
+		for (int32 i = 0; i < InstancedStaticMeshComponents.Num(); ++i)
+		{
+			FenceInstanceSync::SyncInstances(InstancedStaticMeshComponents[i], GroupedTransforms[i]);
+		}
+	}, GET_STATID(STAT_ToolKits_FenceInstancesTask), nullptr, ENamedThreads::Type::GameThread);
 	FTaskGraphInterface::Get().WaitUntilTaskCompletes(AddMeshTask);
 }
 
 // 生成围栏
 void AHelicalFence::GeneratingFences()
 {
-	if (DisplayModels.IsEmpty() || SingleFenceClass == nullptr) return;
+	TRACE_CPUPROFILER_EVENT_SCOPE(AHelicalFence::GeneratingFences);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_GeneratingFences);
+
+	if (DisplayModels.IsEmpty() || (FenceSpline == nullptr && SingleFenceClass == nullptr)) return;
 	TArray<FTransform> TempTransforms = GetTempTransforms();
 	UWorld* World = GetWorld();
 	if (TempTransforms.IsEmpty() || World == nullptr) return;
 
-	// 创建一个异步任务，用于生成围栏对象
-	FGraphEventRef SpawnTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,World,&TempTransforms]()
+	if (FenceSpline)
 	{
-		// 模型数量
-		int32 ModelNum = DisplayModels.Num();
-		int index = 0;
-		FActorSpawnParameters SpawnParameters;
-		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-		// 遍历临时变换数组，用于在特定位置生成单个围栏对象
-		for (auto& SpawnTransform : TempTransforms)
+		// 与围栏样条线共用围栏，只记录螺旋线上的位置，围栏顺序与反转后的数组一致
+		const FTransform& SplineTransform = Spline->GetComponentTransform();
+		SpiralSlots.Reset(TempTransforms.Num());
+		for (int32 i = TempTransforms.Num() - 1; i >= 0; --i)
 		{
-			// 在指定的位置和参数下生成单个围栏对象
-			if (ASingleFence_Base* SingleFence_Base = World->SpawnActor<ASingleFence_Base>(SingleFenceClass, SpawnTransform, SpawnParameters))
+			SpiralSlots.Add(TempTransforms[i].GetRelativeTransform(SplineTransform));
+		}
+		LinkFenceSplinePosts();
+	}
+	else
+	{
+		// 创建一个异步任务，用于生成围栏对象
+		FGraphEventRef SpawnTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,World,&TempTransforms]()
+		{
+			// 模型数量
+			int32 ModelNum = DisplayModels.Num();
+			int index = 0;
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			// 遍历临时变换数组，用于在特定位置生成单个围栏对象
+			for (auto& SpawnTransform : TempTransforms)
 			{
-				// 将生成的围栏对象附加到当前对象上，保持其在世界中的变换
-				SingleFence_Base->AttachToComponent(Spline, FAttachmentTransformRules::KeepWorldTransform);
+				// 在指定的位置和参数下生成单个围栏对象
+				if (ASingleFence_Base* SingleFence_Base = World->SpawnActor<ASingleFence_Base>(SingleFenceClass, SpawnTransform, SpawnParameters))
+				{
+					INC_DWORD_STAT(STAT_ToolKits_FencePostsSpawned);
+
+					// 将生成的围栏对象附加到当前对象上，保持其在世界中的变换
+					SingleFence_Base->AttachToComponent(Spline, FAttachmentTransformRules::KeepWorldTransform);
 
-				// 设置围栏对象的显示模型，根据索引选择合适的模型
-				SingleFence_Base->SetFenceMesh(DisplayModels[index % ModelNum]);
+					// 设置围栏对象的显示模型，根据索引选择合适的模型
+					SingleFence_Base->SetFenceMesh(DisplayModels[index % ModelNum]);
 
-				// 设置围栏对象的阵营颜色，使其与当前对象一致
-				SingleFence_Base->SetCampColor(CampColor);
+					// 设置围栏对象的阵营颜色，使其与当前对象一致
+					SingleFence_Base->SetCampColor(CampColor);
 
-				// 初始化围栏对象的基础属性
-				SingleFence_Base->InitBase();
-				// 设置围栏对象的碰撞启用状态，使其无法被碰撞检测
-				SingleFence_Base->GetBox()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+					// 初始化围栏对象的基础属性
+					SingleFence_Base->InitBase();
+					// 设置围栏对象的碰撞启用状态，使其无法被碰撞检测
+					SingleFence_Base->GetBox()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 				
-				// 将围栏对象添加到列表中，便于后续管理
-				AllSingleFences.AddUnique(SingleFence_Base);
+					// 将围栏对象添加到列表中，便于后续管理
+					AllSingleFences.AddUnique(SingleFence_Base);
 
-				// 增加索引，用于选择下一个模型或颜色等
-				index++;
+					// 增加索引，用于选择下一个模型或颜色等
+					index++;
+				}
 			}
-		}
-	}, TStatId(), nullptr, ENamedThreads::Type::GameThread);
-	// 等待任务完成
-	FTaskGraphInterface::Get().WaitUntilTaskCompletes(SpawnTask);
+		}, GET_STATID(STAT_ToolKits_FenceSpawnTask), nullptr, ENamedThreads::Type::GameThread);
+		// 等待任务完成
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(SpawnTask);
 
-	// 反转数组
-	ReverseTArray(AllSingleFences);
+		// 反转数组
+		ReverseTArray(AllSingleFences);
+	}
 
 	// 如果实例静态网格组件数组不为空，则清除所有实例并清空数组
 	if (!InstancedStaticMeshComponents.IsEmpty())
@@ -380,41 +469,106 @@ void AHelicalFence::GeneratingFences()
 	}
 }
 
-// 隐藏围栏
-void AHelicalFence::FenceHidden()
+// 借用围栏样条线的围栏
+void AHelicalFence::LinkFenceSplinePosts()
 {
-	if (!FenceSpline) return;
-	if (FenceSpline->AllSingleFences.IsEmpty()) return;
+	// 围栏样条线分帧生成时，等全部生成后再借用
+	if (FenceSpline == nullptr || FenceSpline->AllSingleFences.IsEmpty() || FenceSpline->IsRealizingFences() || SpiralSlots.IsEmpty()) return;
+
+	const int32 Count = FMath::Min(SpiralSlots.Num(), FenceSpline->AllSingleFences.Num());
+	AllSingleFences.Reset(Count);
+	WallSlots.Reset(Count);
+	RevealDistances.Reset(Count);
+	PostAlphas.Init(1.f, Count);
+	WallHidden.Init(false, Count);
+	RevealLength = Spline->GetSplineLength();
+
+	float Distance = 0.f;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		ASingleFence_Base* Post = FenceSpline->AllSingleFences[i];
+		AllSingleFences.Add(Post);
+		WallSlots.Add(IsValid(Post) ? Post->GetActorTransform() : FTransform::Identity);
+
+		// 按围栏长度累计，与原来的显示隐藏判断一致
+		const float Length = IsValid(Post) && Post->GetFenceMesh() ? Post->GetFenceMesh()->GetBounds().BoxExtent.X * 2.f * Size : 0.f;
+		Distance += Interval + Length;
+		RevealDistances.Add(Distance);
+	}
+}
+
+// 按展开程度更新借用的围栏
+void AHelicalFence::UpdateSharedPost(const int32 Index, const float Alpha)
+{
+	ASingleFence_Base* Post = AllSingleFences[Index];
+	if (!IsValid(Post)) return;
 
-	// 创建一个异步任务，用于隐藏围栏对象
-	FGraphEventRef HiddenTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
+	const float OldAlpha = PostAlphas[Index];
+	const bool bSettled = Alpha <= 0.f || Alpha >= 1.f;
+	if (bSettled && Alpha == OldAlpha) return;
+	PostAlphas[Index] = Alpha;
+
+	// 离开城墙时记录显示状态，在螺旋线上跟随本Actor显示，回到城墙上时恢复
+	if (OldAlpha >= 1.f)
 	{
-		float Distance = 0.f;
-		int32 Index = 0;
+		WallHidden[Index] = Post->IsHidden();
+	}
+	Post->SetActorHiddenInGame(Alpha >= 1.f ? WallHidden[Index] : IsHidden());
+	// 只有停在城墙上时才参与碰撞
+	Post->SetActorEnableCollision(Alpha >= 1.f);
 
-		for (auto& SingleFences : AllSingleFences)
+	if (Alpha <= 0.f)
+	{
+		if (Post->GetRootComponent()->GetAttachParent() != Spline)
 		{
-			if (!SingleFences->IsValidLowLevel())
-			{
-				Index++;
-				continue;
-			}
-			if (SingleFences && SingleFences->GetFenceMesh())
-			{
-				// 计算当前围栏对象与下一个围栏对象之间的距离
-				float CurrentDistance = Interval + Distance + SingleFences->GetFenceMesh()->GetBounds().BoxExtent.X * 2.f * Size;
-				bool Hidden = CurrentDistance > (Spline->GetSplineLength() * (1.f - Progress));
-				SingleFences->SetActorHiddenInGame(Hidden);
-				if (FenceSpline->AllSingleFences[Index])
-				{
-					FenceSpline->AllSingleFences[Index]->SetActorHiddenInGame(!Hidden);
-				}
+			Post->AttachToComponent(Spline, FAttachmentTransformRules::KeepWorldTransform);
+		}
+		Post->SetActorRelativeTransform(SpiralSlots[Index]);
+	}
+	else if (Alpha >= 1.f)
+	{
+		if (Post->GetRootComponent()->GetAttachParent() != FenceSpline->Spline)
+		{
+			Post->AttachToComponent(FenceSpline->Spline, FAttachmentTransformRules::KeepWorldTransform);
+		}
+		Post->SetActorTransform(WallSlots[Index]);
+	}
+	else
+	{
+		// 螺旋线每帧都在移动，过渡中的围栏每帧插值一次
+		FTransform Blended;
+		Blended.Blend(SpiralSlots[Index] * Spline->GetComponentTransform(), WallSlots[Index], Alpha);
+		Post->SetActorTransform(Blended);
+	}
+}
 
-				Distance = CurrentDistance;
-				Index++;
-			}
+// 隐藏围栏
+void AHelicalFence::FenceHidden()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AHelicalFence::FenceHidden);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FenceHidden);
+
+	if (!FenceSpline || AllSingleFences.IsEmpty()) return;
+
+	// 创建一个异步任务，计算每个围栏的展开程度
+	TArray<float> Alphas;
+	FGraphEventRef AlphaTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this,&Alphas]()
+	{
+		// 超过阈值的围栏已经离开螺旋线，与原来隐藏螺旋线上围栏的判断一致
+		const float Threshold = RevealLength * (1.f - Progress);
+		Alphas.SetNumUninitialized(RevealDistances.Num());
+		for (int32 i = 0; i < RevealDistances.Num(); ++i)
+		{
+			const float Over = RevealDistances[i] - Threshold;
+			Alphas[i] = UnrollBlendDistance > 0.f ? FMath::Clamp(Over / UnrollBlendDistance, 0.f, 1.f) : (Over > 0.f ? 1.f : 0.f);
 		}
-	}, TStatId(), nullptr, ENamedThreads::Type::AnyThread);
+	}, GET_STATID(STAT_ToolKits_FenceHiddenTask), nullptr, ENamedThreads::Type::AnyThread);
 	// 等待任务完成
-	FTaskGraphInterface::Get().WaitUntilTaskCompletes(HiddenTask);
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(AlphaTask);
+
+	// 在游戏线程上移动围栏，每个正在移动的围栏只更新一次变换
+	for (int32 i = 0; i < Alphas.Num(); ++i)
+	{
+		UpdateSharedPost(i, Alphas[i]);
+	}
 }
@@ -2,12 +2,14 @@
 
 
 #include "SingleFence_Base.h"
+#include "FenceAnimationData.h"
+#include "ToolKitsStats.h"
 #include "Components/TimelineComponent.h"
 #include "Components/BoxComponent.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 
-ASingleFence_Base::ASingleFence_Base(): bSetGreenFilm(true)
+ASingleFence_Base::ASingleFence_Base(): bSetGreenFilm(true), bUseGPUAnimation(false)
 {
 	// 设置此actor的tick 为false 
 	PrimaryActorTick.bStartWithTickEnabled = false;
@@ -32,6 +34,13 @@ ASingleFence_Base::ASingleFence_Base(): bSetGreenFilm(true)
 	HitTimeComponent = CreateDefaultSubobject<UTimelineComponent>(TEXT("HitTimeComponent"));
 }
 
+// 设置围栏是否修改导航
+void ASingleFence_Base::SetAffectNavigation(const bool bAffect)
+{
+	Box->SetCanEverAffectNavigation(bAffect);
+	FenceMeshComponent->SetCanEverAffectNavigation(bAffect);
+}
+
 void ASingleFence_Base::BeginPlay()
 {
 	Super::BeginPlay();
@@ -39,6 +48,41 @@ void ASingleFence_Base::BeginPlay()
 	InitBind();
 	StartSize = FenceMeshComponent->GetComponentScale();
 	DefaultMaterials = FenceMeshComponent->GetMaterials();
+
+	// 材质在动画播放前也会读取曲线的最后一个采样，需要先写入
+	WriteAnimationCurves();
+}
+
+// 写入 GPU 动画的曲线采样
+void ASingleFence_Base::WriteAnimationCurves()
+{
+	if (!bUseGPUAnimation || FenceMeshComponent == nullptr) return;
+
+	// 没有曲线时与时间轴不播放时一致
+	float Samples[FenceAnimationData::CurveSamples * 2];
+	FenceAnimationData::SampleCurve(ScaleCurve, [](float) { return 1.f; }, MakeArrayView(Samples, FenceAnimationData::CurveSamples));
+	FenceAnimationData::SampleCurve(HitCurve, [](float) { return 0.f; }, MakeArrayView(Samples + FenceAnimationData::CurveSamples, FenceAnimationData::CurveSamples));
+
+	// 两条曲线的采样是连续的
+	static_assert(FenceAnimationData::HitCurve == FenceAnimationData::ScaleCurve + FenceAnimationData::CurveSamples);
+	for (int32 i = 0; i < UE_ARRAY_COUNT(Samples); i += 4)
+	{
+		FenceMeshComponent->SetCustomPrimitiveDataVector4(FenceAnimationData::ScaleCurve + i, FVector4(Samples[i], Samples[i + 1], Samples[i + 2], Samples[i + 3]));
+	}
+}
+
+// 结束时移除仍在播放的动画计数
+void ASingleFence_Base::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ScaleTimeComponent && ScaleTimeComponent->IsPlaying())
+	{
+		DEC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
+	}
+	if (HitTimeComponent && HitTimeComponent->IsPlaying())
+	{
+		DEC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
 // 构造函数
@@ -176,10 +220,21 @@ void ASingleFence_Base::GreenFilmFinish()
 // 播放缩放动画
 void ASingleFence_Base::ScalePlay()
 {
+	// GPU 动画只记录开始时间和持续时间，由材质计算缩放
+	if (bUseGPUAnimation)
+	{
+		FenceMeshComponent->SetCustomPrimitiveDataVector2(FenceAnimationData::ScaleStartTime, FVector2D(GetWorld()->GetTimeSeconds(), ScaleTime));
+		return;
+	}
+
 	if (ScaleTimeComponent)
 	{
 		ScaleTimeComponent->SetTimelineLength(1.f);
 		ScaleTimeComponent->SetPlayRate(1.f / ScaleTime);
+		if (!ScaleTimeComponent->IsPlaying())
+		{
+			INC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
+		}
 		ScaleTimeComponent->PlayFromStart();
 	}
 }
@@ -193,15 +248,32 @@ void ASingleFence_Base::UpdateScaleTimeComponent(const float Output)
 // 缩放动画结束
 void ASingleFence_Base::OnScaleFinish()
 {
+	DEC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
 }
 
 // 播放命中动画
 void ASingleFence_Base::HitPlayer()
 {
+	// GPU 动画只记录开始时间、持续时间和角度，由材质计算抖动，结束时只需要清除命中状态
+	if (bUseGPUAnimation)
+	{
+		const float Angle = bCanShake ? FMath::DegreesToRadians(ShakeAngle) : 0.f;
+		FenceMeshComponent->SetCustomPrimitiveDataVector3(FenceAnimationData::HitStartTime, FVector(GetWorld()->GetTimeSeconds(), HitTime, Angle));
+		GetWorld()->GetTimerManager().SetTimer(HitTimerHandle, FTimerDelegate::CreateWeakLambda(this, [this]()
+		{
+			bInHit = false;
+		}), HitTime, false);
+		return;
+	}
+
 	if (HitTimeComponent)
 	{
 		HitTimeComponent->SetTimelineLength(1.f);
 		HitTimeComponent->SetPlayRate(1.f / HitTime);
+		if (!HitTimeComponent->IsPlaying())
+		{
+			INC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
+		}
 		HitTimeComponent->PlayFromStart();
 	}
 }
@@ -220,4 +292,5 @@ void ASingleFence_Base::UpdateHitTimeComponent(const float Output)
 void ASingleFence_Base::OnHitFinish()
 {
 	bInHit = false;
+	DEC_DWORD_STAT(STAT_ToolKits_FenceAnimationsActive);
 }
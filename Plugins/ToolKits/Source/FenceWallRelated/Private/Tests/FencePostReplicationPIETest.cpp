@@ -0,0 +1,190 @@
+#include "FenceGenerationSubsystem.h"
+#include "FenceSpline.h"
+#include "SingleFence_Base.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "Components/SplineComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/PlayerController.h"
+#include "Settings/LevelEditorPlaySettings.h"
+
+namespace FencePostReplicationPIETest
+{
+	constexpr int32 PostCount = 2000;
+	constexpr int32 GapFirst = PostCount / 3;
+	constexpr int32 GapNum = PostCount / 10;
+	constexpr double TimeoutSeconds = 60.0;
+
+	// 连续 200 个围栏所在的 14 组，每组约 30 字节，加上数据包头和后台流量的余量
+	constexpr int32 MaxGapBytes = 2048;
+
+	// 测试过程中共享的状态
+	struct FState
+	{
+		TWeakObjectPtr<AFenceSpline> EditorFence;
+		TWeakObjectPtr<AFenceSpline> ServerFence;
+		TWeakObjectPtr<AFenceSpline> ClientFence;
+		TWeakObjectPtr<UNetConnection> Connection;
+		double StartTime = 0.0;
+		int32 StartBytes = 0;
+	};
+
+	// 世界中的围栏样条线是否已经生成完所有围栏
+	AFenceSpline* FindGeneratedFence(UWorld* World)
+	{
+		const UFenceGenerationSubsystem* GenerationSubsystem = World->GetSubsystem<UFenceGenerationSubsystem>();
+		if (GenerationSubsystem && GenerationSubsystem->IsGenerating()) return nullptr;
+
+		for (TActorIterator<AFenceSpline> It(World); It; ++It)
+		{
+			if (It->AllSingleFences.Num() == PostCount) return *It;
+		}
+		return nullptr;
+	}
+
+	// 还存在的围栏数量
+	int32 CountAlivePosts(const AFenceSpline* Fence)
+	{
+		int32 Count = 0;
+		for (const ASingleFence_Base* Post : Fence->AllSingleFences)
+		{
+			Count += IsValid(Post) ? 1 : 0;
+		}
+		return Count;
+	}
+
+	// 是否超时
+	bool IsTimedOut(const FState& State)
+	{
+		return FPlatformTime::Seconds() - State.StartTime > TimeoutSeconds;
+	}
+}
+
+/**
+ * 关卡里放一条 2000 个围栏、开启复制的围栏样条线，以监听服务器 + 1 个客户端运行PIE，
+ * 服务器移除连续 10% 的围栏，状态经过 FastArrayDeltaSerialize 和 PostReplicatedChange 应用到客户端的围栏上，
+ * 统计这次更新服务器发往客户端的字节数
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFencePostReplicationPIETest, "ToolKits.Fence.ReplicationPIE",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFencePostReplicationPIETest::RunTest(const FString& Parameters)
+{
+	using namespace FencePostReplicationPIETest;
+
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	UWorld* EditorWorld = GEditor->GetEditorWorldContext().World();
+	if (!TestNotNull(TEXT("立方体模型"), Cube) || !TestNotNull(TEXT("编辑器世界"), EditorWorld)) return false;
+
+	// 放在关卡里的围栏样条线，服务器和客户端按同一份烘焙的布局生成围栏
+	AFenceSpline* Fence = EditorWorld->SpawnActorDeferred<AFenceSpline>(AFenceSpline::StaticClass(), FTransform::Identity);
+	Fence->SingleFenceClass = ASingleFence_Base::StaticClass();
+	Fence->DisplayModels = {Cube};
+	Fence->DisplayNum = PostCount;
+	Fence->bAffectNavigation = false;
+	Fence->bReplicatePostStates = true;
+	Fence->Spline->SetLocationAtSplinePoint(1, FVector(PostCount * (Cube->GetBounds().BoxExtent.X * 2.f + Fence->Interval), 0.f, 0.f), ESplineCoordinateSpace::Local);
+	Fence->FinishSpawning(FTransform::Identity);
+	Fence->BakeLayout();
+
+	const TSharedRef<FState> State = MakeShared<FState>();
+	State->EditorFence = Fence;
+	State->StartTime = FPlatformTime::Seconds();
+
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+	PlaySettings->SetPlayNumberOfClients(2);
+	PlaySettings->SetRunUnderOneProcess(true);
+
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(Params);
+
+	// 等待两端生成完围栏、客户端的围栏样条线收到复制，服务器移除连续的围栏
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State]()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType != EWorldType::PIE || World == nullptr || !World->HasBegunPlay()) continue;
+
+			if (World->GetNetMode() == NM_ListenServer)
+			{
+				State->ServerFence = FindGeneratedFence(World);
+				for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+				{
+					if (It->Get() && It->Get()->GetNetConnection())
+					{
+						State->Connection = It->Get()->GetNetConnection();
+					}
+				}
+			}
+			else if (World->GetNetMode() == NM_Client)
+			{
+				AFenceSpline* ClientFence = FindGeneratedFence(World);
+				State->ClientFence = ClientFence && ClientFence->GetLocalRole() == ROLE_SimulatedProxy ? ClientFence : nullptr;
+			}
+		}
+
+		AFenceSpline* ServerFence = State->ServerFence.Get();
+		if (ServerFence == nullptr || !State->ClientFence.IsValid() || !State->Connection.IsValid())
+		{
+			if (!IsTimedOut(*State)) return false;
+			AddError(TEXT("PIE 没有启动或围栏没有生成"));
+			return true;
+		}
+
+		State->StartBytes = State->Connection->OutTotalBytes;
+		for (int32 i = GapFirst; i < GapFirst + GapNum; ++i)
+		{
+			ServerFence->SetFencePostRemoved(i);
+		}
+		TestEqual(TEXT("服务器移除围栏"), CountAlivePosts(ServerFence), PostCount - GapNum);
+		return true;
+	}));
+
+	// 客户端收到复制后移除同样的围栏，统计发送的字节数
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State]()
+	{
+		const AFenceSpline* ClientFence = State->ClientFence.Get();
+		const UNetConnection* Connection = State->Connection.Get();
+		if (ClientFence == nullptr || Connection == nullptr) return true;
+
+		if (CountAlivePosts(ClientFence) != PostCount - GapNum)
+		{
+			if (!IsTimedOut(*State)) return false;
+			AddError(FString::Printf(TEXT("客户端还有 %d 个围栏，应为 %d"), CountAlivePosts(ClientFence), PostCount - GapNum));
+			return true;
+		}
+
+		const int32 Bytes = Connection->OutTotalBytes - State->StartBytes;
+		TestTrue(FString::Printf(TEXT("移除 %d 个围栏发送 %d 字节，不超过 %d 字节"), GapNum, Bytes, MaxGapBytes), Bytes <= MaxGapBytes);
+		AddInfo(FString::Printf(TEXT("%d 个围栏中连续移除 %d 个：服务器发送 %d 字节（含数据包头）"), PostCount, GapNum, Bytes));
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([State]()
+	{
+		GEditor->RequestEndPlayMap();
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([State]()
+	{
+		if (GEditor->IsPlaySessionInProgress()) return false;
+		if (AFenceSpline* EditorFence = State->EditorFence.Get())
+		{
+			EditorFence->GetWorld()->DestroyActor(EditorFence);
+		}
+		return true;
+	}));
+	return true;
+}
+
+#endif
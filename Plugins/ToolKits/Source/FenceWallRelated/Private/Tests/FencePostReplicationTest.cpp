@@ -0,0 +1,124 @@
+#include "FencePostReplication.h"
+#include "FenceSpline.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FencePostReplicationTest
+{
+	// 把服务器上复制键变化的组写入数据包，返回发送的组数
+	int32 WriteDirtyChunks(const FFencePostStateArray& Server, TArray<int32>& SentKeys, FBitWriter& Writer)
+	{
+		int32 SentNum = 0;
+		for (int32 i = 0; i < Server.Chunks.Num(); ++i)
+		{
+			FFencePostStateChunk Chunk = Server.Chunks[i];
+			if (SentKeys.IsValidIndex(i) && SentKeys[i] == Chunk.ReplicationKey) continue;
+
+			bool bSuccess = false;
+			Chunk.NetSerialize(Writer, nullptr, bSuccess);
+			SentKeys.SetNum(FMath::Max(SentKeys.Num(), i + 1));
+			SentKeys[i] = Chunk.ReplicationKey;
+			++SentNum;
+		}
+		return SentNum;
+	}
+
+	// 客户端按组下标读取数据包
+	bool ReadChunks(FFencePostStateArray& Client, const FBitWriter& Writer, const int32 ChunkNum)
+	{
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		for (int32 i = 0; i < ChunkNum; ++i)
+		{
+			FFencePostStateChunk Chunk;
+			bool bSuccess = false;
+			Chunk.NetSerialize(Reader, nullptr, bSuccess);
+			if (!bSuccess) return false;
+
+			Client.Chunks.SetNum(FMath::Max(Client.Chunks.Num(), Chunk.ChunkIndex + 1));
+			Client.Chunks[Chunk.ChunkIndex] = Chunk;
+		}
+		return !Reader.IsError();
+	}
+}
+
+// 围栏状态的位布局
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFencePostStateBitsTest, "ToolKits.Fence.PostStateBits",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFencePostStateBitsTest::RunTest(const FString& Parameters)
+{
+	const uint16 State = FencePostState::AliveBit | FencePostState::VisibleBit;
+
+	// 命中序号循环递增，不影响其他位
+	const uint16 Hit = FencePostState::WithHitSequence(State, FencePostState::HitMask + 1);
+	TestEqual(TEXT("命中序号循环"), static_cast<int32>(FencePostState::GetHitSequence(Hit)), 0);
+	TestEqual(TEXT("命中序号不影响存在和显示"), static_cast<int32>(Hit & (FencePostState::AliveBit | FencePostState::VisibleBit)), static_cast<int32>(State));
+
+	const uint16 Color = FencePostState::WithColorIndex(FencePostState::WithHitSequence(State, 7), 42);
+	TestEqual(TEXT("颜色下标"), static_cast<int32>(FencePostState::GetColorIndex(Color)), 42);
+	TestEqual(TEXT("颜色下标不影响命中序号"), static_cast<int32>(FencePostState::GetHitSequence(Color)), 7);
+	TestTrue(TEXT("所有位都在复制的位数内"), Color < (1 << FencePostState::NumBits));
+
+	// 默认不复制，由 bReplicatePostStates 开启
+	TestFalse(TEXT("围栏样条线默认不复制"), GetDefault<AFenceSpline>()->GetIsReplicated());
+	return true;
+}
+
+// 服务器修改状态后，只有变化的组发送到客户端，客户端的状态与服务器一致
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFencePostReplicationLoopbackTest, "ToolKits.Fence.ReplicationLoopback",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFencePostReplicationLoopbackTest::RunTest(const FString& Parameters)
+{
+	using namespace FencePostReplicationTest;
+
+	constexpr int32 PostCount = 2000;
+	const uint16 DefaultState = FencePostState::AliveBit | FencePostState::VisibleBit;
+
+	FFencePostStateArray Server;
+	Server.Init(PostCount, DefaultState);
+	TestEqual(TEXT("组数"), Server.Chunks.Num(), FMath::DivideAndRoundUp(PostCount, FFencePostStateChunk::PostNum));
+	TestEqual(TEXT("越界的状态为0"), static_cast<int32>(Server.GetState(PostCount)), 0);
+	TestFalse(TEXT("状态不变时不标记"), Server.SetState(0, DefaultState));
+
+	// 首次同步发送所有组
+	FFencePostStateArray Client;
+	TArray<int32> SentKeys;
+	FBitWriter InitialWriter(0, true);
+	const int32 InitialNum = WriteDirtyChunks(Server, SentKeys, InitialWriter);
+	TestEqual(TEXT("首次同步发送所有组"), InitialNum, Server.Chunks.Num());
+	TestTrue(TEXT("首次同步读取成功"), ReadChunks(Client, InitialWriter, InitialNum));
+
+	// 连续缺口、命中和换色
+	constexpr int32 GapFirst = PostCount / 3;
+	constexpr int32 GapNum = PostCount / 10;
+	for (int32 i = GapFirst; i < GapFirst + GapNum; ++i)
+	{
+		Server.SetState(i, Server.GetState(i) & ~FencePostState::AliveBit);
+	}
+	Server.SetState(5, FencePostState::WithHitSequence(DefaultState, 1));
+	Server.SetState(PostCount - 1, FencePostState::WithColorIndex(DefaultState, 63));
+
+	FBitWriter DeltaWriter(0, true);
+	const int32 DeltaNum = WriteDirtyChunks(Server, SentKeys, DeltaWriter);
+	const int32 GapChunks = (GapFirst + GapNum - 1) / FFencePostStateChunk::PostNum - GapFirst / FFencePostStateChunk::PostNum + 1;
+	TestEqual(TEXT("只发送变化的组"), DeltaNum, GapChunks + 2);
+	TestTrue(TEXT("增量小于完整同步"), DeltaWriter.GetNumBytes() < InitialWriter.GetNumBytes());
+	TestTrue(TEXT("增量读取成功"), ReadChunks(Client, DeltaWriter, DeltaNum));
+
+	bool bMatch = true;
+	for (int32 i = 0; i < PostCount; ++i)
+	{
+		bMatch &= Client.GetState(i) == Server.GetState(i);
+	}
+	TestTrue(TEXT("客户端的状态与服务器一致"), bMatch);
+
+	// 没有所属的围栏样条线时收到的组被忽略
+	Client.Chunks[0].PostReplicatedChange(Client);
+	return true;
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include "YCTArray.h"
+#include "Algo/Sort.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 反转、旋转和稳定分区
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCTArrayReorderTest, "ToolKits.YCTArray.Reorder",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCTArrayReorderTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> Strings = {TEXT("A"), TEXT("B"), TEXT("C"), TEXT("D"), TEXT("E")};
+	ReverseTArray(Strings);
+	TestTrue(TEXT("ReverseTArray"), Strings == TArray<FString>{TEXT("E"), TEXT("D"), TEXT("C"), TEXT("B"), TEXT("A")});
+
+	TArray<int32> Numbers = {0, 1, 2, 3, 4, 5};
+	ReverseTArrayRange(Numbers, 1, 4);
+	TestTrue(TEXT("ReverseTArrayRange"), Numbers == TArray<int32>{0, 3, 2, 1, 4, 5});
+
+	TArray<int32> Empty;
+	ReverseTArray(Empty);
+	RotateTArray(Empty, 3);
+	TestEqual(TEXT("空数组"), Empty.Num(), 0);
+
+	Numbers = {0, 1, 2, 3, 4, 5};
+	RotateTArray(Numbers, 2);
+	TestTrue(TEXT("RotateTArray 向左"), Numbers == TArray<int32>{2, 3, 4, 5, 0, 1});
+	RotateTArray(Numbers, -2);
+	TestTrue(TEXT("RotateTArray 向右"), Numbers == TArray<int32>{0, 1, 2, 3, 4, 5});
+	RotateTArray(Numbers, 6 + 1);
+	TestTrue(TEXT("RotateTArray 超过长度"), Numbers == TArray<int32>{1, 2, 3, 4, 5, 0});
+
+	// 奇数在前，两部分保持原有顺序
+	Numbers = {5, 2, 7, 4, 1, 8, 3};
+	const int32 Split = StablePartitionTArray(Numbers, [](const int32 Value) { return Value % 2 == 1; });
+	TestEqual(TEXT("StablePartitionTArray 分界"), Split, 4);
+	TestTrue(TEXT("StablePartitionTArray 顺序"), Numbers == TArray<int32>{5, 7, 1, 3, 2, 4, 8});
+	return true;
+}
+
+// 基数排序与比较排序的结果一致，按键排序保持稳定
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCTArrayRadixSortTest, "ToolKits.YCTArray.RadixSort",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCTArrayRadixSortTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(36);
+
+	TArray<float> Floats;
+	TArray<int32> Ints;
+	TArray<uint32> Uints;
+	for (int32 i = 0; i < 4096; ++i)
+	{
+		Floats.Add(Random.FRandRange(-1000.f, 1000.f));
+		Ints.Add(Random.RandRange(MIN_int32, MAX_int32));
+		Uints.Add(static_cast<uint32>(Random.GetUnsignedInt()));
+	}
+	Floats.Append({0.f, -0.f, 1e-30f, -1e-30f});
+
+	TArray<float> SortedFloats = Floats;
+	Algo::Sort(SortedFloats);
+	RadixSortTArray(Floats);
+	TestTrue(TEXT("float"), Algo::IsSorted(Floats) && Floats.Num() == SortedFloats.Num());
+
+	TArray<int32> SortedInts = Ints;
+	Algo::Sort(SortedInts);
+	RadixSortTArray(Ints);
+	TestTrue(TEXT("int32"), Ints == SortedInts);
+
+	TArray<uint32> SortedUints = Uints;
+	Algo::Sort(SortedUints);
+	RadixSortTArray(Uints);
+	TestTrue(TEXT("uint32"), Uints == SortedUints);
+
+	// 按键排序，键相同的元素保持原有顺序
+	TArray<TPair<int32, int32>> Pairs;
+	for (int32 i = 0; i < 512; ++i)
+	{
+		Pairs.Emplace(Random.RandRange(-8, 8), i);
+	}
+	RadixSortTArray(Pairs, [](const TPair<int32, int32>& Pair) { return Pair.Key; });
+	bool bStable = true;
+	for (int32 i = 1; i < Pairs.Num(); ++i)
+	{
+		const bool bOrdered = Pairs[i - 1].Key < Pairs[i].Key || (Pairs[i - 1].Key == Pairs[i].Key && Pairs[i - 1].Value < Pairs[i].Value);
+		bStable &= bOrdered;
+	}
+	TestTrue(TEXT("按键排序稳定"), bStable);
+
+	TArray<int32> Single = {42};
+	RadixSortTArray(Single);
+	TestTrue(TEXT("单个元素"), Single == TArray<int32>{42});
+	return true;
+}
+
+// 环形缓冲和 SoA 工具
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCTArrayContainerTest, "ToolKits.YCTArray.Containers",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCTArrayContainerTest::RunTest(const FString& Parameters)
+{
+	// 容量向上取整为2的幂
+	TYCRingBuffer<int32> Ring(3);
+	TestEqual(TEXT("环形缓冲容量"), Ring.GetCapacity(), 4);
+	for (int32 i = 0; i < 4; ++i)
+	{
+		TestTrue(TEXT("未满时可以添加"), Ring.Push(i));
+	}
+	TestFalse(TEXT("已满时添加失败"), Ring.Push(4));
+
+	// 覆盖最早的元素
+	Ring.PushOverwrite(4);
+	TestEqual(TEXT("覆盖后最早的元素"), Ring.First(), 1);
+	TestEqual(TEXT("覆盖后最新的元素"), Ring.Last(), 4);
+
+	int32 Value = 0;
+	TArray<int32> Popped;
+	while (Ring.Pop(Value))
+	{
+		Popped.Add(Value);
+	}
+	TestTrue(TEXT("按添加顺序取出"), Popped == TArray<int32>{1, 2, 3, 4});
+	TestTrue(TEXT("取完为空"), Ring.IsEmpty());
+
+	// 跨越末尾后的下标访问
+	Ring.Push(10);
+	Ring.Push(11);
+	Ring.Push(12);
+	TestEqual(TEXT("环绕后的下标访问"), Ring[2], 12);
+
+	TYCSoAArray<FVector, float> SoA;
+	SoA.Add(FVector(1.f), 1.f);
+	SoA.Add(FVector(2.f), 2.f);
+	SoA.Add(FVector(3.f), 3.f);
+	SoA.RemoveAtSwap(0);
+	TestEqual(TEXT("SoA 行数"), SoA.Num(), 2);
+	TestEqual(TEXT("SoA 交换删除"), SoA.Get<1>()[0], 3.f);
+	TestEqual(TEXT("SoA 字段一致"), SoA.Get<0>()[0], FVector(3.f));
+
+	TArray<FTransform> Transforms;
+	Transforms.Emplace(FQuat(FVector::UpVector, 0.5f), FVector(1.f, 2.f, 3.f), FVector(2.f));
+	Transforms.Emplace(FQuat::Identity, FVector(4.f, 5.f, 6.f), FVector::OneVector);
+	TArray<FVector> Locations, Scales;
+	TArray<FQuat> Rotations;
+	SplitTransforms(Transforms, Locations, Rotations, Scales);
+	TestEqual(TEXT("SplitTransforms 位置"), Locations[1], FVector(4.f, 5.f, 6.f));
+	TestTrue(TEXT("SplitTransforms 旋转"), Rotations[0].Equals(Transforms[0].GetRotation()));
+	TestEqual(TEXT("SplitTransforms 缩放"), Scales[0], FVector(2.f));
+
+	TArray<FVector> Gathered;
+	GatherTArray(Transforms, &FTransform::GetLocation, Gathered);
+	TestTrue(TEXT("GatherTArray"), Gathered == Locations);
+	return true;
+}
+
+#endif
@@ -0,0 +1,220 @@
+#include "YCTArray.h"
+#include "Algo/Reverse.h"
+#include "Algo/Sort.h"
+#include "Algo/StableSort.h"
+#include "HAL/IConsoleManager.h"
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	// 执行 Iterations 次并返回单次平均耗时（毫秒）
+	template <typename FuncType>
+	double MeasureMs(const int32 Iterations, FuncType&& Func)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Func();
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+	}
+
+	// 输出一组对比结果，直接写到控制台，不受 YiChenLog 开关影响
+	void Report(FOutputDevice& Ar, const TCHAR* Name, const double OursMs, const TCHAR* BaselineName, const double BaselineMs)
+	{
+		Ar.Logf(TEXT("%s: %.3f ms, %s: %.3f ms (%.2fx)"), Name, OursMs, BaselineName, BaselineMs, BaselineMs / FMath::Max(OursMs, 1e-6));
+	}
+}
+
+// YCTArray 基准测试：与 TArray / Algo 中对应的做法对比
+static FAutoConsoleCommand YCTArrayBenchmarkCommand(
+	TEXT("ToolKits.YCTArray.Benchmark"),
+	TEXT("输出 YCTArray 工具函数与 TArray/Algo 对应做法的耗时对比"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		constexpr int32 Num = 1 << 18;
+		constexpr int32 Iterations = 10;
+
+		FRandomStream Random(Num);
+		TArray<float> Floats;
+		TArray<FString> Strings;
+		Floats.SetNumUninitialized(Num);
+		Strings.Reserve(Num / 16);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Floats[i] = Random.FRandRange(-1000.f, 1000.f);
+		}
+		for (int32 i = 0; i < Num / 16; ++i)
+		{
+			Strings.Add(FString::Printf(TEXT("Fence_%d"), i));
+		}
+
+		// 反转：移动交换 与 旧的拷贝交换
+		{
+			TArray<FString> Array = Strings;
+			const double Ours = MeasureMs(Iterations, [&Array]() { ReverseTArray(Array); });
+			const double Baseline = MeasureMs(Iterations, [&Array]()
+			{
+				const int32 Length = Array.Num();
+				for (int32 i = 0; i < Length / 2; ++i)
+				{
+					FString Temp = Array[i];
+					Array[i] = Array[Length - 1 - i];
+					Array[Length - 1 - i] = Temp;
+				}
+			});
+			Report(Ar, TEXT("ReverseTArray(FString)"), Ours, TEXT("拷贝交换"), Baseline);
+		}
+
+		{
+			TArray<float> Array = Floats;
+			const double Ours = MeasureMs(Iterations, [&Array]() { ReverseTArray(Array); });
+			const double Baseline = MeasureMs(Iterations, [&Array]() { Algo::Reverse(Array); });
+			Report(Ar, TEXT("ReverseTArray(float)"), Ours, TEXT("Algo::Reverse"), Baseline);
+		}
+
+		// 旋转：原地三次反转 与 删除后追加
+		{
+			TArray<FString> Array = Strings;
+			const int32 Count = Array.Num() / 3;
+			const double Ours = MeasureMs(Iterations, [&Array, Count]() { RotateTArray(Array, Count); });
+			const double Baseline = MeasureMs(Iterations, [&Array, Count]()
+			{
+				TArray<FString> Head(Array.GetData(), Count);
+				Array.RemoveAt(0, Count, false);
+				Array.Append(MoveTemp(Head));
+			});
+			Report(Ar, TEXT("RotateTArray"), Ours, TEXT("RemoveAt+Append"), Baseline);
+		}
+
+		// 稳定分区 与 稳定排序
+		{
+			TArray<float> Array = Floats;
+			const double Ours = MeasureMs(Iterations, [&Array, &Floats]()
+			{
+				Array = Floats;
+				StablePartitionTArray(Array, [](const float Value) { return Value < 0.f; });
+			});
+			const double Baseline = MeasureMs(Iterations, [&Array, &Floats]()
+			{
+				Array = Floats;
+				Algo::StableSortBy(Array, [](const float Value) { return Value < 0.f ? 0 : 1; });
+			});
+			Report(Ar, TEXT("StablePartitionTArray"), Ours, TEXT("Algo::StableSortBy"), Baseline);
+		}
+
+		// 基数排序 与 比较排序
+		{
+			TArray<float> Array;
+			const double Ours = MeasureMs(Iterations, [&Array, &Floats]()
+			{
+				Array = Floats;
+				RadixSortTArray(Array);
+			});
+			const double Baseline = MeasureMs(Iterations, [&Array, &Floats]()
+			{
+				Array = Floats;
+				Algo::Sort(Array);
+			});
+			Report(Ar, TEXT("RadixSortTArray(float)"), Ours, TEXT("Algo::Sort"), Baseline);
+		}
+
+		{
+			TArray<FString> Array;
+			const double Ours = MeasureMs(Iterations, [&Array, &Strings]()
+			{
+				Array = Strings;
+				RadixSortTArray(Array, [](const FString& Value) { return static_cast<uint32>(Value.Len()); });
+			});
+			const double Baseline = MeasureMs(Iterations, [&Array, &Strings]()
+			{
+				Array = Strings;
+				Algo::StableSortBy(Array, [](const FString& Value) { return Value.Len(); });
+			});
+			Report(Ar, TEXT("RadixSortTArray(按键)"), Ours, TEXT("Algo::StableSortBy"), Baseline);
+		}
+
+		// 环形缓冲 与 TArray 头部删除
+		{
+			constexpr int32 Window = 1024;
+			TYCRingBuffer<float> Ring(Window);
+			TArray<float> Queue;
+			Queue.Reserve(Window + 1);
+			const double Ours = MeasureMs(Iterations, [&Ring, &Floats]()
+			{
+				for (const float Value : Floats)
+				{
+					Ring.PushOverwrite(Value);
+				}
+			});
+			const double Baseline = MeasureMs(Iterations, [&Queue, &Floats]()
+			{
+				for (const float Value : Floats)
+				{
+					Queue.Add(Value);
+					if (Queue.Num() > Window)
+					{
+						Queue.RemoveAt(0, 1, false);
+					}
+				}
+			});
+			Report(Ar, TEXT("TYCRingBuffer"), Ours, TEXT("TArray::RemoveAt(0)"), Baseline);
+		}
+
+		// 小数组 与 堆分配数组
+		{
+			float Sum = 0.f;
+			const double Ours = MeasureMs(Iterations, [&Floats, &Sum]()
+			{
+				for (int32 i = 0; i + 8 <= Floats.Num(); i += 8)
+				{
+					TYCSmallArray<float> Small;
+					Small.Append(Floats.GetData() + i, 8);
+					Sum += Small.Last();
+				}
+			});
+			const double Baseline = MeasureMs(Iterations, [&Floats, &Sum]()
+			{
+				for (int32 i = 0; i + 8 <= Floats.Num(); i += 8)
+				{
+					TArray<float> Heap;
+					Heap.Append(Floats.GetData() + i, 8);
+					Sum += Heap.Last();
+				}
+			});
+			Report(Ar, TEXT("TYCSmallArray"), Ours, TEXT("TArray"), Baseline);
+			Ar.Logf(TEXT("校验和 %f"), Sum);
+		}
+
+		// SoA 与 AoS：只读取位置字段
+		{
+			TArray<FTransform> Transforms;
+			Transforms.Reserve(Num / 4);
+			for (int32 i = 0; i < Num / 4; ++i)
+			{
+				Transforms.Emplace(FQuat::Identity, FVector(Floats[i], Floats[i + 1], 0.f), FVector::OneVector);
+			}
+			TArray<FVector> Locations, Scales;
+			TArray<FQuat> Rotations;
+			SplitTransforms(Transforms, Locations, Rotations, Scales);
+
+			FVector Sum = FVector::ZeroVector;
+			const double Ours = MeasureMs(Iterations, [&Locations, &Sum]()
+			{
+				for (const FVector& Location : Locations)
+				{
+					Sum += Location;
+				}
+			});
+			const double Baseline = MeasureMs(Iterations, [&Transforms, &Sum]()
+			{
+				for (const FTransform& Transform : Transforms)
+				{
+					Sum += Transform.GetLocation();
+				}
+			});
+			Report(Ar, TEXT("SoA 位置求和"), Ours, TEXT("AoS FTransform"), Baseline);
+			Ar.Logf(TEXT("校验和 %s"), *Sum.ToString());
+		}
+	}));
+#endif
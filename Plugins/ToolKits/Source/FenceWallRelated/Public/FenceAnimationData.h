@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCurveFloat; // 浮点曲线
+
+/**
+ * GPU 动画的自定义数据布局，与 Shaders/Fence/FenceAnimation.ush 一致
+ * 0~4 为事件数据，事件发生时写入，8~23 为缩放曲线和击中曲线的采样，只在开始时写入
+ */
+namespace FenceAnimationData
+{
+	constexpr int32 HitStartTime = 0;
+	constexpr int32 HitDuration = 1;
+	constexpr int32 ShakeAngle = 2;
+	constexpr int32 ScaleStartTime = 3;
+	constexpr int32 ScaleDuration = 4;
+	// 缩放曲线和击中曲线的采样，各占两个 float4
+	constexpr int32 ScaleCurve = 8;
+	constexpr int32 HitCurve = 16;
+	// 每条曲线的采样数量
+	constexpr int32 CurveSamples = 8;
+	// 自定义数据的数量
+	constexpr int32 Num = HitCurve + CurveSamples;
+
+	/**
+	 * 在 0~1 上均匀采样曲线，材质在采样之间线性插值
+	 * @param Curve			曲线
+	 * @param Fallback		没有曲线时按进度计算的值
+	 * @param OutSamples	CurveSamples 个采样
+	 */
+	FENCEWALLRELATED_API void SampleCurve(const UCurveFloat* Curve, TFunctionRef<float(float)> Fallback, TArrayView<float> OutSamples);
+
+	// 默认的出现缩放，从0放大并略微回弹到1
+	FENCEWALLRELATED_API float DefaultSpawnScale(float Alpha);
+
+	// 默认的命中强度，开始和结束时为0，中间最大
+	FENCEWALLRELATED_API float DefaultHitAmount(float Alpha);
+}
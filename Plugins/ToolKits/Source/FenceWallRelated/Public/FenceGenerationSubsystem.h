@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FenceGenerationSubsystem.generated.h"
+
+class AFenceSpline; // 围栏样条线
+class AHelicalFence; // 螺旋围栏样条线
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnFenceGenerationProgress, int32, CompletedPosts, int32, TotalPosts);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnFenceGenerationFinished);
+
+/**
+ * 围栏生成任务
+ */
+struct FFenceGenerationJob
+{
+	// 围栏样条线或螺旋围栏样条线
+	TWeakObjectPtr<AActor> Fence;
+
+	// 计算好的变换（只有围栏样条线）
+	TArray<FTransform> Transforms;
+
+	// 到最近玩家的距离平方
+	double DistanceSquared = 0.0;
+
+	// 围栏数量，用于统计进度
+	int32 PostNum = 0;
+
+	// 已经计入进度的围栏数量
+	int32 CompletedPosts = 0;
+
+	// 是否已经开始生成
+	bool bStarted = false;
+};
+
+/**
+ * 围栏生成调度
+ * 关卡中所有围栏在 BeginPlay 时提交请求，同一帧提交的请求先在游戏线程上检查布局，
+ * 过期的布局在工作线程上并行采样样条线，然后按到玩家的距离由近到远生成，
+ * 围栏逐个生成，每帧的耗时不超过预算，长城墙会分多帧生成，
+ * 贴合地面的围栏在检测结果返回后继续分帧生成，进度按围栏统计，可用于加载界面
+ */
+UCLASS()
+class FENCEWALLRELATED_API UFenceGenerationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * 提交生成请求，下一帧开始生成
+	 * @param Fence			围栏样条线或螺旋围栏样条线
+	 */
+	void RequestGeneration(AActor* Fence);
+
+	// 是否还有未生成的围栏
+	UFUNCTION(BlueprintPure, Category="YC|城墙围栏相关")
+	FORCEINLINE bool IsGenerating() const { return !PendingRequests.IsEmpty() || !Jobs.IsEmpty() || !SnappingJobs.IsEmpty(); }
+
+	// 生成进度（0~1），按围栏数量统计
+	UFUNCTION(BlueprintPure, Category="YC|城墙围栏相关")
+	float GetGenerationProgress() const;
+
+	/**
+	 * 设置每帧生成的耗时预算，每帧至少生成一个围栏
+	 * @param Milliseconds	毫秒
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|城墙围栏相关")
+	void SetFrameBudget(float Milliseconds);
+
+	// 生成进度变化
+	UPROPERTY(BlueprintAssignable, Category="YC|城墙围栏相关")
+	FOnFenceGenerationProgress OnGenerationProgress;
+
+	// 所有请求生成完成
+	UPROPERTY(BlueprintAssignable, Category="YC|城墙围栏相关")
+	FOnFenceGenerationFinished OnGenerationFinished;
+
+private:
+	// 并行计算新请求的变换，并与未完成的任务一起按距离排序
+	void PrepareJobs();
+
+	/**
+	 * 生成一个任务，在截止时间前逐个生成围栏
+	 * @param EndTime	截止时间（FPlatformTime::Seconds）
+	 * @return			任务是否不需要继续生成（已完成、开始贴合地面或围栏被销毁）
+	 */
+	bool RealizeJob(FFenceGenerationJob& Job, double EndTime);
+
+	// 任务完成，剩余的围栏计入进度
+	void CompleteJob(FFenceGenerationJob& Job);
+
+	// 检查贴合地面的任务，检测结果返回后放回生成队列
+	void UpdateSnappingJobs();
+
+	// 最近玩家视点的距离平方，没有玩家时为到原点的距离
+	double GetDistanceSquaredToPlayers(const AActor* Fence, TConstArrayView<FVector> ViewLocations) const;
+
+	// 新提交的请求
+	TArray<TWeakObjectPtr<AActor>> PendingRequests;
+
+	// 等待生成的任务，按距离由远到近排列，从末尾取出，生成到一半的任务留在末尾
+	TArray<FFenceGenerationJob> Jobs;
+
+	// 已经提交贴合地面检测，等待结果返回的任务
+	TArray<FFenceGenerationJob> SnappingJobs;
+
+	// 每帧生成的耗时预算（毫秒）
+	float FrameBudgetMs = 4.f;
+
+	// 已生成的围栏数量
+	int32 CompletedPosts = 0;
+
+	// 本轮请求的围栏总数
+	int32 TotalPosts = 0;
+};
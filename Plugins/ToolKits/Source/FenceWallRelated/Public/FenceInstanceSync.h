@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * 围栏实例组件的增量同步
+ * 构造脚本重新执行时复用已有组件，新的变换与已有实例对比后只提交变化的部分
+ */
+namespace FenceInstanceSync
+{
+	/**
+	 * 按模型同步实例组件，已有的组件会被复用，多余的组件会被销毁
+	 * @param Owner			组件的所有者
+	 * @param Components	组件，同步后与 Models 一一对应，空模型对应空指针
+	 * @param Models		模型
+	 * @param Initialize	新建组件后的初始化（注册、附着、材质等）
+	 */
+	FENCEWALLRELATED_API void SyncComponents(AActor* Owner, TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>>& Components, const TArray<TObjectPtr<UStaticMesh>>& Models,
+	                                         TFunctionRef<void(UHierarchicalInstancedStaticMeshComponent*, UStaticMesh*)> Initialize);
+
+	/**
+	 * 同步实例，与已有实例逐个对比，相近的变化区间合并后批量提交，数量变化只在尾部增删
+	 * 组件的集群树不会在每次修改后重建，而是在最后异步重建一次
+	 * @param Component		实例组件
+	 * @param Transforms	实例的世界变换
+	 * @return				变化的实例数量
+	 */
+	FENCEWALLRELATED_API int32 SyncInstances(UHierarchicalInstancedStaticMeshComponent* Component, TArrayView<const FTransform> Transforms);
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavRelevantComponent.h"
+#include "FenceNavModifierComponent.generated.h"
+
+class UNavAreaBase; // 导航区域
+
+/**
+ * 围栏导航修改器
+ * 一段围栏共用一个组件，每个存在的围栏导出一个包围盒修改器，弯曲的样条线上不会填满弧线内侧，
+ * 围栏被移除时只需要更新这一个组件，导航重建的范围只与缺口所在的分段有关
+ */
+UCLASS(ClassGroup=(Navigation))
+class FENCEWALLRELATED_API UFenceNavModifierComponent : public UNavRelevantComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFenceNavModifierComponent();
+
+	// 导航区域
+	UPROPERTY(EditAnywhere, Category="导航", meta=(DisplayName = "导航区域"))
+	TSubclassOf<UNavAreaBase> AreaClass;
+
+	/**
+	 * 设置围栏，所有围栏默认存在
+	 * @param InTransforms	每个围栏的世界变换
+	 * @param InBoxes		每个围栏的局部包围盒
+	 */
+	void SetPosts(TArrayView<const FTransform> InTransforms, TArrayView<const FBox> InBoxes);
+
+	/**
+	 * 设置围栏是否存在，不会立即更新导航，修改完后调用 RefreshNavigationModifiers
+	 * @param Index			围栏在本组件中的下标
+	 * @param bAlive		是否存在
+	 */
+	void SetPostAlive(int32 Index, bool bAlive);
+
+	// 存在的围栏数量
+	FORCEINLINE int32 GetAliveNum() const { return AlivePosts.CountSetBits(); }
+
+	virtual void CalcAndCacheBounds() const override;
+	virtual void GetNavigationData(FNavigationRelevantData& Data) const override;
+
+private:
+	// 每个围栏的世界变换
+	TArray<FTransform> PostTransforms;
+
+	// 每个围栏的局部包围盒
+	TArray<FBox> PostBoxes;
+
+	// 围栏是否存在
+	TBitArray<> AlivePosts;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "FencePostReplication.generated.h"
+
+class AFenceSpline; // 围栏样条线
+
+/**
+ * 围栏状态的位布局，每个围栏 12 位
+ * 0 存在、1 显示、2~5 命中序号（循环递增，变化时播放命中）、6~11 颜色下标（0 为默认颜色）
+ */
+namespace FencePostState
+{
+	constexpr uint16 AliveBit = 1 << 0;
+	constexpr uint16 VisibleBit = 1 << 1;
+	constexpr int32 HitShift = 2;
+	constexpr uint16 HitMask = 0xF;
+	constexpr int32 ColorShift = 6;
+	constexpr uint16 ColorMask = 0x3F;
+	constexpr int32 NumBits = 12;
+
+	FORCEINLINE uint8 GetHitSequence(const uint16 State) { return (State >> HitShift) & HitMask; }
+	FORCEINLINE uint8 GetColorIndex(const uint16 State) { return (State >> ColorShift) & ColorMask; }
+
+	FORCEINLINE uint16 WithHitSequence(const uint16 State, const uint8 Sequence)
+	{
+		return (State & ~(HitMask << HitShift)) | ((Sequence & HitMask) << HitShift);
+	}
+
+	FORCEINLINE uint16 WithColorIndex(const uint16 State, const uint8 ColorIndex)
+	{
+		return (State & ~(ColorMask << ColorShift)) | ((ColorIndex & ColorMask) << ColorShift);
+	}
+}
+
+struct FFencePostStateArray;
+
+/**
+ * 一组连续围栏的状态
+ * 按组复制，缺口通常是连续的，一次修改只需要发送所在的几组
+ */
+USTRUCT()
+struct FENCEWALLRELATED_API FFencePostStateChunk : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	// 每组的围栏数量
+	static constexpr int32 PostNum = 16;
+
+	FFencePostStateChunk()
+	{
+		FMemory::Memzero(States);
+	}
+
+	// 组的下标，客户端的数组顺序不一定与服务器一致
+	uint16 ChunkIndex = 0;
+
+	// 每个围栏的状态
+	uint16 States[PostNum];
+
+	void PostReplicatedAdd(const FFencePostStateArray& InArraySerializer);
+	void PostReplicatedChange(const FFencePostStateArray& InArraySerializer);
+
+	// 网络序列化，每个围栏只写 12 位
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FFencePostStateChunk> : public TStructOpsTypeTraitsBase2<FFencePostStateChunk>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * 所有围栏的状态，由 AFenceSpline 复制，围栏本身不需要复制
+ */
+USTRUCT()
+struct FENCEWALLRELATED_API FFencePostStateArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FFencePostStateChunk> Chunks;
+
+	// 所属的围栏样条线，由 AFenceSpline::PostInitProperties 设置，不序列化
+	AFenceSpline* Owner = nullptr;
+
+	/**
+	 * 初始化（服务器）
+	 * @param PostCount		围栏数量
+	 * @param DefaultState	每个围栏的初始状态
+	 */
+	void Init(int32 PostCount, uint16 DefaultState);
+
+	// 获取围栏的状态，没有时为0
+	uint16 GetState(int32 PostIndex) const;
+
+	/**
+	 * 设置围栏的状态（服务器），只有变化时才标记所在的组
+	 * @return				是否变化
+	 */
+	bool SetState(int32 PostIndex, uint16 NewState);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FFencePostStateChunk, FFencePostStateArray>(Chunks, DeltaParms, *this);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FFencePostStateArray> : public TStructOpsTypeTraitsBase2<FFencePostStateArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
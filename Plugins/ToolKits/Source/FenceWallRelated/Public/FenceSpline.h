@@ -4,11 +4,53 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "FencePostReplication.h"
 #include "FenceSpline.generated.h"
 
 class USplineComponent; // 样条线
 class UHierarchicalInstancedStaticMeshComponent; // 静态网格实例化
 class ASingleFence_Base; // 单一围栏
+class UFenceNavModifierComponent; // 围栏导航修改器
+class UNavAreaBase; // 导航区域
+
+/**
+ * 围栏布局
+ * 保存时烘焙到关卡里，运行时直接读取，不再沿样条线计算
+ */
+USTRUCT()
+struct FENCEWALLRELATED_API FFenceLayout
+{
+	GENERATED_BODY()
+
+	// 每个围栏相对于 Actor 的变换
+	UPROPERTY()
+	TArray<FTransform> Transforms;
+
+	// 每个围栏使用的模型下标
+	UPROPERTY()
+	TArray<uint8> MeshIndices;
+
+	// 每个围栏沿样条线的累计距离
+	UPROPERTY()
+	TArray<float> Distances;
+
+	// 生成布局时样条线和参数的哈希，不一致时需要重新计算
+	UPROPERTY()
+	uint32 SourceHash = 0;
+
+	// 围栏数量
+	FORCEINLINE int32 Num() const { return Transforms.Num(); }
+
+	// 清空
+	void Reset()
+	{
+		Transforms.Reset();
+		MeshIndices.Reset();
+		Distances.Reset();
+		SourceHash = 0;
+	}
+};
 
 /**
  * 围栏样条线
@@ -35,7 +77,7 @@ public:
 
 	// 显示模型
 	UPROPERTY(EditAnywhere, Category="默认", meta=(DisplayName = "显示的模型"))
-	TArray<UStaticMesh*> DisplayModels;
+	TArray<TObjectPtr<UStaticMesh>> DisplayModels;
 
 	// 显示数量
 	UPROPERTY(EditAnywhere, Category="默认", meta=(DisplayName = "显示数量"))
@@ -43,7 +85,7 @@ public:
 
 	// 实例化网格
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category="默认", meta=(DisplayName = "实例化网格"))
-	TArray<UHierarchicalInstancedStaticMeshComponent*> InstancedStaticMeshComponents;
+	TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> InstancedStaticMeshComponents;
 
 	// 模型大小
 	UPROPERTY(EditAnywhere, Category="默认", meta=(DisplayName = "模型大小"))
@@ -57,13 +99,97 @@ public:
 	UPROPERTY(EditAnywhere, Category="默认", meta=(DisplayName = "颜色"))
 	FLinearColor CampColor = FLinearColor::Green;
 
+	// 贴合地面，生成前向下检测地面并调整高度和倾斜
+	UPROPERTY(EditAnywhere, Category="贴合地面", meta=(DisplayName = "贴合地面"))
+	uint8 bSnapToGround : 1;
+
+	// 检测地面的通道
+	UPROPERTY(EditAnywhere, Category="贴合地面", meta=(DisplayName = "检测通道", EditCondition = "bSnapToGround"))
+	TEnumAsByte<ECollisionChannel> GroundTraceChannel = ECC_WorldStatic;
+
+	// 检测地面时向上和向下的距离
+	UPROPERTY(EditAnywhere, Category="贴合地面", meta=(DisplayName = "检测距离", ClampMin = 0.f, EditCondition = "bSnapToGround"))
+	float GroundTraceDistance = 500.f;
+
+	// 贴合后的高度偏移
+	UPROPERTY(EditAnywhere, Category="贴合地面", meta=(DisplayName = "高度偏移", EditCondition = "bSnapToGround"))
+	float GroundOffset = 0.f;
+
+	// 随地面坡度倾斜的程度，0为保持竖直，1为垂直于地面
+	UPROPERTY(EditAnywhere, Category="贴合地面", meta=(DisplayName = "倾斜程度", ClampMin = 0.f, ClampMax = 1.f, EditCondition = "bSnapToGround"))
+	float GroundAlignment = 1.f;
+
+	// 影响导航，每段连续的围栏共用一个导航修改器
+	UPROPERTY(EditAnywhere, Category="导航", meta=(DisplayName = "影响导航"))
+	uint8 bAffectNavigation : 1;
+
+	// 导航区域，为空时使用不可通行区域
+	UPROPERTY(EditAnywhere, Category="导航", meta=(DisplayName = "导航区域", EditCondition = "bAffectNavigation"))
+	TSubclassOf<UNavAreaBase> NavAreaClass;
+
+	// 每个导航修改器包含的围栏数量，越小缺口处重建的导航范围越小，修改器数量越多
+	UPROPERTY(EditAnywhere, Category="导航", meta=(DisplayName = "导航分段围栏数", ClampMin = 1, EditCondition = "bAffectNavigation"))
+	int32 NavPostsPerSegment = 8;
+
+	// 复制每个围栏的状态，开启后围栏样条线会复制并且始终相关，单机或不需要同步的城墙保持关闭
+	UPROPERTY(EditAnywhere, Category="网络", meta=(DisplayName = "复制围栏状态"))
+	uint8 bReplicatePostStates : 1;
+
+	// 阵营颜色表，复制的颜色下标 1~63 对应表中的颜色，0 为默认颜色
+	UPROPERTY(EditAnywhere, Category="网络", meta=(DisplayName = "阵营颜色表"))
+	TArray<FLinearColor> CampColorPalette;
+
+	// 客户端播放命中时的抖动角度
+	UPROPERTY(EditAnywhere, Category="网络", meta=(DisplayName = "命中抖动角度"))
+	float HitShakeAngle = 5.f;
+
 	// 所有围栏
 	UPROPERTY(BlueprintReadOnly, Category="默认")
 	TArray<TObjectPtr<ASingleFence_Base>> AllSingleFences;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * 设置围栏是否显示（服务器）
+	 * @param PostIndex		围栏在布局中的下标
+	 * @param bVisible		是否显示
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="YC|城墙围栏相关")
+	void SetFencePostVisible(int32 PostIndex, bool bVisible);
+
+	/**
+	 * 设置围栏的颜色（服务器）
+	 * @param PostIndex		围栏在布局中的下标
+	 * @param ColorIndex	颜色下标，0 为默认颜色，1~63 为阵营颜色表中的颜色
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="YC|城墙围栏相关")
+	void SetFencePostColorIndex(int32 PostIndex, uint8 ColorIndex);
+
+	/**
+	 * 围栏被攻击（服务器），所有端播放命中
+	 * @param PostIndex		围栏在布局中的下标
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="YC|城墙围栏相关")
+	void NotifyFencePostHit(int32 PostIndex);
+
+	/**
+	 * 移除围栏（服务器），所有端移除
+	 * @param PostIndex		围栏在布局中的下标
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="YC|城墙围栏相关")
+	void SetFencePostRemoved(int32 PostIndex);
+
+	// 获取颜色下标对应的颜色
+	UFUNCTION(BlueprintPure, Category="YC|城墙围栏相关")
+	FLinearColor GetPaletteColor(uint8 ColorIndex) const;
+
 protected:
+	virtual void PostInitProperties() override;
 	virtual void BeginPlay() override;
 	virtual void OnConstruction(const FTransform& Transform) override;
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
 
 	/**
 	* 初始化围栏组件
@@ -72,13 +198,161 @@ protected:
 	*/
 	void InitializeComponent(TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component, TObjectPtr<UStaticMesh> NewStaticMesh);
 
+	/**
+	 * 按变换生成围栏单体，可以分多次调用，子类可以替换为其他表示方式（例如 Mass 实体）
+	 * @param Transforms	每个围栏的世界变换，与布局一一对应
+	 * @param FirstPost		从这个下标开始生成，0 为重新开始
+	 * @param EndTime		超过这个时间（FPlatformTime::Seconds）后停止，至少生成一个围栏
+	 * @return				下一次开始生成的下标，等于围栏数量时已全部生成
+	 */
+	virtual int32 RealizeFences(const TArray<FTransform>& Transforms, int32 FirstPost, double EndTime);
+
+	/**
+	 * 按分段创建导航修改器
+	 * @param Transforms	每个围栏的世界变换
+	 * @param Spawned		每个围栏是否生成成功
+	 */
+	void BuildNavModifiers(const TArray<FTransform>& Transforms, const TBitArray<>& Spawned);
+
+	/**
+	 * 围栏被移除，记录所在分段，下一帧统一更新导航
+	 * @param PostIndex		围栏在布局中的下标
+	 */
+	void MarkPostRemovedFromNavigation(int32 PostIndex);
+
+	/**
+	 * 把复制的状态应用到围栏上，服务器修改和客户端收到复制时都会调用
+	 * @param PostIndex		围栏在布局中的下标
+	 * @param OldState		之前的状态
+	 * @param NewState		新的状态
+	 */
+	virtual void ApplyPostState(int32 PostIndex, uint16 OldState, uint16 NewState);
+
+	// 围栏的初始状态
+	uint16 GetDefaultPostState() const;
+
 private:
+	friend struct FFencePostStateChunk;
+	friend class UFenceGenerationSubsystem;
+
+	// 修改围栏的状态（服务器）
+	void SetPostState(int32 PostIndex, uint16 NewState);
+
+	// 应用一组复制的状态，围栏生成前收到的会在生成后统一应用
+	void ApplyPostStateChunk(const FFencePostStateChunk& Chunk);
+
+	// 围栏生成后应用已经收到的状态
+	void ApplyReplicatedPostStates();
+
+	// 复制的围栏状态
+	UPROPERTY(Replicated)
+	FFencePostStateArray PostStates;
+
+	// 已经应用到围栏上的状态，围栏生成前为空
+	TArray<uint16> AppliedPostStates;
+
+	// 按布局下标保存的围栏
+	TArray<TWeakObjectPtr<ASingleFence_Base>> PostsByIndex;
+
+	/**
+	 * 开始贴合地面，同一帧提交所有异步检测，结果全部返回后生成围栏
+	 * @param Transforms	每个围栏的世界变换
+	 */
+	void StartGroundSnap(TArray<FTransform>&& Transforms);
+
+	// 异步检测完成
+	void OnGroundTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	// 等待贴合地面的变换
+	TArray<FTransform> GroundSnapTransforms;
+
+	// 每个围栏的检测句柄，用来忽略过期的结果
+	TArray<FTraceHandle> GroundTraceHandles;
+
+	// 还未返回的检测数量
+	int32 PendingGroundTraces = 0;
+
+	// 开始生成围栏，立即生成时一次生成所有围栏，否则等待 ContinueRealizeFences
+	void BeginRealizeFences(TArray<FTransform>&& Transforms);
+
+	// 分帧生成的围栏变换
+	TArray<FTransform> RealizeTransforms;
+
+	// 下一个要生成的围栏下标，INDEX_NONE 为没有在生成
+	int32 NextRealizePost = INDEX_NONE;
+
+	// 每个围栏是否生成成功
+	TBitArray<> SpawnedPosts;
+
+	// 贴合地面的检测返回后是否立即生成所有围栏
+	uint8 bRealizeImmediately : 1;
+
+	// 检测完成的回调
+	FTraceDelegate GroundTraceDelegate;
+
+	// 围栏被销毁
+	UFUNCTION()
+	void OnFencePostDestroyed(AActor* DestroyedActor);
+
+	// 更新这一帧有围栏被移除的分段
+	void FlushNavModifiers();
+
+	// 导航修改器，每个分段一个
+	UPROPERTY()
+	TArray<TObjectPtr<UFenceNavModifierComponent>> NavModifierComponents;
+
+	// 围栏在布局中的下标
+	TMap<const AActor*, int32> PostIndices;
+
+	// 等待更新的分段
+	TSet<int32> DirtyNavSegments;
+
+	// 是否已经安排下一帧更新导航
+	uint8 bNavFlushPending : 1;
+
 	// 获取模型长度
 	FVector GetMeshLength(int32 Index);
 
-	// 获取临时变换
+	// 获取临时变换（世界坐标）
 	TArray<FTransform> GetTempTransforms();
 
+	// 计算样条线和参数的哈希
+	uint32 ComputeLayoutHash() const;
+
+	// 沿样条线计算布局
+	void ComputeLayout(FFenceLayout& OutLayout);
+
+	/**
+	 * 收集计算布局需要的模型长度，只在游戏线程调用
+	 * @param OutModelLengths	每个模型的长度
+	 * @return					是否需要沿样条线采样
+	 */
+	bool GetLayoutModelLengths(TArray<float>& OutModelLengths);
+
+	/**
+	 * 沿样条线采样布局，只读取样条线和参数，可以在工作线程上执行
+	 * @param ModelLengths	GetLayoutModelLengths 的结果
+	 * @param OutLayout		采样结果，不包含哈希
+	 */
+	void SampleLayout(TConstArrayView<float> ModelLengths, FFenceLayout& OutLayout) const;
+
+	// 烘焙的布局是否与当前的样条线和参数一致
+	FORCEINLINE bool IsLayoutValid(const uint32 Hash) const { return BakedLayout.Num() > 0 && BakedLayout.SourceHash == Hash; }
+
+	/**
+	 * 烘焙的布局是否可以直接使用
+	 * 编辑器（包括 PIE）中比较哈希，过期时需要重新采样；游戏中只要有烘焙的布局就直接使用，过期时只输出警告
+	 * @param OutHash		需要重新采样时为当前的哈希
+	 */
+	bool CanUseBakedLayout(uint32& OutHash) const;
+
+	// 获取布局，烘焙的布局不能直接使用时重新计算
+	const FFenceLayout& GetLayout();
+
+	// 烘焙的布局
+	UPROPERTY()
+	FFenceLayout BakedLayout;
+
 	// 添加显示模型
 	void AddDisplayModel();
 
@@ -87,6 +361,36 @@ public:
 	UFUNCTION(BlueprintCallable, Category="默认")
 	void GeneratingFences();
 
+	// 计算生成用的世界变换，烘焙的布局不能直接使用时会重新计算，只在游戏线程调用
+	TArray<FTransform> PrepareFenceTransforms();
+
+	/**
+	 * 按计算好的变换生成围栏
+	 * @param TempTransforms	PrepareFenceTransforms 的结果
+	 * @param bRealizeNow		是否立即生成所有围栏，否则由 ContinueRealizeFences 分帧生成
+	 */
+	void GenerateFromTransforms(TArray<FTransform>&& TempTransforms, bool bRealizeNow = true);
+
+	/**
+	 * 继续分帧生成围栏，全部生成后应用复制的状态
+	 * @param EndTime		超过这个时间（FPlatformTime::Seconds）后停止，至少生成一个围栏
+	 * @return				本次生成的围栏数量
+	 */
+	int32 ContinueRealizeFences(double EndTime);
+
+	// 是否还有围栏等待分帧生成
+	FORCEINLINE bool IsRealizingFences() const { return NextRealizePost != INDEX_NONE; }
+
 	// 获取所有围栏
 	FORCEINLINE TArray<TObjectPtr<ASingleFence_Base>> GetAllSingleFences() const { return AllSingleFences; };
+
+	// 是否正在等待贴合地面的检测结果
+	FORCEINLINE bool IsSnappingToGround() const { return PendingGroundTraces > 0; }
+
+	// 烘焙布局，关卡保存和烘焙时会自动执行
+	UFUNCTION(CallInEditor, Category="默认", meta=(DisplayName = "烘焙布局"))
+	void BakeLayout();
+
+	// 获取烘焙的布局
+	FORCEINLINE const FFenceLayout& GetBakedLayout() const { return BakedLayout; }
 };
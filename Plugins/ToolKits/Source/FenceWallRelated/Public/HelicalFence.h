@@ -13,6 +13,8 @@ class AFenceSpline; // 围栏样条线
 
 /**
  * 螺旋围栏样条线
+ * 指定了围栏样条线时不再生成自己的围栏，而是借用围栏样条线的围栏，
+ * 按进度把每个围栏从螺旋线上的位置移动到城墙上的位置
  */
 UCLASS()
 class FENCEWALLRELATED_API AHelicalFence : public AActor
@@ -99,6 +101,10 @@ public:
 	UPROPERTY(EditAnywhere, Interp, Category="默认", DisplayName = "开始运行")
 	uint8 bStart : 1;
 
+	// 围栏从螺旋线移动到城墙上的过渡距离（沿螺旋线），0为直接切换
+	UPROPERTY(EditAnywhere, Category="默认", meta=(DisplayName = "展开过渡距离", ClampMin = 0.f))
+	float UnrollBlendDistance = 100.f;
+
 	// 实际长度
 	UPROPERTY(VisibleAnywhere, Category="默认", meta=(DisplayName = "实际长度"))
 	float ActualLength = 0.f;
@@ -148,4 +154,51 @@ public:
 
 	// 围栏显示隐藏
 	void FenceHidden();
+
+private:
+	// 借用围栏样条线的围栏，只记录城墙上的位置，开始运行后围栏离开城墙时才移到螺旋线上
+	void LinkFenceSplinePosts();
+
+	/**
+	 * 按展开程度更新借用的围栏，停在螺旋线或城墙上且没有变化时不做任何事
+	 * @param Index			围栏下标
+	 * @param Alpha			展开程度，0在螺旋线上，1在城墙上
+	 */
+	void UpdateSharedPost(int32 Index, float Alpha);
+
+	// 每个围栏在螺旋线上的位置（相对于样条线组件）
+	TArray<FTransform> SpiralSlots;
+
+	// 每个围栏在城墙上的位置（世界坐标）
+	TArray<FTransform> WallSlots;
+
+	// 每个围栏开始展开时沿螺旋线的距离
+	TArray<float> RevealDistances;
+
+	// 每个围栏上次应用的展开程度，借用时为1（仍在城墙上），小于1表示由螺旋线拥有
+	TArray<float> PostAlphas;
+
+	// 每个围栏离开城墙时是否隐藏，回到城墙上时恢复，不覆盖围栏样条线复制的显示状态
+	TBitArray<> WallHidden;
+
+	// 借用围栏时螺旋线的长度
+	float RevealLength = 0.f;
+
+	/**
+	 * 计算进度对应的样条线位置
+	 * @param InProgress	进度
+	 * @return				X为样条线的偏移，Y为样条线的朝向
+	 */
+	FVector2D ComputeSplinePose(float InProgress) const;
+
+	// 构建螺旋线后按螺旋线的点采样样条线位置
+	void BuildSplinePoseTable();
+
+	// 样条线位置的采样，每两个螺旋线点之间采样若干次，按进度递增排列
+	// X为进度，Y为偏移，Z为朝向（连续展开，不会在±180处跳变），每次构造时重新采样，不保存
+	UPROPERTY(Transient)
+	TArray<FVector> SplinePoseTable;
+
+	// 上次应用到样条线的进度，进度不变时不需要移动样条线
+	float AppliedPoseProgress = -1.f;
 };
@@ -34,6 +34,9 @@ public:
 protected:
 	virtual void BeginPlay() override;
 
+	// 结束时移除仍在播放的动画计数
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// 重写，用于在构造函数中设置属性
 	virtual void OnConstruction(const FTransform& Transform) override;
 
@@ -97,6 +100,12 @@ protected:
 	// 是否在命中
 	uint8 bInHit : 1;
 
+	// 使用 GPU 动画，命中抖动和出现缩放由材质的 World Position Offset 完成，
+	// 材质需要使用 Shaders/Fence/FenceAnimation.ush，事件发生时只写入一次自定义图元数据，
+	// 缩放曲线和击中曲线各采样8个点写入自定义图元数据，材质在采样之间线性插值，尖锐的曲线会被平滑
+	UPROPERTY(EditDefaultsOnly, Category="默认", meta=(DisplayName = "GPU动画"))
+	uint8 bUseGPUAnimation : 1;
+
 private:
 	// 初始大小
 	UPROPERTY()
@@ -128,6 +137,9 @@ private:
 	// 缩放播放
 	void ScalePlay();
 
+	// 写入 GPU 动画的曲线采样，只在开始和更换曲线时写入，事件发生时只写入开始时间
+	void WriteAnimationCurves();
+
 	// 击中时间
 	UPROPERTY(EditDefaultsOnly, Category="默认")
 	float HitTime = 0.3f;
@@ -177,13 +189,19 @@ public:
 	 * 设置缩放曲线
 	 * @param NewCurve 缩放曲线
 	 */
-	FORCEINLINE void SetScaleFloat(const TObjectPtr<UCurveFloat> NewCurve) { if (NewCurve)ScaleCurve = *NewCurve; };
+	FORCEINLINE void SetScaleFloat(const TObjectPtr<UCurveFloat> NewCurve) { if (NewCurve)ScaleCurve = *NewCurve; WriteAnimationCurves(); };
 	/**
 	 * 设置击中曲线
 	 * @param NewCurve 击中曲线
 	 */
-	FORCEINLINE void SetHitFloat(const TObjectPtr<UCurveFloat> NewCurve) { if (NewCurve)HitCurve = *NewCurve; };
+	FORCEINLINE void SetHitFloat(const TObjectPtr<UCurveFloat> NewCurve) { if (NewCurve)HitCurve = *NewCurve; WriteAnimationCurves(); };
 
 	// 获取碰撞盒
 	FORCEINLINE UBoxComponent* GetBox() const { return Box; }
+
+	/**
+	 * 设置围栏是否修改导航，在组件注册前调用
+	 * @param bAffect		围栏样条线的导航修改器接管时为 false
+	 */
+	void SetAffectNavigation(bool bAffect);
 };
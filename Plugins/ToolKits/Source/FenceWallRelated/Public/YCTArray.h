@@ -1,23 +1,382 @@
 #pragma once
+#include "CoreMinimal.h"
 #include "Containers/Array.h"
+#include "Templates/Invoke.h"
+#include "Templates/Tuple.h"
+#include <type_traits>
+
+// 反转数组区间 [First, Last)
+template <typename T, typename AllocatorType>
+void ReverseTArrayRange(TArray<T, AllocatorType>& Array, int32 First, int32 Last)
+{
+	check(First >= 0 && Last <= Array.Num() && First <= Last);
+
+	T* Data = Array.GetData();
+	// 从两端向中间交换，Swap 使用移动语义，不会拷贝元素
+	for (--Last; First < Last; ++First, --Last)
+	{
+		Swap(Data[First], Data[Last]);
+	}
+}
 
 // 反转数组
+template <typename T, typename AllocatorType>
+void ReverseTArray(TArray<T, AllocatorType>& Array)
+{
+	ReverseTArrayRange(Array, 0, Array.Num());
+}
+
+/**
+ * 原地向左旋转数组，旋转后 Array[Count] 成为第一个元素
+ * @param Array		数组
+ * @param Count		旋转的数量，为负时向右旋转
+ */
+template <typename T, typename AllocatorType>
+void RotateTArray(TArray<T, AllocatorType>& Array, int32 Count)
+{
+	const int32 Num = Array.Num();
+	if (Num <= 1) return;
+
+	Count %= Num;
+	if (Count < 0) Count += Num;
+	if (Count == 0) return;
+
+	// 三次反转，每个元素只移动常数次
+	ReverseTArrayRange(Array, 0, Count);
+	ReverseTArrayRange(Array, Count, Num);
+	ReverseTArrayRange(Array, 0, Num);
+}
+
+/**
+ * 稳定分区，满足条件的元素移到前面，两部分内部保持原有顺序
+ * @param Array		数组
+ * @param Predicate	条件
+ * @return			第一个不满足条件的元素下标
+ */
+template <typename T, typename AllocatorType, typename PredicateType>
+int32 StablePartitionTArray(TArray<T, AllocatorType>& Array, PredicateType Predicate)
+{
+	T* Data = Array.GetData();
+	const int32 Num = Array.Num();
+
+	// 不满足条件的元素暂存，全部满足时不会分配内存
+	TArray<T> Rejected;
+	int32 Write = 0;
+	for (int32 Read = 0; Read < Num; ++Read)
+	{
+		if (Invoke(Predicate, Data[Read]))
+		{
+			if (Write != Read)
+			{
+				Data[Write] = MoveTemp(Data[Read]);
+			}
+			++Write;
+		}
+		else
+		{
+			Rejected.Add(MoveTemp(Data[Read]));
+		}
+	}
+
+	for (int32 i = 0; i < Rejected.Num(); ++i)
+	{
+		Data[Write + i] = MoveTemp(Rejected[i]);
+	}
+	return Write;
+}
+
+namespace YCTArray::Private
+{
+	// 把键转换成按无符号整数比较时顺序不变的形式
+	FORCEINLINE uint32 RadixKey(const uint32 Key) { return Key; }
+	FORCEINLINE uint32 RadixKey(const int32 Key) { return static_cast<uint32>(Key) ^ 0x80000000u; }
+
+	FORCEINLINE uint32 RadixKey(const float Key)
+	{
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Key, sizeof(Bits));
+		// 负数全部取反，正数翻转符号位
+		return (Bits & 0x80000000u) ? ~Bits : (Bits | 0x80000000u);
+	}
+
+	// 按键对值做LSD基数排序，每次处理8位，所有元素键相同的字节会被跳过
+	template <typename ValueType>
+	void RadixSortPairs(TArray<uint32>& Keys, TArray<ValueType>& Values)
+	{
+		const int32 Num = Keys.Num();
+
+		// 一次遍历统计四个字节的分布
+		uint32 Histograms[4][256] = {};
+		for (const uint32 Key : Keys)
+		{
+			++Histograms[0][Key & 0xFF];
+			++Histograms[1][(Key >> 8) & 0xFF];
+			++Histograms[2][(Key >> 16) & 0xFF];
+			++Histograms[3][Key >> 24];
+		}
+
+		TArray<uint32> TempKeys;
+		TArray<ValueType> TempValues;
+		TempKeys.SetNumUninitialized(Num);
+		TempValues.SetNumUninitialized(Num);
+
+		for (int32 Pass = 0; Pass < 4; ++Pass)
+		{
+			const int32 Shift = Pass * 8;
+			uint32* Histogram = Histograms[Pass];
+			if (Histogram[(Keys[0] >> Shift) & 0xFF] == static_cast<uint32>(Num)) continue;
+
+			// 计数转换为起始位置
+			uint32 Offset = 0;
+			for (int32 Bucket = 0; Bucket < 256; ++Bucket)
+			{
+				const uint32 Count = Histogram[Bucket];
+				Histogram[Bucket] = Offset;
+				Offset += Count;
+			}
+
+			for (int32 i = 0; i < Num; ++i)
+			{
+				const uint32 Dest = Histogram[(Keys[i] >> Shift) & 0xFF]++;
+				TempKeys[Dest] = Keys[i];
+				TempValues[Dest] = Values[i];
+			}
+			Swap(Keys, TempKeys);
+			Swap(Values, TempValues);
+		}
+	}
+}
+
+/**
+ * 基数排序（稳定，O(n)），适合大量元素按整数或浮点数键排序
+ * @param Array		数组
+ * @param KeyFunc	返回 uint32、int32 或 float 键
+ */
+template <typename T, typename AllocatorType, typename KeyFuncType>
+void RadixSortTArray(TArray<T, AllocatorType>& Array, KeyFuncType KeyFunc)
+{
+	const int32 Num = Array.Num();
+	if (Num <= 1) return;
+
+	// 排序过程中只移动 键+下标，最后每个元素只移动一次
+	TArray<uint32> Keys;
+	TArray<int32> Indices;
+	Keys.SetNumUninitialized(Num);
+	Indices.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Keys[i] = YCTArray::Private::RadixKey(Invoke(KeyFunc, Array[i]));
+		Indices[i] = i;
+	}
+
+	YCTArray::Private::RadixSortPairs(Keys, Indices);
+
+	TArray<T, AllocatorType> Sorted;
+	Sorted.Reserve(Num);
+	for (const int32 Index : Indices)
+	{
+		Sorted.Add(MoveTemp(Array[Index]));
+	}
+	Array = MoveTemp(Sorted);
+}
+
+// 基数排序 uint32、int32 或 float 数组
+template <typename T, typename AllocatorType>
+void RadixSortTArray(TArray<T, AllocatorType>& Array)
+{
+	static_assert(std::is_same_v<T, uint32> || std::is_same_v<T, int32> || std::is_same_v<T, float>, "只支持 uint32、int32、float");
+
+	const int32 Num = Array.Num();
+	if (Num <= 1) return;
+
+	TArray<uint32> Keys;
+	TArray<T> Values(Array.GetData(), Num);
+	Keys.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Keys[i] = YCTArray::Private::RadixKey(Values[i]);
+	}
+
+	YCTArray::Private::RadixSortPairs(Keys, Values);
+	FMemory::Memcpy(Array.GetData(), Values.GetData(), Num * sizeof(T));
+}
+
+/**
+ * 固定容量的环形缓冲，创建后不再分配内存
+ * 容量会向上取整为2的幂，元素需要可以默认构造
+ */
 template <typename T>
-void ReverseTArray(TArray<T>& Array)
+class TYCRingBuffer
+{
+public:
+	explicit TYCRingBuffer(const int32 InCapacity = 16)
+	{
+		Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 1)));
+		Data.SetNum(Capacity);
+	}
+
+	/**
+	 * 添加到末尾
+	 * @return 缓冲已满时返回 false
+	 */
+	template <typename ArgType>
+	bool Push(ArgType&& Value)
+	{
+		if (IsFull()) return false;
+		Data[(Start + Count) & (Capacity - 1)] = Forward<ArgType>(Value);
+		++Count;
+		return true;
+	}
+
+	// 添加到末尾，缓冲已满时覆盖最早的元素
+	template <typename ArgType>
+	void PushOverwrite(ArgType&& Value)
+	{
+		if (IsFull())
+		{
+			Data[Start] = Forward<ArgType>(Value);
+			Start = (Start + 1) & (Capacity - 1);
+			return;
+		}
+		Push(Forward<ArgType>(Value));
+	}
+
+	/**
+	 * 取出最早的元素
+	 * @return 缓冲为空时返回 false
+	 */
+	bool Pop(T& OutValue)
+	{
+		if (IsEmpty()) return false;
+		OutValue = MoveTemp(Data[Start]);
+		Start = (Start + 1) & (Capacity - 1);
+		--Count;
+		return true;
+	}
+
+	// 清空
+	void Reset()
+	{
+		Start = 0;
+		Count = 0;
+	}
+
+	// 按添加顺序访问，0 为最早的元素
+	FORCEINLINE T& operator[](const int32 Index)
+	{
+		checkSlow(Index >= 0 && static_cast<uint32>(Index) < Count);
+		return Data[(Start + Index) & (Capacity - 1)];
+	}
+
+	FORCEINLINE const T& operator[](const int32 Index) const
+	{
+		checkSlow(Index >= 0 && static_cast<uint32>(Index) < Count);
+		return Data[(Start + Index) & (Capacity - 1)];
+	}
+
+	// 最早的元素
+	FORCEINLINE T& First() { return (*this)[0]; }
+
+	// 最新的元素
+	FORCEINLINE T& Last() { return (*this)[static_cast<int32>(Count) - 1]; }
+
+	FORCEINLINE int32 Num() const { return static_cast<int32>(Count); }
+	FORCEINLINE int32 GetCapacity() const { return static_cast<int32>(Capacity); }
+	FORCEINLINE bool IsEmpty() const { return Count == 0; }
+	FORCEINLINE bool IsFull() const { return Count == Capacity; }
+
+private:
+	TArray<T> Data;
+	uint32 Capacity = 0;
+	// 最早元素的位置
+	uint32 Start = 0;
+	// 元素数量
+	uint32 Count = 0;
+};
+
+// 小数组，元素数量不超过 InlineNum 时不分配堆内存
+template <typename T, uint32 InlineNum = 8>
+using TYCSmallArray = TArray<T, TInlineAllocator<InlineNum>>;
+
+/**
+ * 结构体数组（SoA），每个字段一个连续数组，只访问部分字段的循环可以减少缓存浪费
+ * 例如 TYCSoAArray<FVector, FQuat, float>，通过 Get<0>() 获取第一个字段的数组
+ */
+template <typename... Ts>
+class TYCSoAArray
 {
-	// 获取数组的长度
-	int32 Length = Array.Num();
+public:
+	// 添加一行，返回下标
+	int32 Add(const Ts&... Values)
+	{
+		const int32 Index = Num();
+		AddImpl(TMakeIntegerSequence<uint32, sizeof...(Ts)>(), Values...);
+		return Index;
+	}
+
+	// 交换删除一行
+	void RemoveAtSwap(const int32 Index)
+	{
+		VisitTupleElements([Index](auto& Column) { Column.RemoveAtSwap(Index, 1, false); }, Columns);
+	}
+
+	void Reserve(const int32 Number)
+	{
+		VisitTupleElements([Number](auto& Column) { Column.Reserve(Number); }, Columns);
+	}
+
+	void Reset()
+	{
+		VisitTupleElements([](auto& Column) { Column.Reset(); }, Columns);
+	}
+
+	FORCEINLINE int32 Num() const { return Columns.template Get<0>().Num(); }
+
+	// 获取字段数组
+	template <uint32 Index>
+	FORCEINLINE auto& Get() { return Columns.template Get<Index>(); }
 
-	if (Length == 0) return;
+	template <uint32 Index>
+	FORCEINLINE const auto& Get() const { return Columns.template Get<Index>(); }
 
-	// 循环遍历数组的前半部分，交换元素
-	for (int32 i = 0; i < Length / 2; ++i)
+private:
+	template <uint32... Indices>
+	FORCEINLINE void AddImpl(TIntegerSequence<uint32, Indices...>, const Ts&... Values)
 	{
-		// 临时变量存储当前元素
-		T Temp = Array[i];
+		(Columns.template Get<Indices>().Add(Values), ...);
+	}
+
+	TTuple<TArray<Ts>...> Columns;
+};
 
-		// 交换元素
-		Array[i] = Array[Length - 1 - i];
-		Array[Length - 1 - i] = Temp;
+/**
+ * 把数组元素的某个字段收集成连续数组（AoS 转 SoA）
+ * @param Source		源数组
+ * @param Projection	字段或成员函数，例如 &FTransform::GetLocation
+ * @param Out			输出数组
+ */
+template <typename T, typename AllocatorType, typename ProjectionType, typename OutType, typename OutAllocatorType>
+void GatherTArray(const TArray<T, AllocatorType>& Source, ProjectionType Projection, TArray<OutType, OutAllocatorType>& Out)
+{
+	Out.Reset(Source.Num());
+	for (const T& Element : Source)
+	{
+		Out.Add(Invoke(Projection, Element));
+	}
+}
+
+// 把变换数组拆分为位置、旋转、缩放三个连续数组
+template <typename AllocatorType>
+void SplitTransforms(const TArray<FTransform, AllocatorType>& Transforms, TArray<FVector>& OutLocations, TArray<FQuat>& OutRotations, TArray<FVector>& OutScales)
+{
+	const int32 Num = Transforms.Num();
+	OutLocations.SetNumUninitialized(Num);
+	OutRotations.SetNumUninitialized(Num);
+	OutScales.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		OutLocations[i] = Transforms[i].GetLocation();
+		OutRotations[i] = Transforms[i].GetRotation();
+		OutScales[i] = Transforms[i].GetScale3D();
 	}
 }
@@ -10,6 +10,9 @@ public class FogOfWar : ModuleRules
 			new string[]
 			{
 				"Core",
+				"CoreUObject",
+				"Engine",
+				"NetCore",
 				"RenderCore"
 			}
 		);
@@ -17,12 +20,19 @@ public class FogOfWar : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"CoreUObject",
-				"Engine",
+				"RHI",
 				"Slate",
 				"SlateCore",
-				"AssetRegistry"
+				"AssetRegistry",
+				"ToolKits",
+				"ToolKitsShaders"
 			}
 		);
+
+		// 联机PIE自动化测试
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 	}
 }
\ No newline at end of file
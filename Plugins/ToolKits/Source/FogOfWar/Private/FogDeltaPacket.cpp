@@ -0,0 +1,162 @@
+﻿#include "FogDeltaPacket.h"
+
+#include "FogEncoding.h"
+#include "FogGrid.h"
+
+// 单个包允许的最大字节数，防止恶意数据
+static constexpr int32 MaxFogPacketBytes = 64 * 1024;
+
+// 在字节预算内编码待发送的Tile
+bool FFogDeltaPacket::Encode(const FFogGrid& Grid, TBitArray<>& PendingTiles, const int32 ByteBudget, TBitArray<>* OutSentTiles)
+{
+	Data.Reset();
+	if (PendingTiles.Find(true) == INDEX_NONE) return false;
+
+	const int32 TileNum = PendingTiles.Num();
+	TBitArray<> SentTiles(false, TileNum);
+	TArray<uint8> TilePayload;
+
+	// Tile位掩码的字节数随发送的Tile增量计算：已结束的游程 + 当前的 1 游程 + 末尾的 0 游程
+	int32 MaskPrefixBytes = 0;
+	int32 LastSentTile = INDEX_NONE;
+	uint32 SentRun = 0;
+
+	for (TConstSetBitIterator<> It(PendingTiles); It; ++It)
+	{
+		const int32 TileIndex = It.GetIndex();
+		const FIntRect Rect = Grid.GetTileRect(TileIndex);
+		const int32 PayloadStart = TilePayload.Num();
+
+		// Tile内按行展开，相同标记的格子合并为一段
+		uint8 CurrentValue = Grid.GetCell(Rect.Min.X, Rect.Min.Y);
+		uint32 Run = 0;
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+			{
+				const uint8 Value = Grid.GetCell(X, Y);
+				if (Value == CurrentValue)
+				{
+					++Run;
+					continue;
+				}
+				TilePayload.Add(CurrentValue);
+				FogEncoding::WriteVarInt(TilePayload, Run);
+				CurrentValue = Value;
+				Run = 1;
+			}
+		}
+		TilePayload.Add(CurrentValue);
+		FogEncoding::WriteVarInt(TilePayload, Run);
+
+		// 加入本Tile后的位掩码
+		int32 NewPrefixBytes = MaskPrefixBytes;
+		uint32 NewSentRun = 1;
+		if (LastSentTile == INDEX_NONE)
+		{
+			NewPrefixBytes = FogEncoding::VarIntSize(TileIndex);
+		}
+		else if (TileIndex == LastSentTile + 1)
+		{
+			NewSentRun = SentRun + 1;
+		}
+		else
+		{
+			NewPrefixBytes += FogEncoding::VarIntSize(SentRun) + FogEncoding::VarIntSize(TileIndex - LastSentTile - 1);
+		}
+		const int32 TrailingRun = TileNum - TileIndex - 1;
+		const int32 MaskBytes = NewPrefixBytes + FogEncoding::VarIntSize(NewSentRun) + (TrailingRun > 0 ? FogEncoding::VarIntSize(TrailingRun) : 0);
+
+		// 超出预算时回退本Tile，留到下一帧（预算包含序号、位掩码和长度前缀）
+		const int32 DataBytes = MaskBytes + TilePayload.Num();
+		if (static_cast<int32>(sizeof(Sequence)) + FogEncoding::VarIntSize(DataBytes) + DataBytes > ByteBudget && PayloadStart > 0)
+		{
+			TilePayload.SetNum(PayloadStart, false);
+			break;
+		}
+		SentTiles[TileIndex] = true;
+		MaskPrefixBytes = NewPrefixBytes;
+		SentRun = NewSentRun;
+		LastSentTile = TileIndex;
+	}
+
+	FogEncoding::WriteBitRuns(Data, SentTiles);
+	Data.Append(TilePayload);
+
+	for (TConstSetBitIterator<> It(SentTiles); It; ++It)
+	{
+		PendingTiles[It.GetIndex()] = false;
+	}
+	if (OutSentTiles)
+	{
+		*OutSentTiles = MoveTemp(SentTiles);
+	}
+	return true;
+}
+
+// 解码到网格
+bool FFogDeltaPacket::Decode(FFogGrid& Grid) const
+{
+	if (!Grid.IsInitialized()) return false;
+
+	const FIntPoint TileCount = Grid.GetTileCount();
+	TBitArray<> Tiles(false, TileCount.X * TileCount.Y);
+
+	const uint8* Cursor = Data.GetData();
+	const uint8* End = Cursor + Data.Num();
+	if (!FogEncoding::ReadBitRuns(Cursor, End, Tiles)) return false;
+
+	// 先解码到临时数组，数据完整后再写入网格，失败时网格保持不变
+	TArray<uint8> Decoded;
+	for (TConstSetBitIterator<> It(Tiles); It; ++It)
+	{
+		const int32 CellNum = Grid.GetTileRect(It.GetIndex()).Area();
+		const int32 TileStart = Decoded.Num();
+		while (Decoded.Num() - TileStart < CellNum)
+		{
+			uint32 Run = 0;
+			if (Cursor >= End) return false;
+			const uint8 Value = *Cursor++;
+			if (!FogEncoding::ReadVarInt(Cursor, End, Run) || Run > static_cast<uint32>(CellNum - (Decoded.Num() - TileStart))) return false;
+			Decoded.AddUninitialized(Run);
+			FMemory::Memset(Decoded.GetData() + Decoded.Num() - Run, Value, Run);
+		}
+	}
+	if (Cursor != End) return false;
+
+	const uint8* Source = Decoded.GetData();
+	for (TConstSetBitIterator<> It(Tiles); It; ++It)
+	{
+		const FIntRect Rect = Grid.GetTileRect(It.GetIndex());
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			FMemory::Memcpy(&Grid.Cells[Y * Grid.Size.X + Rect.Min.X], Source, Rect.Width());
+			Source += Rect.Width();
+		}
+		Grid.MarkTileDirty(It.GetIndex());
+	}
+	return true;
+}
+
+// 网络序列化
+bool FFogDeltaPacket::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Sequence;
+	uint32 DataSize = Data.Num();
+	Ar.SerializeIntPacked(DataSize);
+
+	if (Ar.IsLoading())
+	{
+		if (DataSize > MaxFogPacketBytes)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Data.SetNumUninitialized(DataSize);
+	}
+
+	Ar.Serialize(Data.GetData(), DataSize);
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
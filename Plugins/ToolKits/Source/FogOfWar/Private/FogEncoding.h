@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+// 迷雾快照和网络增量共用的编码工具
+namespace FogEncoding
+{
+	// 写入变长整数
+	FORCEINLINE void WriteVarInt(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value) | 0x80);
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	// 变长整数的字节数
+	FORCEINLINE int32 VarIntSize(uint32 Value)
+	{
+		int32 Size = 1;
+		while (Value >= 0x80)
+		{
+			++Size;
+			Value >>= 7;
+		}
+		return Size;
+	}
+
+	// 读取变长整数
+	FORCEINLINE bool ReadVarInt(const uint8*& Data, const uint8* End, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 35 && Data < End; Shift += 7)
+		{
+			const uint8 Byte = *Data++;
+			OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0) return true;
+		}
+		return false;
+	}
+
+	// 以 0/1 交替的游程长度编码位数组
+	FORCEINLINE void WriteBitRuns(TArray<uint8>& Out, const TBitArray<>& Bits)
+	{
+		bool bCurrent = false;
+		uint32 Run = 0;
+		for (int32 i = 0; i < Bits.Num(); ++i)
+		{
+			if (Bits[i] == bCurrent)
+			{
+				++Run;
+				continue;
+			}
+			WriteVarInt(Out, Run);
+			bCurrent = Bits[i];
+			Run = 1;
+		}
+		WriteVarInt(Out, Run);
+	}
+
+	// 解码 0/1 交替的游程长度，位数组需要预先设置好大小
+	FORCEINLINE bool ReadBitRuns(const uint8*& Data, const uint8* End, TBitArray<>& OutBits)
+	{
+		const uint32 BitNum = OutBits.Num();
+		bool bCurrent = false;
+		uint32 Index = 0;
+		while (Index < BitNum)
+		{
+			uint32 Run = 0;
+			if (!ReadVarInt(Data, End, Run) || Run > BitNum - Index) return false;
+			if (bCurrent)
+			{
+				OutBits.SetRange(Index, Run, true);
+			}
+			Index += Run;
+			bCurrent = !bCurrent;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,195 @@
+﻿#include "FogGrid.h"
+
+// 初始化网格
+void FFogGrid::Init(const FIntPoint& InSize, const int32 InTileSize)
+{
+	Size = FIntPoint(FMath::Max(InSize.X, 1), FMath::Max(InSize.Y, 1));
+	TileSize = FMath::Max(InTileSize, 1);
+	TileCount = FIntPoint(FMath::DivideAndRoundUp(Size.X, TileSize), FMath::DivideAndRoundUp(Size.Y, TileSize));
+
+	const int32 CellNum = Size.X * Size.Y;
+	const int32 TileNum = TileCount.X * TileCount.Y;
+
+	Cells.Init(EFogCellFlags::None, CellNum);
+	UploadedCells.Init(EFogCellFlags::None, CellNum);
+
+	TouchedTiles.Init(false, TileNum);
+	PrevTouchedTiles.Init(false, TileNum);
+	DirtyTiles.Init(false, TileNum);
+	ChangedTiles.Init(false, TileNum);
+}
+
+// 开始一帧的更新
+void FFogGrid::BeginFrame()
+{
+	// 只清理上一帧照亮过的Tile，未被照亮的区域本来就没有可见标记
+	PrevTouchedTiles = TouchedTiles;
+	TouchedTiles.Init(false, TouchedTiles.Num());
+
+	for (TConstSetBitIterator<> It(PrevTouchedTiles); It; ++It)
+	{
+		const FIntRect Rect = GetTileRect(It.GetIndex());
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			uint8* Row = Cells.GetData() + Y * Size.X;
+			for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+			{
+				Row[X] &= ~EFogCellFlags::Visible;
+			}
+		}
+	}
+}
+
+// 照亮圆形区域
+void FFogGrid::RevealCircle(const FIntPoint& Center, const int32 Radius)
+{
+	if (Radius < 0 || !IsInitialized()) return;
+
+	const int32 MinY = FMath::Max(Center.Y - Radius, 0);
+	const int32 MaxY = FMath::Min(Center.Y + Radius, Size.Y - 1);
+	const int32 RadiusSquared = Radius * Radius;
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		// 当前行的半宽
+		const int32 DeltaY = Y - Center.Y;
+		const int32 HalfWidth = FMath::FloorToInt32(FMath::Sqrt(static_cast<float>(RadiusSquared - DeltaY * DeltaY)));
+		const int32 MinX = FMath::Max(Center.X - HalfWidth, 0);
+		const int32 MaxX = FMath::Min(Center.X + HalfWidth, Size.X - 1);
+		if (MinX > MaxX) continue;
+
+		uint8* Row = Cells.GetData() + Y * Size.X;
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			Row[X] |= EFogCellFlags::Visible | EFogCellFlags::Explored;
+		}
+		TouchSpan(Y, MinX, MaxX);
+	}
+}
+
+// 结束一帧的更新
+void FFogGrid::EndFrame()
+{
+	// 可能发生变化的Tile = 上一帧照亮的 + 本帧照亮的
+	TBitArray<> CandidateTiles = PrevTouchedTiles;
+	CandidateTiles.CombineWithBitwiseOR(TouchedTiles, EBitwiseOperatorFlags::MaxSize);
+
+	for (TConstSetBitIterator<> It(CandidateTiles); It; ++It)
+	{
+		const int32 TileIndex = It.GetIndex();
+		const FIntRect Rect = GetTileRect(TileIndex);
+		const int32 RowBytes = Rect.Width();
+
+		bool bChanged = false;
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			const int32 Offset = Y * Size.X + Rect.Min.X;
+			if (FMemory::Memcmp(Cells.GetData() + Offset, UploadedCells.GetData() + Offset, RowBytes) != 0)
+			{
+				FMemory::Memcpy(UploadedCells.GetData() + Offset, Cells.GetData() + Offset, RowBytes);
+				bChanged = true;
+			}
+		}
+
+		if (bChanged)
+		{
+			DirtyTiles[TileIndex] = true;
+			ChangedTiles[TileIndex] = true;
+		}
+	}
+}
+
+// 标记所有Tile为脏
+void FFogGrid::MarkAllDirty()
+{
+	UploadedCells = Cells;
+	DirtyTiles.Init(true, DirtyTiles.Num());
+	ChangedTiles.Init(true, ChangedTiles.Num());
+}
+
+// 将一段连续格子所在的Tile标记为脏
+void FFogGrid::MarkRangeDirty(const int32 StartIndex, const int32 Count)
+{
+	if (Count <= 0) return;
+
+	FMemory::Memcpy(UploadedCells.GetData() + StartIndex, Cells.GetData() + StartIndex, Count);
+
+	// 按行拆分，逐行标记Tile
+	const int32 EndIndex = StartIndex + Count;
+	for (int32 Index = StartIndex; Index < EndIndex;)
+	{
+		const int32 Y = Index / Size.X;
+		const int32 MinX = Index % Size.X;
+		const int32 MaxX = FMath::Min(Size.X, MinX + EndIndex - Index) - 1;
+
+		const int32 TileY = Y / TileSize;
+		for (int32 TileX = MinX / TileSize; TileX <= MaxX / TileSize; ++TileX)
+		{
+			DirtyTiles[TileY * TileCount.X + TileX] = true;
+			ChangedTiles[TileY * TileCount.X + TileX] = true;
+		}
+		Index += MaxX - MinX + 1;
+	}
+}
+
+// 将单个Tile标记为脏
+void FFogGrid::MarkTileDirty(const int32 TileIndex)
+{
+	const FIntRect Rect = GetTileRect(TileIndex);
+	for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+	{
+		const int32 Offset = Y * Size.X + Rect.Min.X;
+		FMemory::Memcpy(UploadedCells.GetData() + Offset, Cells.GetData() + Offset, Rect.Width());
+	}
+	DirtyTiles[TileIndex] = true;
+	ChangedTiles[TileIndex] = true;
+}
+
+// 取出脏区
+void FFogGrid::ConsumeDirtyRects(TArray<FIntRect>& OutRects)
+{
+	OutRects.Reset();
+
+	for (int32 TileY = 0; TileY < TileCount.Y; ++TileY)
+	{
+		int32 TileX = 0;
+		while (TileX < TileCount.X)
+		{
+			if (!DirtyTiles[TileY * TileCount.X + TileX])
+			{
+				++TileX;
+				continue;
+			}
+
+			// 合并同一行连续的脏Tile
+			const int32 StartTileX = TileX;
+			while (TileX < TileCount.X && DirtyTiles[TileY * TileCount.X + TileX])
+			{
+				DirtyTiles[TileY * TileCount.X + TileX] = false;
+				++TileX;
+			}
+
+			const FIntRect StartRect = GetTileRect(TileY * TileCount.X + StartTileX);
+			const FIntRect EndRect = GetTileRect(TileY * TileCount.X + TileX - 1);
+			OutRects.Add(FIntRect(StartRect.Min, EndRect.Max));
+		}
+	}
+}
+
+// 标记格子范围所在的Tile被访问
+void FFogGrid::TouchSpan(const int32 Y, const int32 MinX, const int32 MaxX)
+{
+	const int32 TileY = Y / TileSize;
+	for (int32 TileX = MinX / TileSize; TileX <= MaxX / TileSize; ++TileX)
+	{
+		TouchedTiles[TileY * TileCount.X + TileX] = true;
+	}
+}
+
+// 获取Tile对应的格子矩形
+FIntRect FFogGrid::GetTileRect(const int32 TileIndex) const
+{
+	const FIntPoint Min((TileIndex % TileCount.X) * TileSize, (TileIndex / TileCount.X) * TileSize);
+	const FIntPoint Max(FMath::Min(Min.X + TileSize, Size.X), FMath::Min(Min.Y + TileSize, Size.Y));
+	return FIntRect(Min, Max);
+}
@@ -0,0 +1,655 @@
+﻿#include "FogOfWarSubsystem.h"
+
+#include "FogDeltaPacket.h"
+#include "FogReplicationComponent.h"
+#include "FogRevealPass.h"
+#include "FogSnapshot.h"
+#include "FogVisibilityComponent.h"
+#include "ToolKitsStats.h"
+#include "YC_Log.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Kismet/KismetRenderingLibrary.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "TextureResource.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// 每个迷雾像素的字节数（R8G8）
+static constexpr int32 FogTexelBytes = 2;
+
+// 混合结果与当前迷雾的差距小于一个 8 位色阶时视为收敛
+static const float FogBlendSettleFactor = FMath::Loge(255.f);
+
+void UFogOfWarSubsystem::Deinitialize()
+{
+	VisionSources.Empty();
+	RemoteTeamGrids.Empty();
+	ReplicationComponents.Empty();
+	NewVisibilityComponents.Empty();
+	MovableVisibilityComponents.Empty();
+	StaticVisibilityComponents.Empty();
+	FogRenderTarget = nullptr;
+	BlendMID = nullptr;
+	BlendTargets[0] = BlendTargets[1] = nullptr;
+	Super::Deinitialize();
+}
+
+void UFogOfWarSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!Grid.IsInitialized()) return;
+
+	if (IsUsingGPUReveal())
+	{
+		DispatchGPUReveal();
+	}
+	else
+	{
+		if (!bReceivesReplicatedFog)
+		{
+			UpdateGrid();
+		}
+		UpdateVisibilityComponents();
+		DistributeChangedTiles();
+		UploadDirtyRegions();
+	}
+	DrawTemporalBlend(DeltaTime);
+}
+
+TStatId UFogOfWarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFogOfWarSubsystem, STATGROUP_Tickables);
+}
+
+// 初始化迷雾
+void UFogOfWarSubsystem::InitFog(FVector2D Origin, float CellSize, FIntPoint GridSize, UTextureRenderTarget2D* RenderTarget, UMaterialInterface* BlendMaterial)
+{
+	if (RenderTarget == nullptr || CellSize <= 0.f || GridSize.X <= 0 || GridSize.Y <= 0)
+	{
+		YICHEN_CLOG(Fog, Error, "迷雾初始化失败，参数无效");
+		return;
+	}
+
+	FogOrigin = Origin;
+	FogCellSize = CellSize;
+	Grid.Init(GridSize);
+	for (TPair<uint8, FFogGrid>& TeamGrid : RemoteTeamGrids)
+	{
+		TeamGrid.Value.Init(GridSize);
+	}
+	DeltaBaseline.Empty();
+
+	// 渲染目标与网格一一对应，避免上传时做缩放
+	FogRenderTarget = RenderTarget;
+	FogRenderTarget->ClearColor = FLinearColor::Black;
+	// GPU照亮需要以UAV写入
+	FogRenderTarget->bCanCreateUAV = true;
+	FogRenderTarget->InitCustomFormat(GridSize.X, GridSize.Y, PF_R8G8, true);
+	FogRenderTarget->UpdateResourceImmediate(true);
+
+	// 首次提交完整网格，之后只提交脏区
+	Grid.MarkAllDirty();
+
+	BlendMID = nullptr;
+	BlendTargets[0] = BlendTargets[1] = nullptr;
+	if (BlendMaterial)
+	{
+		BlendMID = UMaterialInstanceDynamic::Create(BlendMaterial, this);
+		BlendMID->SetScalarParameterValue(TEXT("RevealSpeed"), FogRevealSpeed);
+		BlendMID->SetScalarParameterValue(TEXT("HideSpeed"), FogHideSpeed);
+		BlendTargets[0] = CreateBlendTarget();
+		BlendTargets[1] = CreateBlendTarget();
+		RestartTemporalBlend();
+	}
+}
+
+// 注册视野源
+void UFogOfWarSubsystem::RegisterVisionSource(AActor* Actor, float Radius, uint8 Team)
+{
+	if (Actor == nullptr) return;
+
+	for (FFogVisionSource& Source : VisionSources)
+	{
+		if (Source.Actor == Actor)
+		{
+			Source.Radius = Radius;
+			Source.Team = Team;
+			return;
+		}
+	}
+
+	FFogVisionSource& NewSource = VisionSources.AddDefaulted_GetRef();
+	NewSource.Actor = Actor;
+	NewSource.Radius = Radius;
+	NewSource.Team = Team;
+}
+
+// 注销视野源
+void UFogOfWarSubsystem::UnregisterVisionSource(AActor* Actor)
+{
+	VisionSources.RemoveAllSwap([Actor](const FFogVisionSource& Source) { return Source.Actor == Actor; });
+}
+
+// 设置时间混合的速度
+void UFogOfWarSubsystem::SetFogBlendSpeed(float RevealSpeed, float HideSpeed)
+{
+	FogRevealSpeed = FMath::Max(RevealSpeed, KINDA_SMALL_NUMBER);
+	FogHideSpeed = FMath::Max(HideSpeed, KINDA_SMALL_NUMBER);
+	if (BlendMID)
+	{
+		BlendMID->SetScalarParameterValue(TEXT("RevealSpeed"), FogRevealSpeed);
+		BlendMID->SetScalarParameterValue(TEXT("HideSpeed"), FogHideSpeed);
+		RestartTemporalBlend();
+	}
+}
+
+// 切换到GPU照亮
+void UFogOfWarSubsystem::SetGPURevealEnabled(bool bEnable, float EdgeWidth)
+{
+	const bool bWasUsingGPU = IsUsingGPUReveal();
+
+	// CPU网格不再更新后，网络同步和可见性组件会读到过期的数据
+	const bool bHasVisibilityComponents = !NewVisibilityComponents.IsEmpty() || !MovableVisibilityComponents.IsEmpty() || !StaticVisibilityComponents.IsEmpty();
+	if (bEnable && (bReceivesReplicatedFog || !ReplicationComponents.IsEmpty() || bHasVisibilityComponents))
+	{
+		YICHEN_CLOG(Fog, Warning, "已有网络同步或可见性组件依赖CPU网格，不能开启GPU照亮");
+		return;
+	}
+
+	bGPUReveal = bEnable;
+	GPUEdgeWidth = EdgeWidth;
+
+	if (bEnable && !FogOfWar::CanUseGPUReveal())
+	{
+		YICHEN_CLOG(Fog, Warning, "当前RHI不支持迷雾Compute Shader，使用CPU网格");
+	}
+
+	// 从GPU切回CPU时渲染目标已被Compute Shader改写，需要完整提交一次网格
+	if (bWasUsingGPU && !IsUsingGPUReveal() && Grid.IsInitialized())
+	{
+		Grid.MarkAllDirty();
+	}
+}
+
+// 当前是否使用GPU照亮
+bool UFogOfWarSubsystem::IsUsingGPUReveal() const
+{
+	return bGPUReveal && FogRenderTarget != nullptr && FogOfWar::CanUseGPUReveal();
+}
+
+// 保存已探索区域快照
+TArray<uint8> UFogOfWarSubsystem::SaveFogSnapshot() const
+{
+	TArray<uint8> SnapshotData;
+	if (!Grid.IsInitialized() || RejectInGPUReveal(TEXT("SaveFogSnapshot"))) return SnapshotData;
+
+	FFogSnapshot Snapshot;
+	Snapshot.Encode(Grid);
+	FMemoryWriter Writer(SnapshotData);
+	Writer << Snapshot;
+	return SnapshotData;
+}
+
+// 从快照恢复已探索区域
+bool UFogOfWarSubsystem::LoadFogSnapshot(const TArray<uint8>& SnapshotData)
+{
+	if (!Grid.IsInitialized() || RejectInGPUReveal(TEXT("LoadFogSnapshot"))) return false;
+
+	FFogSnapshot Snapshot;
+	FMemoryReader Reader(SnapshotData);
+	Reader << Snapshot;
+	if (Reader.IsError() || !Snapshot.Decode(Grid))
+	{
+		YICHEN_CLOG(Fog, Error, "迷雾快照无效");
+		return false;
+	}
+	return true;
+}
+
+// 保存已探索区域快照到文件
+bool UFogOfWarSubsystem::SaveFogSnapshotToFile(const FString& FilePath) const
+{
+	if (!Grid.IsInitialized() || RejectInGPUReveal(TEXT("SaveFogSnapshotToFile"))) return false;
+
+	FFogSnapshot Snapshot;
+	Snapshot.Encode(Grid);
+	return Snapshot.SaveToFile(FilePath);
+}
+
+// 从文件恢复已探索区域
+bool UFogOfWarSubsystem::LoadFogSnapshotFromFile(const FString& FilePath)
+{
+	if (!Grid.IsInitialized() || RejectInGPUReveal(TEXT("LoadFogSnapshotFromFile"))) return false;
+
+	if (!FFogSnapshot::LoadFromFile(FilePath, Grid))
+	{
+		YICHEN_CLOG(Fog, Error, "迷雾快照文件无效: %s", *FilePath);
+		return false;
+	}
+	return true;
+}
+
+// 生成逐帧增量
+TArray<uint8> UFogOfWarSubsystem::MakeFogDelta()
+{
+	TArray<uint8> DeltaData;
+	if (Grid.IsInitialized() && !RejectInGPUReveal(TEXT("MakeFogDelta")))
+	{
+		FFogSnapshot::EncodeDelta(Grid, DeltaBaseline, DeltaData);
+	}
+	return DeltaData;
+}
+
+// 应用逐帧增量
+bool UFogOfWarSubsystem::ApplyFogDelta(const TArray<uint8>& DeltaData)
+{
+	return Grid.IsInitialized() && !RejectInGPUReveal(TEXT("ApplyFogDelta")) && FFogSnapshot::ApplyDelta(Grid, DeltaData);
+}
+
+// 设置本地显示的队伍
+void UFogOfWarSubsystem::SetLocalTeam(uint8 Team)
+{
+	if (Team == LocalTeam) return;
+
+	// 交换本地网格与队伍网格，显示需要完整提交一次
+	FFogGrid OldGrid = MoveTemp(Grid);
+	if (FFogGrid* TeamGrid = RemoteTeamGrids.Find(Team))
+	{
+		Grid = MoveTemp(*TeamGrid);
+		RemoteTeamGrids.Remove(Team);
+	}
+	else
+	{
+		Grid.Init(OldGrid.GetSize());
+	}
+
+	if (OldGrid.IsInitialized())
+	{
+		RemoteTeamGrids.Add(LocalTeam, MoveTemp(OldGrid));
+	}
+	LocalTeam = Team;
+	DeltaBaseline.Empty();
+	if (Grid.IsInitialized())
+	{
+		Grid.MarkAllDirty();
+	}
+}
+
+// 注册网络同步组件
+void UFogOfWarSubsystem::RegisterReplicationComponent(UFogReplicationComponent* Component)
+{
+	if (Component == nullptr || RejectInGPUReveal(TEXT("UFogReplicationComponent"))) return;
+
+	ReplicationComponents.AddUnique(Component);
+	GetOrAddTeamGrid(Component->GetTeam());
+}
+
+// 注销网络同步组件
+void UFogOfWarSubsystem::UnregisterReplicationComponent(UFogReplicationComponent* Component)
+{
+	ReplicationComponents.Remove(Component);
+}
+
+// 注册迷雾可见性组件
+void UFogOfWarSubsystem::RegisterVisibilityComponent(UFogVisibilityComponent* Component)
+{
+	if (Component == nullptr || RejectInGPUReveal(TEXT("UFogVisibilityComponent"))) return;
+	// 下一帧统一做首次检查
+	NewVisibilityComponents.AddUnique(Component);
+}
+
+// 注销迷雾可见性组件
+void UFogOfWarSubsystem::UnregisterVisibilityComponent(UFogVisibilityComponent* Component)
+{
+	if (Component == nullptr) return;
+
+	NewVisibilityComponents.RemoveSwap(Component);
+	MovableVisibilityComponents.RemoveSwap(Component);
+	if (TArray<TWeakObjectPtr<UFogVisibilityComponent>>* Bucket = StaticVisibilityComponents.Find(Component->FogTileIndex))
+	{
+		Bucket->RemoveSwap(Component);
+	}
+	Component->FogTileIndex = INDEX_NONE;
+}
+
+// 应用服务器发来的增量
+bool UFogOfWarSubsystem::ApplyReplicatedDelta(const FFogDeltaPacket& Packet)
+{
+	if (RejectInGPUReveal(TEXT("ApplyReplicatedDelta"))) return false;
+	bReceivesReplicatedFog = true;
+	return Packet.Decode(Grid);
+}
+
+// 获取队伍的迷雾网格
+const FFogGrid* UFogOfWarSubsystem::FindTeamGrid(uint8 Team) const
+{
+	return Team == LocalTeam ? &Grid : RemoteTeamGrids.Find(Team);
+}
+
+// 获取或创建队伍的迷雾网格
+FFogGrid& UFogOfWarSubsystem::GetOrAddTeamGrid(uint8 Team)
+{
+	if (Team == LocalTeam) return Grid;
+
+	FFogGrid& TeamGrid = RemoteTeamGrids.FindOrAdd(Team);
+	if (!TeamGrid.IsInitialized() && Grid.IsInitialized())
+	{
+		TeamGrid.Init(Grid.GetSize());
+	}
+	return TeamGrid;
+}
+
+// 把各队伍变化的Tile分发给网络同步组件
+void UFogOfWarSubsystem::DistributeChangedTiles()
+{
+	for (int32 i = ReplicationComponents.Num() - 1; i >= 0; --i)
+	{
+		UFogReplicationComponent* Component = ReplicationComponents[i].Get();
+		if (Component == nullptr)
+		{
+			ReplicationComponents.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (const FFogGrid* TeamGrid = FindTeamGrid(Component->GetTeam()))
+		{
+			Component->AccumulatePendingTiles(TeamGrid->GetChangedTiles());
+		}
+	}
+
+	Grid.ResetChangedTiles();
+	for (TPair<uint8, FFogGrid>& TeamGrid : RemoteTeamGrids)
+	{
+		TeamGrid.Value.ResetChangedTiles();
+	}
+}
+
+// 检查可见性组件
+void UFogOfWarSubsystem::UpdateVisibilityComponents()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFogOfWarSubsystem::UpdateVisibilityComponents);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FogVisibility);
+
+	VisibilityChanges.Reset();
+
+	auto CheckComponent = [this](UFogVisibilityComponent* Component)
+	{
+		if (EvaluateFogVisibility(Component) != Component->IsVisibleInFog())
+		{
+			VisibilityChanges.Add(Component);
+		}
+	};
+
+	// 新注册的组件：首次检查，并按是否移动分组
+	for (const TWeakObjectPtr<UFogVisibilityComponent>& WeakComponent : NewVisibilityComponents)
+	{
+		UFogVisibilityComponent* Component = WeakComponent.Get();
+		if (Component == nullptr || Component->GetOwner() == nullptr) continue;
+
+		if (Component->bMovable)
+		{
+			MovableVisibilityComponents.Add(Component);
+		}
+		else
+		{
+			const FIntPoint Cell = WorldToCell(Component->GetOwner()->GetActorLocation());
+			if (Grid.IsValidCell(Cell.X, Cell.Y))
+			{
+				const int32 TileSize = Grid.GetTileSize();
+				Component->FogTileIndex = (Cell.Y / TileSize) * Grid.GetTileCount().X + Cell.X / TileSize;
+				StaticVisibilityComponents.FindOrAdd(Component->FogTileIndex).Add(Component);
+			}
+		}
+		CheckComponent(Component);
+	}
+	NewVisibilityComponents.Reset();
+
+	// 可移动的组件：每帧只做一次格子查询
+	for (int32 i = MovableVisibilityComponents.Num() - 1; i >= 0; --i)
+	{
+		UFogVisibilityComponent* Component = MovableVisibilityComponents[i].Get();
+		if (Component == nullptr)
+		{
+			MovableVisibilityComponents.RemoveAtSwap(i);
+			continue;
+		}
+		CheckComponent(Component);
+	}
+
+	// 静态的组件：只检查内容发生变化的Tile
+	if (!StaticVisibilityComponents.IsEmpty())
+	{
+		for (TConstSetBitIterator<> It(Grid.GetChangedTiles()); It; ++It)
+		{
+			TArray<TWeakObjectPtr<UFogVisibilityComponent>>* Bucket = StaticVisibilityComponents.Find(It.GetIndex());
+			if (Bucket == nullptr) continue;
+
+			for (int32 i = Bucket->Num() - 1; i >= 0; --i)
+			{
+				UFogVisibilityComponent* Component = (*Bucket)[i].Get();
+				if (Component == nullptr)
+				{
+					Bucket->RemoveAtSwap(i);
+					continue;
+				}
+				CheckComponent(Component);
+			}
+		}
+	}
+
+	// 统一应用本帧翻转的组件
+	for (UFogVisibilityComponent* Component : VisibilityChanges)
+	{
+		Component->ApplyFogVisibility(!Component->IsVisibleInFog());
+	}
+}
+
+// 计算组件所在格子是否可见
+bool UFogOfWarSubsystem::EvaluateFogVisibility(const UFogVisibilityComponent* Component) const
+{
+	const AActor* Owner = Component->GetOwner();
+	if (Owner == nullptr || !Grid.IsInitialized()) return true;
+
+	// 迷雾范围外的Actor不受影响
+	const FIntPoint Cell = WorldToCell(Owner->GetActorLocation());
+	if (!Grid.IsValidCell(Cell.X, Cell.Y)) return true;
+
+	const uint8 Flag = Component->Rule == EFogVisibilityRule::Visible ? EFogCellFlags::Visible : EFogCellFlags::Explored;
+	return (Grid.GetCell(Cell.X, Cell.Y) & Flag) != 0;
+}
+
+// 获取显示用的迷雾纹理
+UTexture* UFogOfWarSubsystem::GetFogTexture() const
+{
+	if (BlendMID && BlendTargets[BlendIndex])
+	{
+		return BlendTargets[BlendIndex];
+	}
+	return FogRenderTarget;
+}
+
+// 世界坐标转格子坐标
+FIntPoint UFogOfWarSubsystem::WorldToCell(const FVector& WorldLocation) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32((WorldLocation.X - FogOrigin.X) / FogCellSize),
+		FMath::FloorToInt32((WorldLocation.Y - FogOrigin.Y) / FogCellSize));
+}
+
+// 更新网格
+void UFogOfWarSubsystem::UpdateGrid()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFogOfWarSubsystem::UpdateGrid);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FogUpdate);
+
+	Grid.BeginFrame();
+	for (TPair<uint8, FFogGrid>& TeamGrid : RemoteTeamGrids)
+	{
+		TeamGrid.Value.BeginFrame();
+	}
+
+	for (int32 i = VisionSources.Num() - 1; i >= 0; --i)
+	{
+		const AActor* Actor = VisionSources[i].Actor.Get();
+		if (Actor == nullptr)
+		{
+			// 视野源已被销毁
+			VisionSources.RemoveAtSwap(i);
+			continue;
+		}
+
+		const int32 RadiusCells = FMath::CeilToInt32(VisionSources[i].Radius / FogCellSize);
+		GetOrAddTeamGrid(VisionSources[i].Team).RevealCircle(WorldToCell(Actor->GetActorLocation()), RadiusCells);
+	}
+
+	Grid.EndFrame();
+	for (TPair<uint8, FFogGrid>& TeamGrid : RemoteTeamGrids)
+	{
+		TeamGrid.Value.EndFrame();
+	}
+}
+
+// 将脏区上传到渲染目标
+void UFogOfWarSubsystem::UploadDirtyRegions()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFogOfWarSubsystem::UploadDirtyRegions);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FogUpload);
+
+	Grid.ConsumeDirtyRects(DirtyRects);
+	if (DirtyRects.IsEmpty() || FogRenderTarget == nullptr) return;
+
+	RestartTemporalBlend();
+
+	FTextureRenderTargetResource* Resource = FogRenderTarget->GameThread_GetRenderTargetResource();
+	if (Resource == nullptr) return;
+
+	// 计算打包后的数据大小
+	int32 TotalBytes = 0;
+	for (const FIntRect& Rect : DirtyRects)
+	{
+		TotalBytes += Rect.Area() * FogTexelBytes;
+	}
+	INC_DWORD_STAT_BY(STAT_ToolKits_FogCellsUpdated, TotalBytes / FogTexelBytes);
+
+	// 将脏区的格子打包成 R8G8 像素，R=可见，G=已探索
+	TArray<uint8> UploadData;
+	UploadData.SetNumUninitialized(TotalBytes);
+	uint8* Dest = UploadData.GetData();
+	for (const FIntRect& Rect : DirtyRects)
+	{
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+			{
+				const uint8 Cell = Grid.GetCell(X, Y);
+				*Dest++ = (Cell & EFogCellFlags::Visible) ? 255 : 0;
+				*Dest++ = (Cell & EFogCellFlags::Explored) ? 255 : 0;
+			}
+		}
+	}
+
+	ENQUEUE_RENDER_COMMAND(FogOfWarUploadRegions)(
+		[Resource, Rects = DirtyRects, UploadData = MoveTemp(UploadData)](FRHICommandListImmediate& RHICmdList)
+		{
+			FRHITexture* Texture = Resource->GetRenderTargetTexture();
+			if (Texture == nullptr) return;
+
+			const uint8* Source = UploadData.GetData();
+			for (const FIntRect& Rect : Rects)
+			{
+				const FUpdateTextureRegion2D Region(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+				RHICmdList.UpdateTexture2D(Texture, 0, Region, Rect.Width() * FogTexelBytes, Source);
+				Source += Rect.Area() * FogTexelBytes;
+			}
+		});
+}
+
+// 在渲染线程执行GPU照亮
+void UFogOfWarSubsystem::DispatchGPUReveal()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFogOfWarSubsystem::DispatchGPUReveal);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_FogUpdate);
+
+	FTextureRenderTargetResource* Resource = FogRenderTarget->GameThread_GetRenderTargetResource();
+	if (Resource == nullptr) return;
+
+	// 视野源转换到格子空间
+	TArray<FVector4f> Sources;
+	Sources.Reserve(VisionSources.Num());
+	for (int32 i = VisionSources.Num() - 1; i >= 0; --i)
+	{
+		const AActor* Actor = VisionSources[i].Actor.Get();
+		if (Actor == nullptr)
+		{
+			// 视野源已被销毁
+			VisionSources.RemoveAtSwap(i);
+			continue;
+		}
+		// GPU照亮只处理本地队伍
+		if (VisionSources[i].Team != LocalTeam) continue;
+
+		const FVector Location = Actor->GetActorLocation();
+		Sources.Emplace(
+			(Location.X - FogOrigin.X) / FogCellSize,
+			(Location.Y - FogOrigin.Y) / FogCellSize,
+			VisionSources[i].Radius / FogCellSize,
+			0.f);
+	}
+
+	// Compute Shader 每帧都会改写渲染目标
+	RestartTemporalBlend();
+
+	ENQUEUE_RENDER_COMMAND(FogOfWarGPUReveal)(
+		[Resource, Sources = MoveTemp(Sources), GridSize = Grid.GetSize(), EdgeWidth = GPUEdgeWidth](FRHICommandListImmediate& RHICmdList)
+		{
+			FogOfWar::AddFogRevealPass(RHICmdList, Resource->GetRenderTargetTexture(), Sources, GridSize, EdgeWidth);
+		});
+}
+
+// 绘制时间混合
+void UFogOfWarSubsystem::DrawTemporalBlend(float DeltaTime)
+{
+	if (BlendMID == nullptr || BlendTargets[0] == nullptr || BlendTargets[1] == nullptr) return;
+
+	// 没有格子变化且已经收敛时不需要重绘
+	if (BlendRemainingTime <= 0.f) return;
+	BlendRemainingTime -= DeltaTime;
+
+	// 最后一次混合直接对齐到当前迷雾，避免停在相差一个色阶的位置
+	const float BlendDeltaTime = BlendRemainingTime > 0.f ? DeltaTime : 1.f / FMath::Min(FogRevealSpeed, FogHideSpeed);
+
+	// 上一帧的混合结果作为历史，写入另一张渲染目标
+	const int32 HistoryIndex = BlendIndex;
+	BlendIndex = 1 - BlendIndex;
+
+	BlendMID->SetTextureParameterValue(TEXT("FogCurrent"), FogRenderTarget);
+	BlendMID->SetTextureParameterValue(TEXT("FogHistory"), BlendTargets[HistoryIndex]);
+	BlendMID->SetScalarParameterValue(TEXT("DeltaTime"), BlendDeltaTime);
+	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, BlendTargets[BlendIndex], BlendMID);
+}
+
+// 创建混合用的渲染目标
+UTextureRenderTarget2D* UFogOfWarSubsystem::CreateBlendTarget()
+{
+	const FIntPoint Size = Grid.GetSize();
+	return UKismetRenderingLibrary::CreateRenderTarget2D(this, Size.X, Size.Y, RTF_RG8, FLinearColor::Black);
+}
+
+// 迷雾渲染目标发生变化，重新开始混合
+void UFogOfWarSubsystem::RestartTemporalBlend()
+{
+	BlendRemainingTime = FogBlendSettleFactor / FMath::Min(FogRevealSpeed, FogHideSpeed);
+}
+
+// 使用GPU照亮时拒绝依赖CPU网格的功能
+bool UFogOfWarSubsystem::RejectInGPUReveal(const TCHAR* Feature) const
+{
+	if (!IsUsingGPUReveal()) return false;
+
+	YICHEN_CLOG(Fog, Warning, "GPU照亮不更新CPU网格，%s 不可用", Feature);
+	return true;
+}
@@ -0,0 +1,190 @@
+﻿#include "FogReplicationComponent.h"
+
+#include "FogOfWarSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+UFogReplicationComponent::UFogReplicationComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+	SetIsReplicatedByDefault(true);
+}
+
+void UFogReplicationComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>();
+	if (FogSubsystem == nullptr) return;
+
+	// 本地玩家直接显示自己队伍的网格，不需要走网络
+	if (IsLocalOwner())
+	{
+		FogSubsystem->SetLocalTeam(Team);
+	}
+
+	if (ShouldSendToOwner())
+	{
+		FogSubsystem->RegisterReplicationComponent(this);
+		// 首次同步发送完整网格
+		const FFogGrid* TeamGrid = FogSubsystem->FindTeamGrid(Team);
+		if (TeamGrid && TeamGrid->IsInitialized())
+		{
+			ResendAllTiles(TeamGrid->GetTileCount().X * TeamGrid->GetTileCount().Y);
+		}
+	}
+	else
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UFogReplicationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>())
+	{
+		FogSubsystem->UnregisterReplicationComponent(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UFogReplicationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// 统计每秒发送的字节数
+	WindowTime += DeltaTime;
+	if (WindowTime >= 1.f)
+	{
+		BytesPerSecond = WindowBytes / WindowTime;
+		WindowBytes = 0;
+		WindowTime = 0.f;
+	}
+
+	const UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>();
+	const FFogGrid* TeamGrid = FogSubsystem ? FogSubsystem->FindTeamGrid(Team) : nullptr;
+	if (TeamGrid == nullptr || !TeamGrid->IsInitialized() || PendingTiles.IsEmpty()) return;
+
+	// 关键帧：上个关键帧之前发出、至今未确认的包视为丢失，重发其中的Tile
+	KeyframeTime += DeltaTime;
+	if (KeyframeInterval > 0.f && KeyframeTime >= KeyframeInterval)
+	{
+		KeyframeTime = 0.f;
+		for (auto It = InFlightDeltas.CreateIterator(); It; ++It)
+		{
+			if (It.Value().Keyframe == KeyframeCount) continue;
+			if (It.Value().Tiles.Num() == PendingTiles.Num())
+			{
+				PendingTiles.CombineWithBitwiseOR(It.Value().Tiles, EBitwiseOperatorFlags::MaintainSize);
+			}
+			It.RemoveCurrent();
+		}
+		++KeyframeCount;
+	}
+
+	TBitArray<> SentTiles;
+	OutgoingPacket.Sequence = NextSequence;
+	if (OutgoingPacket.Encode(*TeamGrid, PendingTiles, BytesPerFrame, &SentTiles))
+	{
+		++NextSequence;
+		WindowBytes += OutgoingPacket.Data.Num();
+		if (KeyframeInterval > 0.f)
+		{
+			InFlightDeltas.Add(OutgoingPacket.Sequence, {MoveTemp(SentTiles), KeyframeCount});
+		}
+		ClientReceiveFogDelta(OutgoingPacket);
+	}
+}
+
+void UFogReplicationComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UFogReplicationComponent, Team);
+}
+
+// 设置队伍
+void UFogReplicationComponent::SetTeam(uint8 NewTeam)
+{
+	if (NewTeam == Team) return;
+	Team = NewTeam;
+
+	UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>();
+	if (FogSubsystem == nullptr) return;
+
+	if (IsLocalOwner())
+	{
+		FogSubsystem->SetLocalTeam(Team);
+	}
+
+	if (ShouldSendToOwner())
+	{
+		// 确保新队伍的网格存在，并重新发送完整网格
+		FogSubsystem->RegisterReplicationComponent(this);
+		if (const FFogGrid* TeamGrid = FogSubsystem->FindTeamGrid(Team))
+		{
+			ResendAllTiles(TeamGrid->GetTileCount().X * TeamGrid->GetTileCount().Y);
+		}
+	}
+}
+
+// 累积待发送的Tile
+void UFogReplicationComponent::AccumulatePendingTiles(const TBitArray<>& ChangedTiles)
+{
+	if (PendingTiles.Num() != ChangedTiles.Num())
+	{
+		// 网格重建过，重新发送完整网格
+		ResendAllTiles(ChangedTiles.Num());
+		return;
+	}
+	PendingTiles.CombineWithBitwiseOR(ChangedTiles, EBitwiseOperatorFlags::MaintainSize);
+}
+
+// 客户端收到队伍
+void UFogReplicationComponent::OnRep_Team()
+{
+	UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>();
+	if (FogSubsystem && IsLocalOwner())
+	{
+		// 服务器切换队伍后会重新发送完整网格
+		FogSubsystem->SetLocalTeam(Team);
+	}
+}
+
+// 接收迷雾增量
+void UFogReplicationComponent::ClientReceiveFogDelta_Implementation(const FFogDeltaPacket& Packet)
+{
+	UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>();
+	if (FogSubsystem && FogSubsystem->ApplyReplicatedDelta(Packet))
+	{
+		ServerAckFogDelta(Packet.Sequence);
+	}
+}
+
+// 确认收到增量
+void UFogReplicationComponent::ServerAckFogDelta_Implementation(uint16 Sequence)
+{
+	InFlightDeltas.Remove(Sequence);
+}
+
+// 重新发送完整网格
+void UFogReplicationComponent::ResendAllTiles(int32 TileNum)
+{
+	PendingTiles.Init(true, TileNum);
+	InFlightDeltas.Reset();
+}
+
+// 是否需要向拥有者发送
+bool UFogReplicationComponent::ShouldSendToOwner() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	return PlayerController && PlayerController->HasAuthority() && !PlayerController->IsLocalController();
+}
+
+// 是否为本地玩家
+bool UFogReplicationComponent::IsLocalOwner() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	return PlayerController && PlayerController->IsLocalController();
+}
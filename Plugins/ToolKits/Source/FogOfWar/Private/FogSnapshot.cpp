@@ -0,0 +1,303 @@
+﻿#include "FogSnapshot.h"
+
+#include "FogEncoding.h"
+#include "FogGrid.h"
+#include "YC_Log.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/Archive.h"
+
+// 从网格编码快照
+void FFogSnapshot::Encode(const FFogGrid& Grid)
+{
+	Size = Grid.GetSize();
+	Payload.Reset();
+
+	const uint8* Cells = Grid.Cells.GetData();
+	const int32 CellNum = Grid.Cells.Num();
+
+	// 游程从“未探索”开始，0/1交替
+	bool bCurrent = false;
+	uint32 Run = 0;
+	for (int32 i = 0; i < CellNum; ++i)
+	{
+		const bool bExplored = (Cells[i] & EFogCellFlags::Explored) != 0;
+		if (bExplored == bCurrent)
+		{
+			++Run;
+			continue;
+		}
+		FogEncoding::WriteVarInt(Payload, Run);
+		bCurrent = bExplored;
+		Run = 1;
+	}
+	FogEncoding::WriteVarInt(Payload, Run);
+}
+
+// 把快照解码回网格
+bool FFogSnapshot::Decode(FFogGrid& Grid) const
+{
+	if (Grid.GetSize() != Size) return false;
+	return DecodePayload(Grid, Payload.GetData(), Payload.Num());
+}
+
+// 从RLE数据解码
+bool FFogSnapshot::DecodePayload(FFogGrid& Grid, const uint8* Data, const int64 DataSize)
+{
+	const uint32 CellNum = Grid.Cells.Num();
+	const uint8* End = Data + DataSize;
+
+	// 先解码到临时位平面，数据完整时才写入网格，损坏的数据不会留下一半的结果
+	TBitArray<> Explored(false, CellNum);
+	bool bExplored = false;
+	uint32 Index = 0;
+	while (Data < End)
+	{
+		uint32 Run = 0;
+		if (!FogEncoding::ReadVarInt(Data, End, Run) || Run > CellNum - Index) return false;
+
+		if (bExplored)
+		{
+			Explored.SetRange(Index, Run, true);
+		}
+		Index += Run;
+		bExplored = !bExplored;
+	}
+	if (Index != CellNum) return false;
+
+	uint8* Cells = Grid.Cells.GetData();
+	for (uint32 i = 0; i < CellNum; ++i)
+	{
+		Cells[i] = static_cast<uint8>(Explored[i] ? (Cells[i] | EFogCellFlags::Explored) : (Cells[i] & ~EFogCellFlags::Explored));
+	}
+	Grid.MarkAllDirty();
+	return true;
+}
+
+// 编码相对基准的增量
+void FFogSnapshot::EncodeDelta(const FFogGrid& Grid, TBitArray<>& Baseline, TArray<uint8>& OutDelta)
+{
+	OutDelta.Reset();
+
+	const uint8* Cells = Grid.Cells.GetData();
+	const int32 CellNum = Grid.Cells.Num();
+	if (Baseline.Num() != CellNum)
+	{
+		Baseline.Init(false, CellNum);
+	}
+
+	// 游程从“未变化”开始，0/1交替
+	bool bCurrent = false;
+	uint32 Run = 0;
+	for (int32 i = 0; i < CellNum; ++i)
+	{
+		const bool bExplored = (Cells[i] & EFogCellFlags::Explored) != 0;
+		const bool bChanged = bExplored != Baseline[i];
+		if (bChanged)
+		{
+			Baseline[i] = bExplored;
+		}
+
+		if (bChanged == bCurrent)
+		{
+			++Run;
+			continue;
+		}
+		FogEncoding::WriteVarInt(OutDelta, Run);
+		bCurrent = bChanged;
+		Run = 1;
+	}
+	FogEncoding::WriteVarInt(OutDelta, Run);
+}
+
+// 把增量应用到网格
+bool FFogSnapshot::ApplyDelta(FFogGrid& Grid, TConstArrayView<uint8> Delta)
+{
+	const uint32 CellNum = Grid.Cells.Num();
+	const uint8* Data = Delta.GetData();
+	const uint8* End = Data + Delta.Num();
+
+	// 先解析出所有翻转的区间，数据完整时才写入网格
+	TArray<TPair<uint32, uint32>, TInlineAllocator<64>> FlippedRuns;
+	bool bChanged = false;
+	uint32 Index = 0;
+	while (Data < End)
+	{
+		uint32 Run = 0;
+		if (!FogEncoding::ReadVarInt(Data, End, Run) || Run > CellNum - Index) return false;
+
+		if (bChanged && Run > 0)
+		{
+			FlippedRuns.Emplace(Index, Run);
+		}
+		Index += Run;
+		bChanged = !bChanged;
+	}
+	if (Index != CellNum) return false;
+
+	uint8* Cells = Grid.Cells.GetData();
+	for (const TPair<uint32, uint32>& FlippedRun : FlippedRuns)
+	{
+		for (uint32 i = FlippedRun.Key; i < FlippedRun.Key + FlippedRun.Value; ++i)
+		{
+			Cells[i] ^= EFogCellFlags::Explored;
+		}
+		// 只标记翻转过的格子所在的Tile
+		Grid.MarkRangeDirty(FlippedRun.Key, FlippedRun.Value);
+	}
+	return true;
+}
+
+// 保存到文件
+bool FFogSnapshot::SaveToFile(const FString& FilePath) const
+{
+	FFogSnapshotHeader Header;
+	Header.Width = Size.X;
+	Header.Height = Size.Y;
+	Header.PayloadSize = Payload.Num();
+	Header.PayloadCrc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+	// 文件头和数据拼接后一次写入
+	TArray<uint8> FileData;
+	FileData.SetNumUninitialized(sizeof(FFogSnapshotHeader) + Payload.Num());
+	FMemory::Memcpy(FileData.GetData(), &Header, sizeof(FFogSnapshotHeader));
+	FMemory::Memcpy(FileData.GetData() + sizeof(FFogSnapshotHeader), Payload.GetData(), Payload.Num());
+
+	return FFileHelper::SaveArrayToFile(FileData, *FilePath);
+}
+
+// 从文件加载到网格
+bool FFogSnapshot::LoadFromFile(const FString& FilePath, FFogGrid& Grid)
+{
+	// 校验文件头和数据
+	auto DecodeFileData = [&Grid](const uint8* Data, const int64 DataSize)
+	{
+		if (DataSize < static_cast<int64>(sizeof(FFogSnapshotHeader))) return false;
+
+		FFogSnapshotHeader Header;
+		FMemory::Memcpy(&Header, Data, sizeof(FFogSnapshotHeader));
+
+		const uint8* PayloadData = Data + sizeof(FFogSnapshotHeader);
+		if (Header.Magic != FFogSnapshotHeader::SnapshotMagic
+			|| Header.Version != FFogSnapshotHeader::SnapshotVersion
+			|| FIntPoint(Header.Width, Header.Height) != Grid.GetSize()
+			|| DataSize - static_cast<int64>(sizeof(FFogSnapshotHeader)) < Header.PayloadSize
+			|| FCrc::MemCrc32(PayloadData, Header.PayloadSize) != Header.PayloadCrc)
+		{
+			return false;
+		}
+		return DecodePayload(Grid, PayloadData, Header.PayloadSize);
+	};
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*FilePath));
+	if (MappedHandle.IsValid())
+	{
+		const TUniquePtr<IMappedFileRegion> MappedRegion(MappedHandle->MapRegion());
+		if (MappedRegion.IsValid())
+		{
+			return DecodeFileData(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+		}
+	}
+
+	// 不支持内存映射时读取整个文件
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath)) return false;
+	return DecodeFileData(FileData.GetData(), FileData.Num());
+}
+
+// 序列化
+FArchive& operator<<(FArchive& Ar, FFogSnapshot& Snapshot)
+{
+	uint32 Version = FFogSnapshotHeader::SnapshotVersion;
+	Ar << Version;
+
+	// 目前只有第 1 版，其他版本无法解码
+	if (Ar.IsLoading() && Version != FFogSnapshotHeader::SnapshotVersion)
+	{
+		YICHEN_CLOG(Fog, Error, "不支持的迷雾快照版本: %u", Version);
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Snapshot.Size;
+	Ar << Snapshot.Payload;
+	return Ar;
+}
+
+#if !UE_BUILD_SHIPPING
+// 快照基准测试：输出 512²、1024²、2048² 地图的快照和增量的大小与编解码吞吐
+static FAutoConsoleCommand FogSnapshotBenchmarkCommand(
+	TEXT("ToolKits.Fog.SnapshotBenchmark"),
+	TEXT("输出迷雾快照和增量在 512/1024/2048 地图上的大小和编解码吞吐"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		constexpr int32 Iterations = 20;
+		for (const int32 MapSize : {512, 1024, 2048})
+		{
+			// 用随机分布的视野圆模拟一局游戏中的已探索区域
+			FFogGrid Grid;
+			Grid.Init(FIntPoint(MapSize, MapSize));
+			FRandomStream Random(MapSize);
+			Grid.BeginFrame();
+			for (int32 i = 0; i < MapSize / 4; ++i)
+			{
+				Grid.RevealCircle(FIntPoint(Random.RandRange(0, MapSize - 1), Random.RandRange(0, MapSize - 1)), MapSize / 32);
+			}
+			Grid.EndFrame();
+
+			FFogSnapshot Snapshot;
+			const double EncodeStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				Snapshot.Encode(Grid);
+			}
+			const double EncodeSeconds = (FPlatformTime::Seconds() - EncodeStart) / Iterations;
+
+			const double DecodeStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				Snapshot.Decode(Grid);
+			}
+			const double DecodeSeconds = (FPlatformTime::Seconds() - DecodeStart) / Iterations;
+
+			// 再探索几个视野圆作为一次增量，编码时交替对比两个网格，每次都有相同数量的翻转
+			FFogGrid Next = Grid;
+			Next.BeginFrame();
+			for (int32 i = 0; i < 8; ++i)
+			{
+				Next.RevealCircle(FIntPoint(Random.RandRange(0, MapSize - 1), Random.RandRange(0, MapSize - 1)), MapSize / 32);
+			}
+			Next.EndFrame();
+
+			TBitArray<> Baseline;
+			TArray<uint8> Delta, ReverseDelta;
+			FFogSnapshot::EncodeDelta(Grid, Baseline, Delta);
+			const double EncodeDeltaStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				FFogSnapshot::EncodeDelta(Next, Baseline, Delta);
+				FFogSnapshot::EncodeDelta(Grid, Baseline, ReverseDelta);
+			}
+			const double EncodeDeltaSeconds = (FPlatformTime::Seconds() - EncodeDeltaStart) / (Iterations * 2);
+
+			// 增量按异或翻转，连续应用同一个增量会在两个状态间来回切换
+			FFogGrid Target = Grid;
+			const double ApplyDeltaStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				FFogSnapshot::ApplyDelta(Target, Delta);
+			}
+			const double ApplyDeltaSeconds = (FPlatformTime::Seconds() - ApplyDeltaStart) / Iterations;
+
+			const double CellMillions = static_cast<double>(MapSize) * MapSize / 1e6;
+			Ar.Logf(TEXT("迷雾快照 %d²: %d 字节, 编码 %.1f M格/秒, 解码 %.1f M格/秒"),
+			        MapSize, Snapshot.Payload.Num(), CellMillions / EncodeSeconds, CellMillions / DecodeSeconds);
+			Ar.Logf(TEXT("迷雾增量 %d²: %d 字节, 编码 %.1f M格/秒, 应用 %.1f M格/秒"),
+			        MapSize, Delta.Num(), CellMillions / EncodeDeltaSeconds, CellMillions / ApplyDeltaSeconds);
+		}
+	}));
+#endif
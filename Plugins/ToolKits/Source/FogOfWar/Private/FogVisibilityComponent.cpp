@@ -0,0 +1,114 @@
+﻿#include "FogVisibilityComponent.h"
+
+#include "FogOfWarSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+UFogVisibilityComponent::UFogVisibilityComponent():
+	bMovable(true),
+	bHideInFog(true),
+	bThrottleTickInFog(true),
+	bFogVisible(true),
+	bTickThrottled(false),
+	bDefaultTickEnabled(true)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UFogVisibilityComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>())
+	{
+		FogSubsystem->RegisterVisibilityComponent(this);
+	}
+}
+
+void UFogVisibilityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFogOfWarSubsystem* FogSubsystem = GetWorld()->GetSubsystem<UFogOfWarSubsystem>())
+	{
+		FogSubsystem->UnregisterVisibilityComponent(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+// 应用可见性
+void UFogVisibilityComponent::ApplyFogVisibility(bool bVisible)
+{
+	if (bFogVisible == bVisible) return;
+	bFogVisible = bVisible;
+
+	AActor* Owner = GetOwner();
+	if (Owner == nullptr) return;
+
+	if (ShouldApplyPresentation())
+	{
+		if (bHideInFog)
+		{
+			SetPrimitivesHidden(Owner, !bVisible);
+		}
+
+		// 只降低代理的Tick，权威端的Tick负责模拟
+		if (bThrottleTickInFog && !bVisible && !Owner->HasAuthority())
+		{
+			// 记录进入迷雾前的Tick状态，离开迷雾时恢复
+			bTickThrottled = true;
+			bDefaultTickEnabled = Owner->IsActorTickEnabled();
+			DefaultTickInterval = Owner->GetActorTickInterval();
+			if (FoggedTickInterval > 0.f)
+			{
+				Owner->SetActorTickInterval(FoggedTickInterval);
+			}
+			else
+			{
+				Owner->SetActorTickEnabled(false);
+			}
+		}
+	}
+
+	if (bVisible && bTickThrottled)
+	{
+		bTickThrottled = false;
+		Owner->SetActorTickInterval(DefaultTickInterval);
+		Owner->SetActorTickEnabled(bDefaultTickEnabled);
+	}
+
+	OnFogVisibilityChanged.Broadcast(bVisible);
+}
+
+// 是否需要改变表现
+bool UFogVisibilityComponent::ShouldApplyPresentation() const
+{
+	return GetNetMode() != NM_DedicatedServer;
+}
+
+// 隐藏或恢复本地的图元组件
+void UFogVisibilityComponent::SetPrimitivesHidden(AActor* Owner, const bool bHidden)
+{
+	if (bHidden)
+	{
+		// 已经隐藏的图元不记录，离开迷雾时保持原样
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(Owner);
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (!Primitive->bHiddenInGame)
+			{
+				Primitive->SetHiddenInGame(true);
+				FogHiddenPrimitives.Add(Primitive);
+			}
+		}
+		return;
+	}
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& WeakPrimitive : FogHiddenPrimitives)
+	{
+		if (UPrimitiveComponent* Primitive = WeakPrimitive.Get())
+		{
+			Primitive->SetHiddenInGame(false);
+		}
+	}
+	FogHiddenPrimitives.Reset();
+}
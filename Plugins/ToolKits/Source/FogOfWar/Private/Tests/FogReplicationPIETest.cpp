@@ -0,0 +1,210 @@
+﻿#include "FogOfWarSubsystem.h"
+#include "FogReplicationComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "GameFramework/PlayerController.h"
+#include "Settings/LevelEditorPlaySettings.h"
+
+namespace FogReplicationPIETest
+{
+	constexpr int32 GridSize = 256;
+	constexpr float CellSize = 100.f;
+	constexpr int32 SourceNum = 100;
+	constexpr uint8 ClientTeam = 1;
+	constexpr double MoveSeconds = 6.0;
+	constexpr double SettleSeconds = 5.0;
+	constexpr double TimeoutSeconds = 30.0;
+
+	// 测试过程中共享的状态
+	struct FState
+	{
+		TWeakObjectPtr<UWorld> ServerWorld;
+		TWeakObjectPtr<UWorld> ClientWorld;
+		TWeakObjectPtr<APlayerController> RemoteController;
+		TWeakObjectPtr<UFogReplicationComponent> ServerComponent;
+		TArray<TWeakObjectPtr<AActor>> Sources;
+		double StartTime = 0.0;
+		double MoveStartTime = 0.0;
+		float PeakBytesPerSecond = 0.f;
+		float PeakConnectionBytesPerSecond = 0.f;
+		float SumBytesPerSecond = 0.f;
+		int32 SampleNum = 0;
+		double LastSampleTime = 0.0;
+	};
+
+	// 找到PIE中的监听服务器和客户端世界
+	bool FindWorlds(FState& State)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType != EWorldType::PIE || World == nullptr || !World->HasBegunPlay()) continue;
+
+			if (World->GetNetMode() == NM_ListenServer)
+			{
+				State.ServerWorld = World;
+			}
+			else if (World->GetNetMode() == NM_Client && World->GetFirstPlayerController())
+			{
+				State.ClientWorld = World;
+			}
+		}
+		if (!State.ServerWorld.IsValid() || !State.ClientWorld.IsValid()) return false;
+
+		// 服务器上代表客户端连接的控制器
+		for (FConstPlayerControllerIterator It = State.ServerWorld->GetPlayerControllerIterator(); It; ++It)
+		{
+			APlayerController* Controller = It->Get();
+			if (Controller && !Controller->IsLocalController() && Controller->GetNetConnection())
+			{
+				State.RemoteController = Controller;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 初始化迷雾，两端使用相同的网格
+	void InitFog(UWorld* World)
+	{
+		UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(World);
+		World->GetSubsystem<UFogOfWarSubsystem>()->InitFog(FVector2D::ZeroVector, CellSize, FIntPoint(GridSize, GridSize), RenderTarget);
+	}
+
+	// 视野源绕各自的圆心移动
+	FVector GetSourceLocation(const int32 Index, const double Time)
+	{
+		const float Extent = GridSize * CellSize;
+		const FVector Center((Index % 10 + 0.5f) * Extent / 10.f, (Index / 10 + 0.5f) * Extent / 10.f, 0.f);
+		const double Angle = Time * 1.5 + Index;
+		return Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Extent / 30.f;
+	}
+}
+
+/**
+ * 监听服务器 + 1 个客户端的PIE会话，服务器上 100 个视野源移动，
+ * 迷雾通过 UFogReplicationComponent（不可靠RPC、队伍复制、子系统解码）发送给客户端，
+ * 停止移动后客户端网格应与服务器一致，并报告每秒字节数
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogReplicationPIETest, "ToolKits.FogOfWar.ReplicationPIE",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFogReplicationPIETest::RunTest(const FString& Parameters)
+{
+	using namespace FogReplicationPIETest;
+
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+	PlaySettings->SetPlayNumberOfClients(2);
+	PlaySettings->SetRunUnderOneProcess(true);
+
+	FRequestPlaySessionParams Params;
+	Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+	Params.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(Params);
+
+	const TSharedRef<FState> State = MakeShared<FState>();
+	State->StartTime = FPlatformTime::Seconds();
+
+	// 等待客户端连接，初始化两端的迷雾和视野源，给客户端控制器挂上同步组件
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State]()
+	{
+		if (!FindWorlds(*State))
+		{
+			if (FPlatformTime::Seconds() - State->StartTime < TimeoutSeconds) return false;
+			AddError(TEXT("PIE 监听服务器或客户端没有启动"));
+			return true;
+		}
+
+		UWorld* ServerWorld = State->ServerWorld.Get();
+		InitFog(ServerWorld);
+		InitFog(State->ClientWorld.Get());
+
+		UFogOfWarSubsystem* ServerFog = ServerWorld->GetSubsystem<UFogOfWarSubsystem>();
+		for (int32 i = 0; i < SourceNum; ++i)
+		{
+			AActor* Actor = ServerWorld->SpawnActor<AActor>();
+			USceneComponent* Root = NewObject<USceneComponent>(Actor);
+			Actor->SetRootComponent(Root);
+			Root->RegisterComponent();
+			Actor->SetActorLocation(GetSourceLocation(i, 0.0));
+			ServerFog->RegisterVisionSource(Actor, 1200.f, ClientTeam);
+			State->Sources.Add(Actor);
+		}
+
+		APlayerController* Controller = State->RemoteController.Get();
+		UFogReplicationComponent* Component = NewObject<UFogReplicationComponent>(Controller, TEXT("FogReplication"));
+		Component->SetTeam(ClientTeam);
+		Controller->AddInstanceComponent(Component);
+		Component->RegisterComponent();
+		State->ServerComponent = Component;
+		State->MoveStartTime = ServerWorld->GetTimeSeconds();
+		return true;
+	}));
+
+	// 移动视野源，每秒采样一次发送速率
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([State]()
+	{
+		const UWorld* ServerWorld = State->ServerWorld.Get();
+		const UFogReplicationComponent* Component = State->ServerComponent.Get();
+		if (ServerWorld == nullptr || Component == nullptr) return true;
+
+		const double Time = ServerWorld->GetTimeSeconds() - State->MoveStartTime;
+		for (int32 i = 0; i < State->Sources.Num(); ++i)
+		{
+			if (AActor* Actor = State->Sources[i].Get())
+			{
+				Actor->SetActorLocation(GetSourceLocation(i, Time));
+			}
+		}
+
+		if (Time >= 1.0 && Time - State->LastSampleTime >= 1.0)
+		{
+			State->LastSampleTime = Time;
+			State->PeakBytesPerSecond = FMath::Max(State->PeakBytesPerSecond, Component->GetBytesPerSecond());
+			State->SumBytesPerSecond += Component->GetBytesPerSecond();
+			++State->SampleNum;
+			const APlayerController* Controller = State->RemoteController.Get();
+			if (const UNetConnection* Connection = Controller ? Controller->GetNetConnection() : nullptr)
+			{
+				State->PeakConnectionBytesPerSecond = FMath::Max(State->PeakConnectionBytesPerSecond, static_cast<float>(Connection->OutBytesPerSecond));
+			}
+		}
+		return Time >= MoveSeconds;
+	}));
+
+	// 停止移动后等待关键帧补齐，比较两端的网格
+	ADD_LATENT_AUTOMATION_COMMAND(FDelayedFunctionLatentCommand([this, State]()
+	{
+		const UWorld* ServerWorld = State->ServerWorld.Get();
+		const UWorld* ClientWorld = State->ClientWorld.Get();
+		const UFogReplicationComponent* Component = State->ServerComponent.Get();
+		if (ServerWorld && ClientWorld && Component)
+		{
+			const FFogGrid* ServerGrid = ServerWorld->GetSubsystem<UFogOfWarSubsystem>()->FindTeamGrid(ClientTeam);
+			const UFogOfWarSubsystem* ClientFog = ClientWorld->GetSubsystem<UFogOfWarSubsystem>();
+			TestEqual(TEXT("客户端显示同步组件的队伍"), static_cast<int32>(ClientFog->GetLocalTeam()), static_cast<int32>(ClientTeam));
+			TestTrue(TEXT("客户端网格与服务器队伍网格一致"), ServerGrid && ServerGrid->GetCells() == ClientFog->GetGrid().GetCells());
+
+			const float MeanBytesPerSecond = State->SampleNum > 0 ? State->SumBytesPerSecond / State->SampleNum : 0.f;
+			TestTrue(TEXT("移动时有迷雾流量"), State->PeakBytesPerSecond > 0.f);
+			AddInfo(FString::Printf(TEXT("%d 个移动的视野源：迷雾平均 %.0f 字节/秒，峰值 %.0f 字节/秒，连接峰值 %.0f 字节/秒"),
+			                        SourceNum, MeanBytesPerSecond, State->PeakBytesPerSecond, State->PeakConnectionBytesPerSecond));
+		}
+		GEditor->RequestEndPlayMap();
+	}, SettleSeconds));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		return !GEditor->IsPlaySessionInProgress();
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,134 @@
+﻿#include "FogDeltaPacket.h"
+#include "FogGrid.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * 模拟服务器到客户端的迷雾同步：视野源移动 3 秒，每帧按预算编码并经过网络序列化，
+ * 每 7 个包丢一个，关键帧只重发未确认的Tile，补齐后两边的网格应一致，同时统计每个包的大小和每秒字节数
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogReplicationLoopbackTest, "ToolKits.FogOfWar.ReplicationLoopback",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogReplicationLoopbackTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 GridSize = 256;
+	constexpr int32 ByteBudget = 512;
+	constexpr float FrameTime = 1.f / 60.f;
+	constexpr int32 MoveFrames = 180;
+	constexpr int32 KeyframeFrames = 120;
+	constexpr int32 DropEvery = 7;
+
+	FFogGrid ServerGrid;
+	ServerGrid.Init(FIntPoint(GridSize, GridSize));
+	FFogGrid ClientGrid;
+	ClientGrid.Init(FIntPoint(GridSize, GridSize));
+
+	const FIntPoint TileCount = ServerGrid.GetTileCount();
+	TBitArray<> PendingTiles(true, TileCount.X * TileCount.Y);
+	FFogDeltaPacket Packet;
+	TMap<uint16, TPair<TBitArray<>, int32>> InFlight;
+	int32 KeyframeCount = 0;
+	int64 TotalBytes = 0;
+	int32 MaxPacketBytes = 0;
+	int32 PacketNum = 0;
+
+	// 发送一帧，返回是否发送了数据
+	auto SendFrame = [&](const bool bAllowDrop)
+	{
+		TBitArray<> SentTiles;
+		Packet.Sequence = static_cast<uint16>(PacketNum);
+		if (!Packet.Encode(ServerGrid, PendingTiles, ByteBudget, &SentTiles)) return false;
+		InFlight.Add(Packet.Sequence, {MoveTemp(SentTiles), KeyframeCount});
+
+		FBitWriter Writer(0, true);
+		bool bSuccess = false;
+		Packet.NetSerialize(Writer, nullptr, bSuccess);
+		const int32 PacketBytes = Writer.GetNumBytes();
+		TotalBytes += PacketBytes;
+		MaxPacketBytes = FMath::Max(MaxPacketBytes, PacketBytes);
+		++PacketNum;
+
+		// 模拟丢包
+		if (bAllowDrop && PacketNum % DropEvery == 0) return true;
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		FFogDeltaPacket Received;
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+		TestTrue(TEXT("包解码成功"), bSuccess && Received.Decode(ClientGrid));
+		InFlight.Remove(Received.Sequence);
+		return true;
+	};
+
+	// 关键帧：重发上个关键帧之前发出、仍未确认的Tile
+	auto Keyframe = [&]()
+	{
+		for (auto It = InFlight.CreateIterator(); It; ++It)
+		{
+			if (It.Value().Value == KeyframeCount) continue;
+			PendingTiles.CombineWithBitwiseOR(It.Value().Key, EBitwiseOperatorFlags::MaintainSize);
+			It.RemoveCurrent();
+		}
+		++KeyframeCount;
+	};
+
+	for (int32 Frame = 0; Frame < MoveFrames; ++Frame)
+	{
+		// 视野源绕地图中心移动
+		const float Angle = Frame * FrameTime * 2.f;
+		const FIntPoint Center(GridSize / 2 + FMath::RoundToInt32(FMath::Cos(Angle) * GridSize / 3), GridSize / 2 + FMath::RoundToInt32(FMath::Sin(Angle) * GridSize / 3));
+		ServerGrid.BeginFrame();
+		ServerGrid.RevealCircle(Center, 12);
+		ServerGrid.EndFrame();
+
+		PendingTiles.CombineWithBitwiseOR(ServerGrid.GetChangedTiles(), EBitwiseOperatorFlags::MaintainSize);
+		ServerGrid.ResetChangedTiles();
+		if ((Frame + 1) % KeyframeFrames == 0)
+		{
+			Keyframe();
+		}
+		SendFrame(true);
+	}
+
+	// 停止移动后不再丢包，连续两个关键帧重发所有未确认的Tile
+	int32 FlushFrames = 0;
+	for (int32 i = 0; i < 2; ++i)
+	{
+		Keyframe();
+		while (SendFrame(false) && FlushFrames < TileCount.X * TileCount.Y)
+		{
+			++FlushFrames;
+		}
+	}
+	TestEqual(TEXT("所有包都已确认"), InFlight.Num(), 0);
+
+	// 静止的地图在关键帧时不产生流量
+	Keyframe();
+	TestFalse(TEXT("静止时关键帧不重发"), SendFrame(false));
+
+	TestTrue(FString::Printf(TEXT("每个包不超过预算（最大 %d 字节）"), MaxPacketBytes), MaxPacketBytes <= ByteBudget);
+	TestTrue(TEXT("关键帧后客户端网格与服务器一致"), ClientGrid.GetCells() == ServerGrid.GetCells());
+
+	// 截断的包解码失败，客户端网格保持不变
+	ServerGrid.BeginFrame();
+	ServerGrid.RevealCircle(FIntPoint(GridSize / 4, GridSize / 4), 40);
+	ServerGrid.EndFrame();
+	PendingTiles.Init(true, PendingTiles.Num());
+	FFogDeltaPacket Truncated;
+	if (Truncated.Encode(ServerGrid, PendingTiles, ByteBudget))
+	{
+		const TArray<uint8> CellsBefore = ClientGrid.GetCells();
+		Truncated.Data.SetNum(Truncated.Data.Num() - 1);
+		TestFalse(TEXT("截断的包解码失败"), Truncated.Decode(ClientGrid));
+		TestTrue(TEXT("解码失败时网格不变"), ClientGrid.GetCells() == CellsBefore);
+	}
+
+	const float Seconds = (MoveFrames + FlushFrames) * FrameTime;
+	AddInfo(FString::Printf(TEXT("%d 个包，共 %lld 字节，%.0f 字节/秒（%.1f 秒）"), PacketNum, TotalBytes, TotalBytes / Seconds, Seconds));
+	return true;
+}
+
+#endif
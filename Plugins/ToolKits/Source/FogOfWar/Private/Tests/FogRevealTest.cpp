@@ -0,0 +1,49 @@
+﻿#include "FogOfWarSubsystem.h"
+#include "FogRevealPass.h"
+#include "FogTestWorld.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 开启GPU照亮后：NullRHI 下回退到CPU网格且网格继续更新；支持时拒绝读取CPU网格的功能
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogGPURevealFallbackTest, "ToolKits.FogOfWar.GPURevealFallback",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogGPURevealFallbackTest::RunTest(const FString& Parameters)
+{
+	FFogTestWorld TestWorld;
+	UFogOfWarSubsystem* FogSubsystem = TestWorld.World->GetSubsystem<UFogOfWarSubsystem>();
+	if (!TestNotNull(TEXT("迷雾子系统"), FogSubsystem)) return false;
+
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage());
+	FogSubsystem->InitFog(FVector2D::ZeroVector, 100.f, FIntPoint(64, 64), RenderTarget);
+	FogSubsystem->RegisterVisionSource(TestWorld.SpawnActorAt(FVector(3250.f, 3250.f, 0.f)), 500.f);
+	FogSubsystem->SetGPURevealEnabled(true);
+	FogSubsystem->Tick(1.f / 60.f);
+
+	if (!FogOfWar::CanUseGPUReveal())
+	{
+		TestFalse(TEXT("不支持Compute Shader时回退到CPU网格"), FogSubsystem->IsUsingGPUReveal());
+
+		const uint8 Cell = FogSubsystem->GetGrid().GetCell(32, 32);
+		TestTrue(TEXT("CPU网格被照亮"), (Cell & EFogCellFlags::Visible) != 0);
+		TestTrue(TEXT("CPU网格已探索"), (Cell & EFogCellFlags::Explored) != 0);
+		TestFalse(TEXT("回退后快照可用"), FogSubsystem->SaveFogSnapshot().IsEmpty());
+	}
+	else
+	{
+		TestTrue(TEXT("使用GPU照亮"), FogSubsystem->IsUsingGPUReveal());
+		TestTrue(TEXT("GPU照亮时拒绝保存快照"), FogSubsystem->SaveFogSnapshot().IsEmpty());
+		TestTrue(TEXT("GPU照亮时拒绝生成增量"), FogSubsystem->MakeFogDelta().IsEmpty());
+
+		// 切回CPU网格后恢复
+		FogSubsystem->SetGPURevealEnabled(false);
+		FogSubsystem->Tick(1.f / 60.f);
+		TestTrue(TEXT("切回CPU后网格被照亮"), (FogSubsystem->GetGrid().GetCell(32, 32) & EFogCellFlags::Visible) != 0);
+		TestFalse(TEXT("切回CPU后快照可用"), FogSubsystem->SaveFogSnapshot().IsEmpty());
+	}
+	return true;
+}
+
+#endif
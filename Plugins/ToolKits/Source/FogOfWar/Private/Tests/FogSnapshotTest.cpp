@@ -0,0 +1,185 @@
+﻿#include "FogGrid.h"
+#include "FogSnapshot.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FogSnapshotTest
+{
+	// 64x64 的网格，照亮两个圆
+	void MakeGrid(FFogGrid& Grid)
+	{
+		Grid.Init(FIntPoint(64, 64));
+		Grid.BeginFrame();
+		Grid.RevealCircle(FIntPoint(16, 16), 6);
+		Grid.RevealCircle(FIntPoint(45, 40), 9);
+		Grid.EndFrame();
+	}
+
+	// 两个网格的已探索位平面是否一致
+	bool ExploredEquals(const FFogGrid& A, const FFogGrid& B)
+	{
+		for (int32 i = 0; i < A.GetCells().Num(); ++i)
+		{
+			if ((A.GetCells()[i] & EFogCellFlags::Explored) != (B.GetCells()[i] & EFogCellFlags::Explored)) return false;
+		}
+		return A.GetCells().Num() == B.GetCells().Num();
+	}
+
+	// 网格是否全部为零
+	bool IsEmpty(const FFogGrid& Grid)
+	{
+		return Grid.GetCells().FindByPredicate([](const uint8 Cell) { return Cell != 0; }) == nullptr;
+	}
+}
+
+// 快照往返、截断数据和未知版本
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogSnapshotTest, "ToolKits.FogOfWar.Snapshot",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogSnapshotTest::RunTest(const FString& Parameters)
+{
+	FFogGrid Source;
+	FogSnapshotTest::MakeGrid(Source);
+
+	FFogSnapshot Snapshot;
+	Snapshot.Encode(Source);
+
+	// 往返后已探索位平面一致
+	FFogGrid Target;
+	Target.Init(Source.GetSize());
+	TestTrue(TEXT("解码成功"), Snapshot.Decode(Target));
+	for (int32 i = 0; i < Source.GetCells().Num(); ++i)
+	{
+		if ((Source.GetCells()[i] & EFogCellFlags::Explored) != (Target.GetCells()[i] & EFogCellFlags::Explored))
+		{
+			AddError(FString::Printf(TEXT("第 %d 个格子的已探索标记不一致"), i));
+			break;
+		}
+	}
+
+	// 截断的数据被拒绝，网格保持不变
+	FFogGrid Untouched;
+	Untouched.Init(Source.GetSize());
+	FFogSnapshot Truncated = Snapshot;
+	Truncated.Payload.SetNum(Truncated.Payload.Num() / 2);
+	TestFalse(TEXT("截断的快照被拒绝"), Truncated.Decode(Untouched));
+	TestTrue(TEXT("截断的快照不修改网格"), Untouched.GetCells().FindByPredicate([](const uint8 Cell) { return Cell != 0; }) == nullptr);
+
+	// 未知版本被拒绝
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Writer << Snapshot;
+	Bytes[0] = 0xFF;
+	FFogSnapshot Loaded;
+	FMemoryReader Reader(Bytes);
+	Reader << Loaded;
+	TestTrue(TEXT("未知版本被拒绝"), Reader.IsError());
+	TestTrue(TEXT("未知版本不读取数据"), Loaded.Payload.IsEmpty());
+	return true;
+}
+
+// 增量往返和损坏的增量
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogSnapshotDeltaTest, "ToolKits.FogOfWar.SnapshotDelta",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogSnapshotDeltaTest::RunTest(const FString& Parameters)
+{
+	FFogGrid Source;
+	FogSnapshotTest::MakeGrid(Source);
+
+	TBitArray<> Baseline;
+	TArray<uint8> Delta;
+	FFogSnapshot::EncodeDelta(Source, Baseline, Delta);
+
+	// 损坏的增量被拒绝，网格保持不变
+	FFogGrid Target;
+	Target.Init(Source.GetSize());
+	TArray<uint8> Corrupt = Delta;
+	Corrupt.Pop();
+	TestFalse(TEXT("截断的增量被拒绝"), FFogSnapshot::ApplyDelta(Target, Corrupt));
+	TestTrue(TEXT("截断的增量不修改网格"), Target.GetCells().FindByPredicate([](const uint8 Cell) { return Cell != 0; }) == nullptr);
+
+	// 完整的增量让两边一致
+	TestTrue(TEXT("应用增量"), FFogSnapshot::ApplyDelta(Target, Delta));
+	for (int32 i = 0; i < Source.GetCells().Num(); ++i)
+	{
+		if ((Source.GetCells()[i] & EFogCellFlags::Explored) != (Target.GetCells()[i] & EFogCellFlags::Explored))
+		{
+			AddError(FString::Printf(TEXT("第 %d 个格子的已探索标记不一致"), i));
+			break;
+		}
+	}
+
+	// 没有变化时的增量不翻转任何格子
+	FFogSnapshot::EncodeDelta(Source, Baseline, Delta);
+	const TArray<uint8> Before = Target.GetCells();
+	TestTrue(TEXT("应用空增量"), FFogSnapshot::ApplyDelta(Target, Delta));
+	TestTrue(TEXT("空增量不修改网格"), Before == Target.GetCells());
+	return true;
+}
+
+// 通过文件保存和内存映射加载，损坏或不匹配的文件被拒绝
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogSnapshotFileTest, "ToolKits.FogOfWar.SnapshotFile",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogSnapshotFileTest::RunTest(const FString& Parameters)
+{
+	FFogGrid Source;
+	FogSnapshotTest::MakeGrid(Source);
+
+	FFogSnapshot Snapshot;
+	Snapshot.Encode(Source);
+
+	const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("FogSnapshotTest.fog"));
+	TestTrue(TEXT("保存到文件"), Snapshot.SaveToFile(FilePath));
+
+	// 文件为 文件头 + RLE数据
+	TArray<uint8> FileData;
+	TestTrue(TEXT("读取文件"), FFileHelper::LoadFileToArray(FileData, *FilePath));
+	TestEqual(TEXT("文件大小"), FileData.Num(), static_cast<int32>(sizeof(FFogSnapshotHeader)) + Snapshot.Payload.Num());
+
+	// 往返后已探索位平面一致
+	FFogGrid Loaded;
+	Loaded.Init(Source.GetSize());
+	TestTrue(TEXT("从文件加载"), FFogSnapshot::LoadFromFile(FilePath, Loaded));
+	TestTrue(TEXT("文件往返后一致"), FogSnapshotTest::ExploredEquals(Source, Loaded));
+
+	// 网格大小不一致时被拒绝
+	FFogGrid Other;
+	Other.Init(FIntPoint(32, 32));
+	TestFalse(TEXT("网格大小不一致被拒绝"), FFogSnapshot::LoadFromFile(FilePath, Other));
+	TestTrue(TEXT("网格大小不一致不修改网格"), FogSnapshotTest::IsEmpty(Other));
+
+	// 数据被改写时校验失败，网格保持不变
+	FFogGrid Untouched;
+	Untouched.Init(Source.GetSize());
+	TArray<uint8> Corrupt = FileData;
+	Corrupt.Last() ^= 0xFF;
+	FFileHelper::SaveArrayToFile(Corrupt, *FilePath);
+	TestFalse(TEXT("校验失败被拒绝"), FFogSnapshot::LoadFromFile(FilePath, Untouched));
+	TestTrue(TEXT("校验失败不修改网格"), FogSnapshotTest::IsEmpty(Untouched));
+
+	// 截断的文件被拒绝
+	Corrupt = FileData;
+	Corrupt.SetNum(Corrupt.Num() - 1);
+	FFileHelper::SaveArrayToFile(Corrupt, *FilePath);
+	TestFalse(TEXT("截断的文件被拒绝"), FFogSnapshot::LoadFromFile(FilePath, Untouched));
+
+	// 只有一部分文件头
+	Corrupt.SetNum(sizeof(FFogSnapshotHeader) / 2);
+	FFileHelper::SaveArrayToFile(Corrupt, *FilePath);
+	TestFalse(TEXT("不完整的文件头被拒绝"), FFogSnapshot::LoadFromFile(FilePath, Untouched));
+	TestTrue(TEXT("损坏的文件不修改网格"), FogSnapshotTest::IsEmpty(Untouched));
+
+	IFileManager::Get().Delete(*FilePath);
+	TestFalse(TEXT("文件不存在"), FFogSnapshot::LoadFromFile(FilePath, Untouched));
+	return true;
+}
+
+#endif
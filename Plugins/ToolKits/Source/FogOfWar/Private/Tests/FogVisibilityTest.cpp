@@ -0,0 +1,80 @@
+﻿#include "FogOfWarSubsystem.h"
+#include "FogTestWorld.h"
+#include "FogVisibilityComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FogVisibilityTest
+{
+	// 生成带图元和可见性组件的Actor
+	UFogVisibilityComponent* SpawnFogActor(const FFogTestWorld& TestWorld, const FVector& Location, UStaticMeshComponent*& OutMesh)
+	{
+		AActor* Actor = TestWorld.SpawnActorAt(Location);
+		OutMesh = NewObject<UStaticMeshComponent>(Actor);
+		OutMesh->SetupAttachment(Actor->GetRootComponent());
+		OutMesh->RegisterComponent();
+
+		UFogVisibilityComponent* Component = NewObject<UFogVisibilityComponent>(Actor);
+		Component->FoggedTickInterval = 0.5f;
+		Component->RegisterComponent();
+		return Component;
+	}
+}
+
+// 迷雾中只在本地隐藏图元，不修改复制的 bHidden，权威端的Tick不受影响，代理降低Tick
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFogVisibilityComponentTest, "ToolKits.FogOfWar.VisibilityComponent",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFogVisibilityComponentTest::RunTest(const FString& Parameters)
+{
+	FFogTestWorld TestWorld;
+	UFogOfWarSubsystem* FogSubsystem = TestWorld.World->GetSubsystem<UFogOfWarSubsystem>();
+	if (!TestNotNull(TEXT("迷雾子系统"), FogSubsystem)) return false;
+
+	UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage());
+	FogSubsystem->InitFog(FVector2D::ZeroVector, 100.f, FIntPoint(64, 64), RenderTarget);
+	FogSubsystem->RegisterVisionSource(TestWorld.SpawnActorAt(FVector(3250.f, 3250.f, 0.f)), 500.f);
+
+	// 视野内、视野外（权威）、视野外（代理）
+	UStaticMeshComponent* SeenMesh = nullptr;
+	UStaticMeshComponent* FoggedMesh = nullptr;
+	UStaticMeshComponent* ProxyMesh = nullptr;
+	UFogVisibilityComponent* Seen = FogVisibilityTest::SpawnFogActor(TestWorld, FVector(3250.f, 3250.f, 0.f), SeenMesh);
+	UFogVisibilityComponent* Fogged = FogVisibilityTest::SpawnFogActor(TestWorld, FVector(500.f, 500.f, 0.f), FoggedMesh);
+	UFogVisibilityComponent* Proxy = FogVisibilityTest::SpawnFogActor(TestWorld, FVector(600.f, 500.f, 0.f), ProxyMesh);
+	Proxy->GetOwner()->SetRole(ROLE_SimulatedProxy);
+
+	// 原本就隐藏的图元离开迷雾后保持隐藏
+	UStaticMeshComponent* PreHidden = NewObject<UStaticMeshComponent>(Fogged->GetOwner());
+	PreHidden->SetupAttachment(Fogged->GetOwner()->GetRootComponent());
+	PreHidden->SetHiddenInGame(true);
+	PreHidden->RegisterComponent();
+
+	const float AuthorityTickInterval = Fogged->GetOwner()->GetActorTickInterval();
+	FogSubsystem->Tick(1.f / 60.f);
+
+	TestTrue(TEXT("视野内可见"), Seen->IsVisibleInFog());
+	TestFalse(TEXT("视野内的图元不隐藏"), SeenMesh->bHiddenInGame);
+
+	TestFalse(TEXT("视野外不可见"), Fogged->IsVisibleInFog());
+	TestTrue(TEXT("视野外的图元隐藏"), FoggedMesh->bHiddenInGame);
+	TestFalse(TEXT("不修改复制的 bHidden"), Fogged->GetOwner()->IsHidden());
+	TestEqual(TEXT("权威端的Tick间隔不变"), Fogged->GetOwner()->GetActorTickInterval(), AuthorityTickInterval);
+
+	TestTrue(TEXT("代理的图元隐藏"), ProxyMesh->bHiddenInGame);
+	TestEqual(TEXT("代理降低Tick"), Proxy->GetOwner()->GetActorTickInterval(), 0.5f);
+
+	// 离开迷雾后恢复
+	Fogged->ApplyFogVisibility(true);
+	Proxy->ApplyFogVisibility(true);
+	TestFalse(TEXT("离开迷雾后图元显示"), FoggedMesh->bHiddenInGame);
+	TestTrue(TEXT("原本隐藏的图元保持隐藏"), PreHidden->bHiddenInGame);
+	TestFalse(TEXT("代理的图元显示"), ProxyMesh->bHiddenInGame);
+	TestEqual(TEXT("代理恢复Tick间隔"), Proxy->GetOwner()->GetActorTickInterval(), AuthorityTickInterval);
+	return true;
+}
+
+#endif
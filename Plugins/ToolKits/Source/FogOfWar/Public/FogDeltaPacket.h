@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "FogDeltaPacket.generated.h"
+
+struct FFogGrid;
+
+/**
+ * 迷雾网络增量包
+ * 数据布局为 变化Tile位掩码（游程编码）+ 每个Tile内格子的游程编码（值 + 长度）
+ * 序号用于客户端确认收到的包，服务器只重发未确认的Tile
+ */
+USTRUCT()
+struct FOGOFWAR_API FFogDeltaPacket
+{
+	GENERATED_BODY()
+
+	// 包序号
+	uint16 Sequence = 0;
+
+	// 编码后的数据
+	TArray<uint8> Data;
+
+	/**
+	 * 在字节预算内编码待发送的Tile，已编码的Tile会从待发送中移除
+	 * 预算包含序号、Tile位掩码和网络序列化的长度前缀，至少会编码一个Tile，保证预算过小时仍能推进
+	 * @param Grid			队伍的迷雾网格
+	 * @param PendingTiles	待发送的Tile
+	 * @param ByteBudget	字节预算
+	 * @param OutSentTiles	输出本次编码的Tile，可为空
+	 * @return				是否编码了数据
+	 */
+	bool Encode(const FFogGrid& Grid, TBitArray<>& PendingTiles, int32 ByteBudget, TBitArray<>* OutSentTiles = nullptr);
+
+	// 解码到网格，并把收到的Tile标记为脏，数据不完整时网格保持不变
+	bool Decode(FFogGrid& Grid) const;
+
+	// 网络序列化
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FFogDeltaPacket> : public TStructOpsTypeTraitsBase2<FFogDeltaPacket>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
@@ -0,0 +1,122 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+// 迷雾格子标记
+namespace EFogCellFlags
+{
+	enum Type : uint8
+	{
+		None = 0,
+		// 当前可见
+		Visible = 1 << 0,
+		// 已探索
+		Explored = 1 << 1,
+	};
+}
+
+/**
+ * 迷雾网格
+ * 以格子记录可见/已探索状态，并以Tile为单位跟踪变化，
+ * 只有真正发生变化的Tile才会被标记为脏区提交到GPU
+ */
+struct FOGOFWAR_API FFogGrid
+{
+	/**
+	 * 初始化网格
+	 * @param InSize		网格大小（格子数）
+	 * @param InTileSize	Tile边长（格子数）
+	 */
+	void Init(const FIntPoint& InSize, int32 InTileSize = 32);
+
+	// 开始一帧的更新，清除上一帧被照亮区域的可见标记
+	void BeginFrame();
+
+	/**
+	 * 照亮一个圆形区域
+	 * @param Center	圆心（格子坐标）
+	 * @param Radius	半径（格子数）
+	 */
+	void RevealCircle(const FIntPoint& Center, int32 Radius);
+
+	// 结束一帧的更新，对比上次提交的数据计算脏Tile
+	void EndFrame();
+
+	// 将所有Tile标记为脏（首次上传或渲染目标重建时使用）
+	void MarkAllDirty();
+
+	/**
+	 * 将一段连续格子所在的Tile标记为脏（外部直接修改格子后使用）
+	 * @param StartIndex	起始格子下标
+	 * @param Count			格子数量
+	 */
+	void MarkRangeDirty(int32 StartIndex, int32 Count);
+
+	// 将单个Tile标记为脏（外部直接修改Tile内的格子后使用）
+	void MarkTileDirty(int32 TileIndex);
+
+	/**
+	 * 取出脏区，同一行相邻的脏Tile会被合并成一个矩形
+	 * @param OutRects	脏区矩形（格子坐标）
+	 */
+	void ConsumeDirtyRects(TArray<FIntRect>& OutRects);
+
+	// 是否有效的格子
+	FORCEINLINE bool IsValidCell(const int32 X, const int32 Y) const { return X >= 0 && Y >= 0 && X < Size.X && Y < Size.Y; }
+
+	// 获取格子标记
+	FORCEINLINE uint8 GetCell(const int32 X, const int32 Y) const { return Cells[Y * Size.X + X]; }
+
+	// 获取所有格子
+	FORCEINLINE const TArray<uint8>& GetCells() const { return Cells; }
+
+	// 获取网格大小
+	FORCEINLINE FIntPoint GetSize() const { return Size; }
+
+	// 获取Tile边长
+	FORCEINLINE int32 GetTileSize() const { return TileSize; }
+
+	// 获取Tile数量
+	FORCEINLINE FIntPoint GetTileCount() const { return TileCount; }
+
+	// 获取自上次重置以来内容发生变化的Tile（用于网络同步）
+	FORCEINLINE const TBitArray<>& GetChangedTiles() const { return ChangedTiles; }
+
+	// 重置变化的Tile
+	FORCEINLINE void ResetChangedTiles() { ChangedTiles.Init(false, ChangedTiles.Num()); }
+
+	// 获取Tile对应的格子矩形
+	FIntRect GetTileRect(int32 TileIndex) const;
+
+	// 是否已初始化
+	FORCEINLINE bool IsInitialized() const { return !Cells.IsEmpty(); }
+
+private:
+	// 快照和网络增量直接读写格子
+	friend struct FFogSnapshot;
+	friend struct FFogDeltaPacket;
+
+	// 标记格子范围所在的Tile被访问
+	void TouchSpan(int32 Y, int32 MinX, int32 MaxX);
+
+	// 网格大小
+	FIntPoint Size = FIntPoint::ZeroValue;
+	// Tile边长
+	int32 TileSize = 32;
+	// Tile数量
+	FIntPoint TileCount = FIntPoint::ZeroValue;
+
+	// 当前格子
+	TArray<uint8> Cells;
+	// 上次提交到GPU的格子
+	TArray<uint8> UploadedCells;
+
+	// 本帧被照亮的Tile
+	TBitArray<> TouchedTiles;
+	// 上一帧被照亮的Tile
+	TBitArray<> PrevTouchedTiles;
+	// 待提交的脏Tile
+	TBitArray<> DirtyTiles;
+	// 自上次重置以来内容发生变化的Tile
+	TBitArray<> ChangedTiles;
+};
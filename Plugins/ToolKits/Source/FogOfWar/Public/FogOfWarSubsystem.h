@@ -0,0 +1,271 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "FogGrid.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FogOfWarSubsystem.generated.h"
+
+class UTexture;
+class UTextureRenderTarget2D;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+class UFogReplicationComponent;
+class UFogVisibilityComponent;
+struct FFogDeltaPacket;
+
+/**
+ * 视野源
+ */
+USTRUCT()
+struct FFogVisionSource
+{
+	GENERATED_BODY()
+
+	// 提供视野的Actor
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Actor;
+
+	// 视野半径（世界单位）
+	UPROPERTY()
+	float Radius = 0.f;
+
+	// 所属队伍
+	UPROPERTY()
+	uint8 Team = 0;
+};
+
+/**
+ * 战争迷雾子系统
+ * 每帧根据视野源更新每个队伍的迷雾网格，只把本地队伍发生变化的Tile上传到渲染目标
+ * 服务器上其他队伍的网格通过 UFogReplicationComponent 以增量发送给对应的客户端
+ */
+UCLASS()
+class FOGOFWAR_API UFogOfWarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**										初始化迷雾
+	 * @param Origin						迷雾左下角的世界坐标
+	 * @param CellSize						每个格子的世界尺寸
+	 * @param GridSize						格子数量
+	 * @param RenderTarget					迷雾网格写入的渲染目标（R=可见，G=已探索）
+	 * @param BlendMaterial					可选，时间混合材质，使用 /ToolKitsMaterial/FogWar/FogTemporalBlend.ush
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void InitFog(FVector2D Origin, float CellSize, FIntPoint GridSize, UTextureRenderTarget2D* RenderTarget, UMaterialInterface* BlendMaterial = nullptr);
+
+	/**										注册视野源
+	 * @param Actor							提供视野的Actor
+	 * @param Radius						视野半径（世界单位）
+	 * @param Team							所属队伍
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void RegisterVisionSource(AActor* Actor, float Radius, uint8 Team = 0);
+
+	// 注销视野源
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void UnregisterVisionSource(AActor* Actor);
+
+	/**										设置时间混合的速度
+	 * 写入混合材质的 RevealSpeed 和 HideSpeed 参数
+	 * @param RevealSpeed					变亮速度（每秒）
+	 * @param HideSpeed						变暗速度（每秒）
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void SetFogBlendSpeed(float RevealSpeed = 8.f, float HideSpeed = 2.f);
+
+	/**										切换到GPU照亮
+	 * 开启后由Compute Shader直接写入渲染目标，不再更新CPU网格
+	 * 当前RHI不支持时（例如NullRHI）自动回退到CPU网格
+	 * 快照、增量、网络同步和可见性组件都读取CPU网格，GPU照亮时这些功能会被拒绝，
+	 * 已经注册了网络同步或可见性组件时不能开启
+	 * @param bEnable						是否开启
+	 * @param EdgeWidth						模糊边缘宽度（格子数）
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void SetGPURevealEnabled(bool bEnable, float EdgeWidth = 2.f);
+
+	// 当前是否使用GPU照亮
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	bool IsUsingGPUReveal() const;
+
+	// 保存已探索区域快照，可直接写入存档
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	TArray<uint8> SaveFogSnapshot() const;
+
+	// 从快照恢复已探索区域
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	bool LoadFogSnapshot(const TArray<uint8>& SnapshotData);
+
+	// 保存已探索区域快照到文件
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	bool SaveFogSnapshotToFile(const FString& FilePath) const;
+
+	// 通过内存映射从文件恢复已探索区域
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	bool LoadFogSnapshotFromFile(const FString& FilePath);
+
+	/**										生成逐帧增量（用于回放）
+	 * 第一次调用时相对全未探索状态，之后相对上一次调用
+	 * @return								增量数据
+	 */
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	TArray<uint8> MakeFogDelta();
+
+	// 应用逐帧增量
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	bool ApplyFogDelta(const TArray<uint8>& DeltaData);
+
+	// 设置本地显示的队伍
+	UFUNCTION(BlueprintCallable, Category="YC|战争迷雾")
+	void SetLocalTeam(uint8 Team);
+
+	// 获取本地显示的队伍
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	FORCEINLINE uint8 GetLocalTeam() const { return LocalTeam; }
+
+	// 注册网络同步组件（服务器）
+	void RegisterReplicationComponent(UFogReplicationComponent* Component);
+
+	// 注销网络同步组件（服务器）
+	void UnregisterReplicationComponent(UFogReplicationComponent* Component);
+
+	// 注册迷雾可见性组件
+	void RegisterVisibilityComponent(UFogVisibilityComponent* Component);
+
+	// 注销迷雾可见性组件
+	void UnregisterVisibilityComponent(UFogVisibilityComponent* Component);
+
+	// 应用服务器发来的增量（客户端），之后本地网格只由服务器驱动
+	bool ApplyReplicatedDelta(const FFogDeltaPacket& Packet);
+
+	// 获取队伍的迷雾网格，不存在时返回空
+	const FFogGrid* FindTeamGrid(uint8 Team) const;
+
+	// 获取显示用的迷雾纹理（有混合材质时为混合后的结果）
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	UTexture* GetFogTexture() const;
+
+	// 世界坐标转格子坐标
+	FIntPoint WorldToCell(const FVector& WorldLocation) const;
+
+	// 获取本地队伍的迷雾网格
+	FORCEINLINE const FFogGrid& GetGrid() const { return Grid; }
+
+protected:
+	// 更新网格
+	void UpdateGrid();
+
+	// 获取或创建队伍的迷雾网格
+	FFogGrid& GetOrAddTeamGrid(uint8 Team);
+
+	// 把各队伍变化的Tile分发给网络同步组件
+	void DistributeChangedTiles();
+
+	// 检查可见性组件，可见性翻转的组件在本帧统一应用
+	void UpdateVisibilityComponents();
+
+	// 计算组件所在格子是否可见
+	bool EvaluateFogVisibility(const UFogVisibilityComponent* Component) const;
+
+	// 将脏区上传到渲染目标
+	void UploadDirtyRegions();
+
+	// 在渲染线程执行GPU照亮
+	void DispatchGPUReveal();
+
+	// 绘制时间混合
+	void DrawTemporalBlend(float DeltaTime);
+
+	// 创建混合用的渲染目标
+	UTextureRenderTarget2D* CreateBlendTarget();
+
+	/**
+	 * 使用GPU照亮时拒绝依赖CPU网格的功能
+	 * @param Feature		功能名称（用于日志）
+	 * @return				是否被拒绝
+	 */
+	bool RejectInGPUReveal(const TCHAR* Feature) const;
+
+	// 迷雾渲染目标发生变化，重新开始混合
+	void RestartTemporalBlend();
+
+private:
+	// 本地队伍的迷雾网格（用于显示）
+	FFogGrid Grid;
+
+	// 其他队伍的迷雾网格（服务器）
+	TMap<uint8, FFogGrid> RemoteTeamGrids;
+
+	// 本地显示的队伍
+	uint8 LocalTeam = 0;
+
+	// 本地网格是否由服务器同步
+	bool bReceivesReplicatedFog = false;
+
+	// 网络同步组件
+	TArray<TWeakObjectPtr<UFogReplicationComponent>> ReplicationComponents;
+
+	// 等待首次检查的可见性组件
+	TArray<TWeakObjectPtr<UFogVisibilityComponent>> NewVisibilityComponents;
+
+	// 可移动的可见性组件，每帧检查
+	TArray<TWeakObjectPtr<UFogVisibilityComponent>> MovableVisibilityComponents;
+
+	// 静态的可见性组件，按Tile分桶，只在Tile变化时检查
+	TMap<int32, TArray<TWeakObjectPtr<UFogVisibilityComponent>>> StaticVisibilityComponents;
+
+	// 本帧可见性翻转的组件
+	TArray<UFogVisibilityComponent*> VisibilityChanges;
+
+	// 迷雾左下角的世界坐标
+	FVector2D FogOrigin = FVector2D::ZeroVector;
+
+	// 每个格子的世界尺寸
+	float FogCellSize = 100.f;
+
+	// 所有视野源
+	UPROPERTY()
+	TArray<FFogVisionSource> VisionSources;
+
+	// 网格写入的渲染目标
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> FogRenderTarget;
+
+	// 时间混合材质
+	UPROPERTY()
+	TObjectPtr<UMaterialInstanceDynamic> BlendMID;
+
+	// 时间混合的乒乓渲染目标
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> BlendTargets[2];
+
+	// 当前混合结果的下标
+	int32 BlendIndex = 0;
+
+	// 变亮速度（每秒）
+	float FogRevealSpeed = 8.f;
+
+	// 变暗速度（每秒）
+	float FogHideSpeed = 2.f;
+
+	// 混合收敛前剩余的时间，为0时跳过绘制
+	float BlendRemainingTime = 0.f;
+
+	// 是否请求GPU照亮
+	bool bGPUReveal = false;
+
+	// GPU照亮的模糊边缘宽度（格子数）
+	float GPUEdgeWidth = 2.f;
+
+	// 复用的脏区数组
+	TArray<FIntRect> DirtyRects;
+
+	// 逐帧增量的基准位平面
+	TBitArray<> DeltaBaseline;
+};
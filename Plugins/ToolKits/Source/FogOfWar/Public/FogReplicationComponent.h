@@ -0,0 +1,114 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "FogDeltaPacket.h"
+#include "FogReplicationComponent.generated.h"
+
+/**
+ * 战争迷雾网络同步组件
+ * 挂在 PlayerController 上，服务器只把该玩家所在队伍的迷雾增量发送给拥有者连接，
+ * 每帧发送的数据不超过字节预算，未发送完的Tile留到之后的帧
+ * 增量以不可靠RPC发送，客户端解码成功后回传包序号确认，
+ * 定期的关键帧只重发上个关键帧之前发出、仍未确认的Tile，静止的地图不会产生额外流量
+ */
+UCLASS(ClassGroup=(ToolKits), meta=(BlueprintSpawnableComponent))
+class FOGOFWAR_API UFogReplicationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFogReplicationComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// 设置队伍（服务器），切换队伍后会重新发送完整网格
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category="YC|战争迷雾")
+	void SetTeam(uint8 NewTeam);
+
+	// 获取队伍
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	FORCEINLINE uint8 GetTeam() const { return Team; }
+
+	// 获取最近一秒发送的字节数
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	FORCEINLINE float GetBytesPerSecond() const { return BytesPerSecond; }
+
+	// 累积待发送的Tile
+	void AccumulatePendingTiles(const TBitArray<>& ChangedTiles);
+
+protected:
+	// 接收迷雾增量，每帧发送，使用不可靠RPC避免丢包时占满可靠缓冲
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveFogDelta(const FFogDeltaPacket& Packet);
+
+	// 确认收到增量，丢失的确认只会让对应的Tile在关键帧时多发一次
+	UFUNCTION(Server, Unreliable)
+	void ServerAckFogDelta(uint16 Sequence);
+
+	// 客户端收到队伍
+	UFUNCTION()
+	void OnRep_Team();
+
+	// 所属队伍
+	UPROPERTY(EditAnywhere, ReplicatedUsing=OnRep_Team, Category="YC|战争迷雾", meta=(DisplayName = "队伍"))
+	uint8 Team = 0;
+
+	// 每帧字节预算，不可靠RPC超过一个数据包时会被拆分，丢失任意一片整个增量都会丢失
+	UPROPERTY(EditAnywhere, Category="YC|战争迷雾", meta=(DisplayName = "每帧字节预算", ClampMin = 16, ClampMax = 1024))
+	int32 BytesPerFrame = 512;
+
+	// 关键帧间隔（秒），到时重发上个关键帧之前发出、仍未确认的Tile，补齐丢包，0为不重发
+	UPROPERTY(EditAnywhere, Category="YC|战争迷雾", meta=(DisplayName = "关键帧间隔", ClampMin = 0.f))
+	float KeyframeInterval = 2.f;
+
+private:
+	// 是否需要向拥有者发送（服务器上的远程玩家）
+	bool ShouldSendToOwner() const;
+
+	// 是否为本地玩家
+	bool IsLocalOwner() const;
+
+	// 待发送的Tile
+	TBitArray<> PendingTiles;
+
+	// 已发送未确认的增量
+	struct FInFlightDelta
+	{
+		// 包内的Tile
+		TBitArray<> Tiles;
+
+		// 发送时的关键帧编号
+		uint32 Keyframe = 0;
+	};
+
+	// 重新发送完整网格，未确认的增量不再需要
+	void ResendAllTiles(int32 TileNum);
+
+	// 复用的增量包
+	FFogDeltaPacket OutgoingPacket;
+
+	// 已发送未确认的增量，按包序号索引
+	TMap<uint16, FInFlightDelta> InFlightDeltas;
+
+	// 下一个包序号
+	uint16 NextSequence = 0;
+
+	// 关键帧编号
+	uint32 KeyframeCount = 0;
+
+	// 距离上次关键帧的时间
+	float KeyframeTime = 0.f;
+
+	// 当前统计窗口内发送的字节数
+	int32 WindowBytes = 0;
+
+	// 当前统计窗口的时长
+	float WindowTime = 0.f;
+
+	// 最近一秒发送的字节数
+	float BytesPerSecond = 0.f;
+};
@@ -0,0 +1,74 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFogGrid;
+
+/**
+ * 迷雾快照文件头
+ * 文件布局为 文件头 + RLE数据，加载时可以直接映射文件内存解码，无需先拷贝
+ */
+struct FFogSnapshotHeader
+{
+	// 文件标识 'FOGS'
+	static constexpr uint32 SnapshotMagic = 0x53474F46;
+	// 当前版本
+	static constexpr uint32 SnapshotVersion = 1;
+
+	uint32 Magic = SnapshotMagic;
+	uint32 Version = SnapshotVersion;
+	int32 Width = 0;
+	int32 Height = 0;
+	uint32 PayloadSize = 0;
+	uint32 PayloadCrc = 0;
+};
+
+/**
+ * 迷雾快照
+ * 只保存已探索位平面，按 0/1 交替的游程长度以变长整数编码
+ * 增量同样使用游程编码，记录相对基准位平面发生翻转的格子
+ */
+struct FOGOFWAR_API FFogSnapshot
+{
+	// 网格大小
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	// RLE数据
+	TArray<uint8> Payload;
+
+	// 从网格编码快照
+	void Encode(const FFogGrid& Grid);
+
+	/**
+	 * 把快照解码回网格的已探索位平面
+	 * @return 网格大小不一致或数据损坏时返回false，此时网格保持不变
+	 */
+	bool Decode(FFogGrid& Grid) const;
+
+	/**
+	 * 编码相对基准的增量，并把基准更新为当前状态
+	 * @param Grid			当前网格
+	 * @param Baseline		基准位平面（每格一位），大小不一致时视为全零
+	 * @param OutDelta		增量数据
+	 */
+	static void EncodeDelta(const FFogGrid& Grid, TBitArray<>& Baseline, TArray<uint8>& OutDelta);
+
+	// 把增量应用到网格，数据损坏时返回false且网格保持不变
+	static bool ApplyDelta(FFogGrid& Grid, TConstArrayView<uint8> Delta);
+
+	// 保存到文件（单次写入）
+	bool SaveToFile(const FString& FilePath) const;
+
+	/**
+	 * 通过内存映射直接从文件解码到网格
+	 * 平台不支持内存映射时回退为读取整个文件
+	 */
+	static bool LoadFromFile(const FString& FilePath, FFogGrid& Grid);
+
+	// 序列化，用于存档，读取到不支持的版本时设置错误
+	friend FOGOFWAR_API FArchive& operator<<(FArchive& Ar, FFogSnapshot& Snapshot);
+
+private:
+	// 从RLE数据解码
+	static bool DecodePayload(FFogGrid& Grid, const uint8* Data, int64 DataSize);
+};
@@ -0,0 +1,100 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "FogVisibilityComponent.generated.h"
+
+class UPrimitiveComponent; // 图元组件
+
+// 迷雾可见规则
+UENUM(BlueprintType)
+enum class EFogVisibilityRule : uint8
+{
+	// 格子当前可见时才显示（单位）
+	Visible UMETA(DisplayName = "可见"),
+	// 格子探索过就显示（建筑、围栏）
+	Explored UMETA(DisplayName = "已探索"),
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFogVisibilityChanged, bool, bVisible);
+
+/**
+ * 迷雾可见性组件
+ * 由迷雾子系统在格子可见性翻转时批量通知，迷雾中的Actor只在本地隐藏图元，客户端的代理降低Tick
+ * 不修改复制的 bHidden，服务器上的模拟Tick不受影响，专用服务器只更新可见状态和广播事件
+ * 组件本身不Tick，静态Actor只在所在Tile变化时才会被检查
+ */
+UCLASS(ClassGroup=(ToolKits), meta=(BlueprintSpawnableComponent))
+class FOGOFWAR_API UFogVisibilityComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFogVisibilityComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 可见性变化
+	UPROPERTY(BlueprintAssignable, Category="YC|战争迷雾")
+	FOnFogVisibilityChanged OnFogVisibilityChanged;
+
+	// 当前是否在迷雾外
+	UFUNCTION(BlueprintPure, Category="YC|战争迷雾")
+	FORCEINLINE bool IsVisibleInFog() const { return bFogVisible; }
+
+	// 可见规则
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="YC|战争迷雾", meta=(DisplayName = "可见规则"))
+	EFogVisibilityRule Rule = EFogVisibilityRule::Visible;
+
+	// 是否会移动，不移动的Actor只在所在Tile变化时检查
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="YC|战争迷雾", meta=(DisplayName = "可移动"))
+	uint8 bMovable : 1;
+
+	// 在迷雾中隐藏，只隐藏本地的图元组件，不复制
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="YC|战争迷雾", meta=(DisplayName = "迷雾中隐藏"))
+	uint8 bHideInFog : 1;
+
+	// 在迷雾中降低Tick，只影响没有权威的代理（客户端），服务器和单机的模拟Tick保持不变
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="YC|战争迷雾", meta=(DisplayName = "迷雾中降低Tick"))
+	uint8 bThrottleTickInFog : 1;
+
+	// 迷雾中的Tick间隔，小于等于0时直接关闭Tick
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="YC|战争迷雾", meta=(DisplayName = "迷雾中Tick间隔", EditCondition = "bThrottleTickInFog"))
+	float FoggedTickInterval = 0.f;
+
+	// 应用可见性（由迷雾子系统批量调用）
+	void ApplyFogVisibility(bool bVisible);
+
+private:
+	// 迷雾子系统负责分桶
+	friend class UFogOfWarSubsystem;
+
+	// 所在Tile，静态Actor用于分桶
+	int32 FogTileIndex = INDEX_NONE;
+
+	// 当前是否在迷雾外
+	uint8 bFogVisible : 1;
+
+	// 是否需要改变表现，专用服务器没有本地视图
+	bool ShouldApplyPresentation() const;
+
+	/**
+	 * 隐藏或恢复本地的图元组件
+	 * @param Owner			所属的Actor
+	 * @param bHidden		是否隐藏
+	 */
+	void SetPrimitivesHidden(AActor* Owner, bool bHidden);
+
+	// 进入迷雾时由本组件隐藏的图元，离开迷雾时只恢复这些
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> FogHiddenPrimitives;
+
+	// 是否降低了Tick
+	uint8 bTickThrottled : 1;
+
+	// 进入迷雾前的Tick间隔
+	float DefaultTickInterval = 0.f;
+
+	// 进入迷雾前是否开启Tick
+	uint8 bDefaultTickEnabled : 1;
+};
@@ -0,0 +1,54 @@
+#include "ToolKits.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 用替换的时间来源驱动缓存过期和重试退避
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FToolKitsLicenseTimeTest, "ToolKits.License.TimeSource",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FToolKitsLicenseTimeTest::RunTest(const FString& Parameters)
+{
+	// 模拟的时钟，测试结束后恢复为本地时间
+	FDateTime Now(2025, 6, 1, 12, 0, 0);
+	FToolKitsModule::SetTimeSource([&Now]() { return Now; });
+	ON_SCOPE_EXIT { FToolKitsModule::SetTimeSource(nullptr); };
+	TestTrue(TEXT("使用替换的时间来源"), FToolKitsModule::GetNow() == Now);
+
+	// 退避从1秒开始翻倍，最长60秒，超过最大重试次数后不再重试
+	const TArray<float> ExpectedDelays = {1.f, 2.f, 4.f, 8.f, 16.f, 32.f, 60.f, 60.f, 60.f};
+	const FDateTime LastCheckTime = Now;
+	int32 RetryCount = 0;
+	for (float Delay = FToolKitsModule::GetRetryDelay(RetryCount + 1); Delay >= 0.f; Delay = FToolKitsModule::GetRetryDelay(RetryCount + 1))
+	{
+		++RetryCount;
+		if (RetryCount > ExpectedDelays.Num()) break;
+		TestEqual(*FString::Printf(TEXT("第 %d 次重试的等待时间"), RetryCount), Delay, ExpectedDelays[RetryCount - 1]);
+
+		// 时钟按退避时间前进
+		Now += FTimespan::FromSeconds(Delay);
+	}
+	TestEqual(TEXT("最大重试次数"), RetryCount, ExpectedDelays.Num());
+	TestTrue(TEXT("全部重试的总时长"), Now - LastCheckTime == FTimespan::FromSeconds(243));
+	TestTrue(TEXT("无效的重试次数"), FToolKitsModule::GetRetryDelay(0) < 0.f);
+
+	// 缓存有效期为一天，不传时间时使用替换的时间来源
+	TestTrue(TEXT("重试结束后缓存仍然有效"), FToolKitsModule::IsCacheFresh(LastCheckTime));
+	Now = LastCheckTime + FTimespan::FromDays(1) - FTimespan::FromSeconds(1);
+	TestTrue(TEXT("到期前一秒缓存有效"), FToolKitsModule::IsCacheFresh(LastCheckTime));
+	Now = LastCheckTime + FTimespan::FromDays(1);
+	TestFalse(TEXT("到期时缓存失效"), FToolKitsModule::IsCacheFresh(LastCheckTime));
+
+	// 许可证按替换的时间判断
+	Now = FDateTime(2025, 12, 31, 23, 59, 59);
+	TestTrue(TEXT("到期前许可证有效"), FToolKitsModule::IsLicenseValid());
+	Now = FDateTime(2026, 1, 1, 0, 0, 1);
+	TestFalse(TEXT("到期后许可证无效"), FToolKitsModule::IsLicenseValid());
+
+	// 恢复后使用本地时间
+	FToolKitsModule::SetTimeSource(nullptr);
+	TestTrue(TEXT("恢复为本地时间"), (FToolKitsModule::GetNow() - FDateTime::Now()).GetTotalSeconds() < 1.0);
+	return true;
+}
+
+#endif
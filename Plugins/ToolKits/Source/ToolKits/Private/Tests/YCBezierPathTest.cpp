@@ -0,0 +1,267 @@
+#include "YCBezierPath.h"
+#include "ToolFunctionLibrary.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace YCBezierPathTest
+{
+	// 先抬升再落下的三次曲线，X 单调递增
+	const TArray<FVector> ArcPoints = {FVector(0, 0, 0), FVector(1000, 0, 1500), FVector(3000, 500, 1500), FVector(4000, 500, 0)};
+
+	// 用 BezierCurve 密集采样累计弦长，作为参考长度
+	double ReferenceLength(const TArray<FVector>& Points, const int32 Steps)
+	{
+		double Length = 0.0;
+		FVector Previous = UToolFunctionLibrary::BezierCurve(Points, 0.f);
+		for (int32 i = 1; i <= Steps; ++i)
+		{
+			const FVector Current = UToolFunctionLibrary::BezierCurve(Points, static_cast<float>(i) / Steps);
+			Length += FVector::Dist(Previous, Current);
+			Previous = Current;
+		}
+		return Length;
+	}
+
+	// 点到折线的最近距离
+	double DistanceToPolyline(const FVector& Location, const TArray<FVector>& Polyline)
+	{
+		double BestDistanceSquared = FVector::DistSquared(Location, Polyline[0]);
+		for (int32 i = 1; i < Polyline.Num(); ++i)
+		{
+			BestDistanceSquared = FMath::Min(BestDistanceSquared, FMath::PointDistToSegmentSquared(Location, Polyline[i - 1], Polyline[i]));
+		}
+		return FMath::Sqrt(BestDistanceSquared);
+	}
+}
+
+// 多项式求值与 BezierCurve 一致，弧长单调，按距离求时间可以往返
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCBezierPathArcLengthTest, "ToolKits.Bezier.ArcLength",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCBezierPathArcLengthTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVector>& Points = YCBezierPathTest::ArcPoints;
+	FYCBezierPath Path;
+	Path.Build(Points);
+	TestTrue(TEXT("已构建"), Path.IsValid());
+
+	// 位置与德卡斯特里奥算法的参考实现一致
+	for (int32 i = 0; i <= 32; ++i)
+	{
+		const float Time = i / 32.f;
+		TestEqual(*FString::Printf(TEXT("时间 %.3f 的位置"), Time), Path.GetPositionAtTime(Time), UToolFunctionLibrary::BezierCurve(Points, Time), 0.01f);
+	}
+
+	// 64 段弧长表的长度与密集采样的长度相差不超过 0.1%
+	const double Reference = YCBezierPathTest::ReferenceLength(Points, 4096);
+	TestEqual(TEXT("曲线长度"), Path.GetLength(), static_cast<float>(Reference), static_cast<float>(Reference * 0.001));
+
+	// 距离随时间单调不减，按距离求时间再求距离得到原值
+	float PreviousDistance = 0.f;
+	for (int32 i = 0; i <= 1000; ++i)
+	{
+		const float Time = i / 1000.f;
+		const float Distance = Path.GetDistanceAtTime(Time);
+		if (Distance < PreviousDistance)
+		{
+			AddError(FString::Printf(TEXT("时间 %.3f 的距离 %.3f 小于前一个距离 %.3f"), Time, Distance, PreviousDistance));
+			break;
+		}
+		PreviousDistance = Distance;
+		TestEqual(*FString::Printf(TEXT("时间 %.3f 往返"), Time), Path.GetTimeAtDistance(Distance), Time, 1e-4f);
+	}
+	TestEqual(TEXT("终点距离"), Path.GetDistanceAtTime(1.f), Path.GetLength(), 1e-3f);
+
+	// 超出范围的距离被钳制到两端
+	TestEqual(TEXT("负距离"), Path.GetTimeAtDistance(-100.f), 0.f);
+	TestEqual(TEXT("超出长度"), Path.GetTimeAtDistance(Path.GetLength() + 100.f), 1.f, 1e-6f);
+
+	// 批量求时间与逐个求时间一致
+	TArray<float> Distances;
+	for (int32 i = 0; i <= 100; ++i)
+	{
+		Distances.Add(Path.GetLength() * i / 100.f);
+	}
+	TArray<float> Times;
+	Path.GetTimesAtSortedDistances(Distances, Times);
+	TestEqual(TEXT("批量数量"), Times.Num(), Distances.Num());
+	for (int32 i = 0; i < Distances.Num(); ++i)
+	{
+		TestEqual(*FString::Printf(TEXT("批量第 %d 个时间"), i), Times[i], Path.GetTimeAtDistance(Distances[i]), 1e-5f);
+	}
+
+	// 按距离均匀采样时，相邻点的间距接近平均间距
+	TArray<FVector> Samples;
+	Path.SamplePositions(33, true, Samples);
+	const float Spacing = Path.GetLength() / 32.f;
+	for (int32 i = 1; i < Samples.Num(); ++i)
+	{
+		TestEqual(*FString::Printf(TEXT("第 %d 段间距"), i), static_cast<float>(FVector::Dist(Samples[i - 1], Samples[i])), Spacing, Spacing * 0.01f);
+	}
+	return true;
+}
+
+// 展开后的折线与曲线的偏差不超过容差，容差越小点越多
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCBezierPathFlattenTest, "ToolKits.Bezier.Flatten",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCBezierPathFlattenTest::RunTest(const FString& Parameters)
+{
+	// 较平缓的曲线、急转弯的曲线和六阶曲线
+	const TArray<FVector> Curves[] =
+	{
+		YCBezierPathTest::ArcPoints,
+		{FVector(0, 0, 0), FVector(3000, 0, 0), FVector(3000, 3000, 0), FVector(0, 100, 0)},
+		{FVector(0, 0, 0), FVector(500, 800, 200), FVector(1200, -600, 0), FVector(1500, 900, -300), FVector(2200, -100, 400), FVector(2600, 700, 0), FVector(3000, 0, 0)},
+	};
+
+	for (int32 CurveIndex = 0; CurveIndex < UE_ARRAY_COUNT(Curves); ++CurveIndex)
+	{
+		const TArray<FVector>& Points = Curves[CurveIndex];
+		int32 PreviousNum = 0;
+		for (const float Tolerance : {25.f, 5.f, 1.f, 0.5f})
+		{
+			TArray<FVector> Polyline;
+			FYCBezierPath::FlattenPoints(Points, Tolerance, Polyline);
+			const FString Context = FString::Printf(TEXT("曲线 %d 容差 %.1f"), CurveIndex, Tolerance);
+
+			// 首尾与控制点重合
+			TestTrue(*(Context + TEXT(" 至少两个点")), Polyline.Num() >= 2);
+			if (Polyline.Num() < 2) continue;
+			TestEqual(*(Context + TEXT(" 起点")), Polyline[0], Points[0]);
+			TestEqual(*(Context + TEXT(" 终点")), Polyline.Last(), Points.Last());
+			TestTrue(*(Context + TEXT(" 点数不少于更大的容差")), Polyline.Num() >= PreviousNum);
+			PreviousNum = Polyline.Num();
+
+			// 曲线上的点到折线的距离不超过容差
+			double MaxDeviation = 0.0;
+			for (int32 i = 0; i <= 4096; ++i)
+			{
+				const FVector Location = UToolFunctionLibrary::BezierCurve(Points, i / 4096.f);
+				MaxDeviation = FMath::Max(MaxDeviation, YCBezierPathTest::DistanceToPolyline(Location, Polyline));
+			}
+			TestTrue(*FString::Printf(TEXT("%s 最大偏差 %.3f"), *Context, MaxDeviation), MaxDeviation <= Tolerance + 0.01);
+
+			// 折线的点都在曲线上
+			FYCBezierPath Path;
+			Path.Build(Points);
+			for (const FVector& Point : Polyline)
+			{
+				float Time;
+				FVector ClosestPoint;
+				Path.FindClosestPoint(Point, Time, ClosestPoint, 0.01f);
+				if (FVector::Dist(Point, ClosestPoint) > 0.1)
+				{
+					AddError(FString::Printf(TEXT("%s 折线的点 %s 不在曲线上"), *Context, *Point.ToString()));
+					break;
+				}
+			}
+		}
+	}
+
+	// 共线的控制点只输出首尾两个点
+	TArray<FVector> Polyline;
+	FYCBezierPath::FlattenPoints({FVector(0, 0, 0), FVector(100, 0, 0), FVector(300, 0, 0), FVector(1000, 0, 0)}, 1.f, Polyline);
+	TestEqual(TEXT("直线"), Polyline.Num(), 2);
+
+	// 没有控制点和只有一个控制点
+	FYCBezierPath::FlattenPoints({}, 1.f, Polyline);
+	TestEqual(TEXT("没有控制点"), Polyline.Num(), 0);
+	FYCBezierPath::FlattenPoints({FVector(5, 5, 5)}, 1.f, Polyline);
+	TestEqual(TEXT("一个控制点"), Polyline.Num(), 1);
+	return true;
+}
+
+// 最近点、平面、射线和包围盒查询与密集采样的结果一致
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCBezierPathQueryTest, "ToolKits.Bezier.Query",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCBezierPathQueryTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVector>& Points = YCBezierPathTest::ArcPoints;
+	FYCBezierPath Path;
+	Path.Build(Points);
+
+	// 密集采样作为参考
+	constexpr int32 SampleNum = 8192;
+	TArray<FVector> Samples;
+	for (int32 i = 0; i <= SampleNum; ++i)
+	{
+		Samples.Add(UToolFunctionLibrary::BezierCurve(Points, static_cast<float>(i) / SampleNum));
+	}
+
+	// 最近点不比密集采样的最近点远，且与返回的时间一致
+	constexpr float Tolerance = 1.f;
+	FRandomStream Random(40);
+	for (int32 Query = 0; Query < 200; ++Query)
+	{
+		const FVector Location = Random.RandPointInBox(Path.GetBounds().ExpandBy(1000.0));
+		double BestDistance = TNumericLimits<double>::Max();
+		for (const FVector& Sample : Samples)
+		{
+			BestDistance = FMath::Min(BestDistance, FVector::Dist(Location, Sample));
+		}
+
+		float Time;
+		FVector ClosestPoint;
+		TestTrue(TEXT("最近点查询成功"), Path.FindClosestPoint(Location, Time, ClosestPoint, Tolerance));
+		const double Distance = FVector::Dist(Location, ClosestPoint);
+		if (Distance > BestDistance + Tolerance)
+		{
+			AddError(FString::Printf(TEXT("%s 的最近点距离 %.3f，密集采样为 %.3f"), *Location.ToString(), Distance, BestDistance));
+			break;
+		}
+		TestEqual(TEXT("最近点与时间一致"), ClosestPoint, Path.GetPositionAtTime(Time), 0.01f);
+	}
+	float Time;
+	FVector Location;
+	TestFalse(TEXT("未构建时最近点查询失败"), FYCBezierPath().FindClosestPoint(FVector::ZeroVector, Time, Location));
+
+	// 平面：曲线先上升后下降，返回第一次穿过 Z=500 的点
+	const FPlane Plane(FVector::UpVector, 500.0);
+	int32 FirstCrossing = 1;
+	while (Samples[FirstCrossing].Z < 500.0)
+	{
+		++FirstCrossing;
+	}
+	TestTrue(TEXT("与平面相交"), Path.IntersectPlane(Plane, Time, Location, Tolerance));
+	TestEqual(TEXT("平面交点的高度"), static_cast<float>(Location.Z), 500.f, Tolerance);
+	TestEqual(TEXT("平面交点的时间"), Time, static_cast<float>(FirstCrossing) / SampleNum, 1e-3f);
+	TestTrue(TEXT("平面交点在曲线上"), YCBezierPathTest::DistanceToPolyline(Location, Samples) <= Tolerance + 0.01);
+	TestFalse(TEXT("高于曲线的平面不相交"), Path.IntersectPlane(FPlane(FVector::UpVector, 5000.0), Time, Location, Tolerance));
+
+	// 射线：沿 Y 轴穿过曲线上时间 0.3 的点，曲线的 X 单调，只有这一个交点
+	const FVector Target = Path.GetPositionAtTime(0.3f);
+	TestTrue(TEXT("与射线相交"), Path.IntersectRay(Target - FVector(0, 2000, 0), FVector::RightVector, 0.f, Time, Location, Tolerance));
+	TestEqual(TEXT("射线交点的时间"), Time, 0.3f, 1e-3f);
+	TestTrue(TEXT("射线交点靠近目标"), FVector::Dist(Location, Target) <= 3.0 * Tolerance);
+
+	// 带半径的射线从目标上方偏移 30 仍然命中，不带半径时不命中
+	const FVector Offset(0, 0, 30);
+	TestTrue(TEXT("带半径的射线相交"), Path.IntersectRay(Target + Offset - FVector(0, 2000, 0), FVector::RightVector, 50.f, Time, Location, Tolerance));
+	TestFalse(TEXT("不带半径的射线不相交"), Path.IntersectRay(Target + Offset - FVector(0, 2000, 0), FVector::RightVector, 0.f, Time, Location, Tolerance));
+
+	// 射线起点在曲线旁但方向背离曲线
+	TestFalse(TEXT("背离的射线不相交"), Path.IntersectRay(Target - FVector(0, 2000, 0), FVector::LeftVector, 0.f, Time, Location, Tolerance));
+	TestFalse(TEXT("方向为零不相交"), Path.IntersectRay(Target, FVector::ZeroVector, 0.f, Time, Location, Tolerance));
+
+	// 包围盒：返回第一次进入的时间，进入点在包围盒上
+	const FBox Box = FBox::BuildAABB(Target, FVector(50.0));
+	int32 FirstInside = 0;
+	while (!Box.IsInsideOrOn(Samples[FirstInside]))
+	{
+		++FirstInside;
+	}
+	TestTrue(TEXT("与包围盒重叠"), Path.IntersectsBox(Box, Time, Tolerance));
+	TestEqual(TEXT("进入包围盒的时间"), Time, static_cast<float>(FirstInside) / SampleNum, 1e-3f);
+	TestTrue(TEXT("进入点在包围盒上"), Box.ExpandBy(2.0 * Tolerance).IsInsideOrOn(Path.GetPositionAtTime(Time)));
+
+	// 包含起点的包围盒从时间 0 开始重叠，远处的包围盒不重叠
+	TestTrue(TEXT("包含起点的包围盒"), Path.IntersectsBox(FBox::BuildAABB(Points[0], FVector(10.0)), Time, Tolerance));
+	TestEqual(TEXT("包含起点的时间"), Time, 0.f);
+	TestFalse(TEXT("远处的包围盒"), Path.IntersectsBox(FBox::BuildAABB(FVector(2000, 5000, 0), FVector(100.0)), Time, Tolerance));
+	return true;
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "YCBezierTrajectoryBatch.h"
+#include "ToolFunctionLibrary.h"
+#include "Algo/IsSorted.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace YCBezierTrajectoryBatchTest
+{
+	// 一条弹道的参考数据
+	struct FTrajectory
+	{
+		TArray<FVector> Points;
+		float StartTime;
+		float Duration;
+	};
+
+	// 用 BezierCurve 计算 Time 时的参考位置
+	FVector ReferencePosition(const FTrajectory& Trajectory, const float Time)
+	{
+		const float Alpha = FMath::Clamp((Time - Trajectory.StartTime) / Trajectory.Duration, 0.f, 1.f);
+		return UToolFunctionLibrary::BezierCurve(Trajectory.Points, Alpha);
+	}
+
+	// 对比批量结果与参考位置，OutPositions 中 Num() 之后的元素必须保持哨兵值
+	void Compare(FAutomationTestBase& Test, const FYCBezierTrajectoryBatch& Batch, const TArray<FTrajectory>& Trajectories, const float Time, const bool bParallel)
+	{
+		const FVector Sentinel(-1234.0);
+		TArray<FVector> Positions;
+		Positions.Init(Sentinel, Batch.Num() + 4);
+		Batch.Evaluate(Time, Positions, bParallel);
+
+		for (int32 i = 0; i < Trajectories.Num(); ++i)
+		{
+			// 以原点为中心存为 float，允许 0.05 的误差
+			Test.TestEqual(*FString::Printf(TEXT("时间 %.2f 第 %d 条弹道"), Time, i), Positions[i], ReferencePosition(Trajectories[i], Time), 0.05f);
+		}
+		for (int32 i = Batch.Num(); i < Positions.Num(); ++i)
+		{
+			Test.TestEqual(*FString::Printf(TEXT("补齐部分不写入第 %d 个位置"), i), Positions[i], Sentinel);
+		}
+	}
+}
+
+// SIMD 批量求值与 BezierCurve 一致，二次曲线升阶，交换删除后补齐部分不影响结果
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYCBezierTrajectoryBatchTest, "ToolKits.Bezier.TrajectoryBatch",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FYCBezierTrajectoryBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace YCBezierTrajectoryBatchTest;
+
+	// 原点靠近弹道区域，13 条弹道，最后一组只有 1 条
+	const FVector Origin(100000.0, -50000.0, 0.0);
+	FYCBezierTrajectoryBatch Batch(Origin);
+	TArray<FTrajectory> Trajectories;
+	FRandomStream Random(13);
+	for (int32 i = 0; i < 13; ++i)
+	{
+		FTrajectory& Trajectory = Trajectories.AddDefaulted_GetRef();
+		const int32 PointNum = i % 3 == 0 ? 3 : 4;
+		for (int32 Point = 0; Point < PointNum; ++Point)
+		{
+			Trajectory.Points.Add(Origin + Random.GetUnitVector() * Random.FRandRange(0.f, 3000.f));
+		}
+		Trajectory.StartTime = Random.FRandRange(0.f, 1.f);
+		Trajectory.Duration = Random.FRandRange(0.5f, 2.f);
+
+		const TArray<FVector>& P = Trajectory.Points;
+		const int32 Index = PointNum == 3
+			                    ? Batch.AddQuadratic(P[0], P[1], P[2], Trajectory.StartTime, Trajectory.Duration)
+			                    : Batch.AddCubic(P[0], P[1], P[2], P[3], Trajectory.StartTime, Trajectory.Duration);
+		TestEqual(TEXT("弹道下标"), Index, i);
+	}
+	TestEqual(TEXT("弹道数量"), Batch.Num(), 13);
+
+	// 开始前、飞行中、结束后，单线程和多线程
+	for (const float Time : {-1.f, 0.5f, 1.f, 1.7f, 4.f})
+	{
+		Compare(*this, Batch, Trajectories, Time, false);
+		Compare(*this, Batch, Trajectories, Time, true);
+	}
+
+	// 变换只修改位置和旋转，保留缩放，朝向运动方向
+	TArray<FTransform> Transforms;
+	Transforms.Init(FTransform(FQuat::Identity, FVector::ZeroVector, FVector(2.0)), Batch.Num());
+	Batch.EvaluateTransforms(1.f, Transforms, true, false);
+	for (int32 i = 0; i < Trajectories.Num(); ++i)
+	{
+		const FTrajectory& Trajectory = Trajectories[i];
+		TestEqual(*FString::Printf(TEXT("第 %d 个变换的位置"), i), Transforms[i].GetLocation(), ReferencePosition(Trajectory, 1.f), 0.05f);
+		TestEqual(*FString::Printf(TEXT("第 %d 个变换的缩放"), i), Transforms[i].GetScale3D(), FVector(2.0));
+
+		const float Alpha = (1.f - Trajectory.StartTime) / Trajectory.Duration;
+		if (Alpha > 0.f && Alpha < 1.f)
+		{
+			const FVector Velocity = UToolFunctionLibrary::BezierCurve(Trajectory.Points, Alpha + 1e-3f) - UToolFunctionLibrary::BezierCurve(Trajectory.Points, Alpha - 1e-3f);
+			TestTrue(*FString::Printf(TEXT("第 %d 个变换朝向运动方向"), i), (Transforms[i].GetRotation().GetForwardVector() | Velocity.GetSafeNormal()) > 0.99);
+		}
+	}
+
+	// 已结束的弹道降序排列，按顺序交换删除后剩余弹道仍然正确
+	constexpr float FinishTime = 1.5f;
+	TArray<int32> Finished;
+	Batch.GetFinished(FinishTime, Finished);
+	TestTrue(TEXT("降序"), Algo::IsSorted(Finished, TGreater<int32>()));
+	for (int32 i = 0; i < Trajectories.Num(); ++i)
+	{
+		const bool bFinished = FinishTime >= Trajectories[i].StartTime + Trajectories[i].Duration;
+		TestTrue(*FString::Printf(TEXT("第 %d 条弹道是否结束"), i), Finished.Contains(i) == bFinished);
+	}
+	for (const int32 Index : Finished)
+	{
+		Batch.RemoveAtSwap(Index);
+		Trajectories.RemoveAtSwap(Index);
+	}
+	TestEqual(TEXT("删除后的数量"), Batch.Num(), Trajectories.Num());
+	for (const float Time : {0.5f, 1.f, 1.2f})
+	{
+		Compare(*this, Batch, Trajectories, Time, false);
+	}
+
+	// 删除到跨过组边界，补齐的系数必须为 0，新添加的弹道复用补齐位置
+	while (Batch.Num() > 5)
+	{
+		Batch.RemoveAtSwap(0);
+		Trajectories.RemoveAtSwap(0);
+	}
+	FTrajectory& Added = Trajectories.AddDefaulted_GetRef();
+	Added.Points = {Origin, Origin + FVector(500, 0, 800), Origin + FVector(1000, 0, 0)};
+	Added.StartTime = 0.f;
+	Added.Duration = 1.f;
+	TestEqual(TEXT("复用补齐位置"), Batch.AddQuadratic(Added.Points[0], Added.Points[1], Added.Points[2], Added.StartTime, Added.Duration), 5);
+	Compare(*this, Batch, Trajectories, 0.25f, true);
+
+	Batch.Reset();
+	TestEqual(TEXT("清空"), Batch.Num(), 0);
+	return true;
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 
 #include "ToolFunctionLibrary.h"
+#include "ToolKitsStats.h"
+#include "Components/InstancedStaticMeshComponent.h"
 
 // 有参构造函数
 UToolFunctionLibrary::UToolFunctionLibrary(const FObjectInitializer& ObjectInitializer)
@@ -12,6 +14,9 @@ UToolFunctionLibrary::UToolFunctionLibrary(const FObjectInitializer& ObjectIniti
 // 贝塞尔曲线
 FVector UToolFunctionLibrary::BezierCurve(TArray<FVector> Points, const float CurveTime, const float TotalTime)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UToolFunctionLibrary::BezierCurve);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_BezierCurve);
+
 	if (Points.IsEmpty()) return FVector::ZeroVector;
 
 	// 当输入的点长度小于等于一的时候，输出数组下标零
@@ -35,3 +40,125 @@ FVector UToolFunctionLibrary::BezierCurve(TArray<FVector> Points, const float Cu
 
 	return BezierCurve(PointsDelta, CurveTime, TotalTime);
 }
+
+// 创建预计算的贝塞尔曲线
+FYCBezierPath UToolFunctionLibrary::MakeBezierPath(const TArray<FVector>& Points, const int32 Resolution)
+{
+	FYCBezierPath Path;
+	Path.Build(Points, Resolution);
+	return Path;
+}
+
+// 获取贝塞尔曲线的长度
+float UToolFunctionLibrary::GetBezierPathLength(const FYCBezierPath& Path)
+{
+	return Path.GetLength();
+}
+
+// 获取曲线上距离对应的位置
+FVector UToolFunctionLibrary::GetBezierPathLocationAtDistance(const FYCBezierPath& Path, const float Distance)
+{
+	return Path.GetPositionAtDistance(Distance);
+}
+
+// 获取曲线上时间对应的位置和切线
+FVector UToolFunctionLibrary::GetBezierPathLocationAtTime(const FYCBezierPath& Path, const float Time, FVector& Tangent)
+{
+	Tangent = Path.GetTangentAtTime(Time);
+	return Path.GetPositionAtTime(Time);
+}
+
+// 批量采样曲线
+TArray<FVector> UToolFunctionLibrary::SampleBezierPath(const FYCBezierPath& Path, const int32 Count, const bool bConstantSpeed)
+{
+	TArray<FVector> Positions;
+	Path.SamplePositions(Count, bConstantSpeed, Positions);
+	return Positions;
+}
+
+// 查找曲线上离某点最近的点
+FVector UToolFunctionLibrary::FindClosestPointOnBezierPath(const FYCBezierPath& Path, const FVector& Location, float& Time, const float Tolerance)
+{
+	FVector ClosestPoint;
+	Path.FindClosestPoint(Location, Time, ClosestPoint, Tolerance);
+	return ClosestPoint;
+}
+
+// 查找曲线与平面的第一个交点
+bool UToolFunctionLibrary::IntersectBezierPathWithPlane(const FYCBezierPath& Path, const FVector& PlaneOrigin, const FVector& PlaneNormal, float& Time, FVector& Location, const float Tolerance)
+{
+	Time = 0.f;
+	Location = FVector::ZeroVector;
+	if (PlaneNormal.IsNearlyZero()) return false;
+	return Path.IntersectPlane(FPlane(PlaneOrigin, PlaneNormal.GetSafeNormal()), Time, Location, Tolerance);
+}
+
+// 查找曲线与射线的第一个交点
+bool UToolFunctionLibrary::IntersectBezierPathWithRay(const FYCBezierPath& Path, const FVector& RayOrigin, const FVector& RayDirection, const float Radius, float& Time, FVector& Location, const float Tolerance)
+{
+	Time = 0.f;
+	Location = FVector::ZeroVector;
+	return Path.IntersectRay(RayOrigin, RayDirection, Radius, Time, Location, Tolerance);
+}
+
+// 曲线是否与包围盒重叠
+bool UToolFunctionLibrary::BezierPathOverlapsBox(const FYCBezierPath& Path, const FBox& Box, float& Time, const float Tolerance)
+{
+	Time = 0.f;
+	return Path.IntersectsBox(Box, Time, Tolerance);
+}
+
+// 获取贝塞尔曲线的包围盒
+FBox UToolFunctionLibrary::GetBezierPathBounds(const FYCBezierPath& Path)
+{
+	return Path.GetBounds();
+}
+
+// 自适应展开贝塞尔曲线为折线
+TArray<FVector> UToolFunctionLibrary::FlattenBezierCurve(const TArray<FVector>& Points, const float Tolerance)
+{
+	TArray<FVector> Polyline;
+	FYCBezierPath::FlattenPoints(Points, Tolerance, Polyline);
+	return Polyline;
+}
+
+// 用展开后的贝塞尔曲线设置样条线的点
+int32 UToolFunctionLibrary::SetSplineFromBezierCurve(USplineComponent* Spline, const TArray<FVector>& Points, const float Tolerance, const ESplineCoordinateSpace::Type CoordinateSpace)
+{
+	if (Spline == nullptr) return 0;
+
+	TArray<FVector> Polyline;
+	FYCBezierPath::FlattenPoints(Points, Tolerance, Polyline);
+	Spline->SetSplinePoints(Polyline, CoordinateSpace, true);
+	return Polyline.Num();
+}
+
+// 在展开后的贝塞尔曲线的每个点添加实例
+int32 UToolFunctionLibrary::AddInstancesAlongBezierCurve(UInstancedStaticMeshComponent* Component, const TArray<FVector>& Points, const float Tolerance)
+{
+	if (Component == nullptr) return 0;
+
+	TArray<FVector> Polyline;
+	FYCBezierPath::FlattenPoints(Points, Tolerance, Polyline);
+	if (Polyline.IsEmpty()) return 0;
+
+	// 每个点朝向下一个点，最后一个点沿用前一段的方向
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Polyline.Num());
+	FQuat Rotation = FQuat::Identity;
+	for (int32 i = 0; i < Polyline.Num(); ++i)
+	{
+		if (i + 1 < Polyline.Num())
+		{
+			const FVector Direction = Polyline[i + 1] - Polyline[i];
+			if (!Direction.IsNearlyZero())
+			{
+				Rotation = Direction.ToOrientationQuat();
+			}
+		}
+		Transforms.Emplace(Rotation, Polyline[i]);
+	}
+
+	Component->AddInstances(Transforms, false, true);
+	return Transforms.Num();
+}
@@ -2,6 +2,7 @@
 
 #include "ToolKits.h"
 
+#include "Async/Async.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
@@ -10,9 +11,11 @@
 #include "YC_Log.h"
 #include "Logging/LogMacros.h"
 
+#include "Misc/Crc.h"
 #include "Misc/Paths.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopeRWLock.h"
 
 #define LOCTEXT_NAMESPACE "FToolKitsModule"
 
@@ -31,40 +34,73 @@ static constexpr int32 MaxRetryCount = 9;
 // 当前网络重试次数
 static int32 CurrentRetryCount = 0;
 
+// 第一次重试的等待时间（秒），之后每次翻倍
+static constexpr float RetryBaseDelay = 1.f;
+
+// 重试的最长等待时间（秒）
+static constexpr float RetryMaxDelay = 60.f;
+
+// 单次网络请求的超时时间（秒）
+static constexpr float RequestTimeout = 10.f;
+
+// 替换的时间来源，后台线程也会读取，替换时整体交换指针
+static TSharedPtr<TFunction<FDateTime()>, ESPMode::ThreadSafe> TimeSource;
+
+// 保护 TimeSource 的读写
+static FRWLock TimeSourceLock;
+
 void FToolKitsModule::StartupModule()
 {
 	LoadConfig();
+	// 启动日志后台线程
+	YCLog::StartBackend();
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	YICHEN_LOG(Warning, "当前自定义打印的时间：%s", *FDateTime::Now().ToString());
-	// 读取缓存数据
-	LoadCache();
+	YICHEN_LOG(Warning, "当前自定义打印的时间：%s", *GetNow().ToString());
+	// 在后台读取缓存数据，读取完成后在游戏线程开始验证，不阻塞模块加载
+	LoadCacheFuture = Async(EAsyncExecution::ThreadPool, [this]() { LoadCache(); });
+	ValidationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FToolKitsModule::TickWaitForCache));
 }
 
 void FToolKitsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	// 停止验证
+	FTSTicker::GetCoreTicker().RemoveTicker(ValidationTickerHandle);
+	if (PendingRequest.IsValid())
+	{
+		PendingRequest->OnProcessRequestComplete().Unbind();
+		PendingRequest->CancelRequest();
+		PendingRequest.Reset();
+	}
+	if (LoadCacheFuture.IsValid())
+	{
+		LoadCacheFuture.Wait();
+	}
 	// 保存缓存数据
 	SaveCache();
+	// 停止日志后台线程，输出剩余日志
+	YCLog::StopBackend();
 }
 
 // 许可证有效性检查
 void FToolKitsModule::CheckLicenseValidity()
 {
 	// 检查缓存是否有效
-	if (CachedLicenseValid && FDateTime::Now() - LastCheckTime < FTimespan::FromSeconds(CacheDuration))
+	if (CachedLicenseValid && IsCacheFresh(LastCheckTime))
 	{
-		YICHEN_LOG(Display, "缓存有效！！！");
+		YICHEN_CLOG(License, Display, "缓存有效！！！");
 		Authorization(IsLicenseValid(LastCheckTime));
 		return;
 	}
 	else
 	{
-		YICHEN_LOG(Warning, "缓存无效！！！");
+		YICHEN_CLOG(License, Warning, "缓存无效！！！");
 	}
 
 	// 创建一个HTTP请求对象 这里使用的是UE的HTTP模块
 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	PendingRequest = Request;
 
 	// 设置请求的URL。这个URL指向一个可以返回当前UTC时间的API
 	Request->SetURL(TEXT("https://worldtimeapi.org/api/timezone/Etc/UTC"));
@@ -72,6 +108,9 @@ void FToolKitsModule::CheckLicenseValidity()
 	// 设置请求的方法为GET，表示这是一个获取数据的请求。
 	Request->SetVerb(TEXT("GET"));
 
+	// 离线环境下尽快失败，交给退避重试
+	Request->SetTimeout(RequestTimeout);
+
 	// 绑定一个回调函数，这个函数会在HTTP请求完成时被调用。
 	// BindRaw需要两个参数，第一个是要绑定的对象，第二个是成员函数指针。
 	// 当请求完成时，无论成功还是失败，OnTimeResponseReceived都会被调用。
@@ -84,7 +123,8 @@ void FToolKitsModule::CheckLicenseValidity()
 // HTTP请求完成时的回调函数
 void FToolKitsModule::OnTimeResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
-	YICHEN_LOG(Log, "正在进行(%d/%d)验证..", CurrentRetryCount, MaxRetryCount);
+	PendingRequest.Reset();
+	YICHEN_CLOG(License, Log, "正在进行(%d/%d)验证..", CurrentRetryCount, MaxRetryCount);
 	if (bWasSuccessful && Response.IsValid())
 	{
 		// 解析响应中的时间
@@ -101,14 +141,14 @@ void FToolKitsModule::OnTimeResponseReceived(FHttpRequestPtr Request, FHttpRespo
 			{
 				// 比较网络时间和许可证到期时间
 				CachedLicenseValid = true;
+				bCacheDirty = true;
 				LastCheckTime = NewTime.UtcNow() + FTimespan(8, 0, 0); // 加8时区
+				CurrentRetryCount = 0;
 				Authorization(IsLicenseValid(LastCheckTime));
-			}
-			else
-			{
-				RerequestNetwork();
+				return;
 			}
 		}
+		RerequestNetwork();
 	}
 	else
 	{
@@ -116,6 +156,31 @@ void FToolKitsModule::OnTimeResponseReceived(FHttpRequestPtr Request, FHttpRespo
 	}
 }
 
+// 获取当前时间
+FDateTime FToolKitsModule::GetNow()
+{
+	TSharedPtr<TFunction<FDateTime()>, ESPMode::ThreadSafe> CurrentSource;
+	{
+		FReadScopeLock ReadLock(TimeSourceLock);
+		CurrentSource = TimeSource;
+	}
+	// 在锁外调用，时间来源内部替换自己也不会死锁
+	return CurrentSource.IsValid() ? (*CurrentSource)() : FDateTime::Now();
+}
+
+// 替换时间来源
+void FToolKitsModule::SetTimeSource(TFunction<FDateTime()> InTimeSource)
+{
+	TSharedPtr<TFunction<FDateTime()>, ESPMode::ThreadSafe> NewSource;
+	if (InTimeSource)
+	{
+		NewSource = MakeShared<TFunction<FDateTime()>, ESPMode::ThreadSafe>(MoveTemp(InTimeSource));
+	}
+
+	FWriteScopeLock WriteLock(TimeSourceLock);
+	TimeSource = MoveTemp(NewSource);
+}
+
 // 检查许可证是否有效
 bool FToolKitsModule::IsLicenseValid(FDateTime CurrentDate)
 {
@@ -130,13 +195,28 @@ bool FToolKitsModule::IsLicenseValid(FDateTime CurrentDate)
 	return CurrentDate <= ExpiryDate;
 }
 
+// 缓存是否仍在有效期内
+bool FToolKitsModule::IsCacheFresh(const FDateTime InLastCheckTime, const FDateTime CurrentDate)
+{
+	return CurrentDate - InLastCheckTime < FTimespan::FromSeconds(CacheDuration);
+}
+
+// 获取重试前的等待时间
+float FToolKitsModule::GetRetryDelay(const int32 RetryCount)
+{
+	if (RetryCount < 1 || RetryCount > MaxRetryCount) return -1.f;
+
+	// 指数退避，避免网络不可用时连续请求
+	return FMath::Min(RetryBaseDelay * static_cast<float>(1 << FMath::Min(RetryCount - 1, 30)), RetryMaxDelay);
+}
+
 // 授权
 void FToolKitsModule::Authorization(bool bValid)
 {
 	// 判断授权
 	if (bValid)
 	{
-		YICHEN_LOG(Display, "插件授权有效！！！");
+		YICHEN_CLOG(License, Display, "插件授权有效！！！");
 	}
 	else
 	{
@@ -144,7 +224,7 @@ void FToolKitsModule::Authorization(bool bValid)
 			                     "\tPlease contact the plug author for permission！！！\n"
 			                     "\t(请联系插头作者获得许可！！！) \n"
 			                     "\t2394439184@qq.com")));
-		YICHEN_LOG(Error, "插件授权无效");
+		YICHEN_CLOG(License, Error, "插件授权无效");
 
 		FGenericPlatformMisc::RequestExit(false);
 	}
@@ -154,68 +234,98 @@ void FToolKitsModule::Authorization(bool bValid)
 void FToolKitsModule::RerequestNetwork()
 {
 	// 重新请求
-	if (CurrentRetryCount < MaxRetryCount)
+	const float Delay = GetRetryDelay(CurrentRetryCount + 1);
+	if (Delay >= 0.f)
 	{
 		CurrentRetryCount++;
-		YICHEN_LOG(Warning, "请求失败，正在重试...（%d/%d）", CurrentRetryCount, MaxRetryCount);
-		CheckLicenseValidity();
+		YICHEN_CLOG(License, Warning, "请求失败，%.0f 秒后重试...（%d/%d）", Delay, CurrentRetryCount, MaxRetryCount);
+		ValidationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FToolKitsModule::TickRetry), Delay);
 	}
 	else
 	{
-		YICHEN_LOG(Error, "无法获取网络时间");
+		YICHEN_CLOG(License, Error, "无法获取网络时间");
 		Authorization(IsLicenseValid());
 	}
 }
 
-// 简单的XOR加密/解密函数
-FString XorEncryptDecrypt(const FString& Input, const FString& Key)
+// 缓存读取完成后开始验证
+bool FToolKitsModule::TickWaitForCache(float DeltaTime)
 {
-	FString Output;
-	for (int32 i = 0; i < Input.Len(); ++i)
-	{
-		// 获取当前字符
-		const TCHAR InputChar = Input[i];
-		// 获取对应的密钥字符，循环使用密钥
-		const TCHAR KeyChar = Key[i % Key.Len()];
-		// 进行XOR操作
-		const TCHAR EncryptedChar = InputChar ^ KeyChar;
-		// 将结果添加到输出字符串
-		Output += EncryptedChar;
-	}
-	return Output;
+	if (!LoadCacheFuture.IsReady()) return true;
+
+	CheckLicenseValidity();
+	return false;
 }
 
-// 写入加密数据
-void FToolKitsModule::EncryptingData() const
+// 退避结束后重新验证
+bool FToolKitsModule::TickRetry(float DeltaTime)
 {
-	// 将布尔值和时间转换为字符串
-	FString ValidStr = CachedLicenseValid ? TEXT("1") : TEXT("0");
-	FString TimeStr = LastCheckTime.ToString();
+	CheckLicenseValidity();
+	return false;
+}
 
-	YICHEN_LOG(Display, "保存的时间：%s", *LastCheckTime.ToString());
+// 缓存文件标识
+static constexpr uint32 CacheMagic = 0x48434B54; // "TKCH"
 
-	// 将字符串连接起来
-	FString Data = ValidStr + TEXT("\n") + TimeStr;
-	// 使用XOR加密
-	FString EncryptedData = XorEncryptDecrypt(Data, MyKey);
+// 缓存文件版本
+static constexpr uint16 CacheVersion = 1;
 
-	// 将加密后的数据保存到文件
-	FFileHelper::SaveStringToFile(EncryptedData, *FilePath);
+/**
+ * 缓存记录，整条记录一次性读写
+ */
+struct FToolKitsCacheRecord
+{
+	// 文件标识
+	uint32 Magic = CacheMagic;
+	// 版本
+	uint16 Version = CacheVersion;
+	// 许可证是否有效
+	uint8 bValid = 0;
+	// 保留
+	uint8 Reserved0 = 0;
+	// 上次检查时间
+	int64 Ticks = 0;
+	// 前面所有字段的校验
+	uint32 Crc = 0;
+	// 保留
+	uint32 Reserved1 = 0;
+
+	// 计算校验
+	uint32 CalculateCrc() const { return FCrc::MemCrc32(this, STRUCT_OFFSET(FToolKitsCacheRecord, Crc)); }
+};
+static_assert(sizeof(FToolKitsCacheRecord) == 24, "缓存记录大小不能改变，修改结构时请增加版本");
+
+// 简单的XOR加密/解密，直接在字节上进行
+static void XorEncryptDecrypt(uint8* Data, const int32 Num, const FString& Key)
+{
+	const int32 KeyLen = Key.Len();
+	for (int32 i = 0; i < Num; ++i)
+	{
+		// 循环使用密钥
+		Data[i] ^= static_cast<uint8>(Key[i % KeyLen]);
+	}
 }
 
 // 保存缓存数据
 void FToolKitsModule::SaveCache() const
 {
-	// 确保目录存在
-	if (!FPaths::FileExists(FilePath))
-	{
-		FFileHelper::SaveStringToFile(TEXT(""), *FilePath, FFileHelper::EEncodingOptions::ForceUTF8);
-		YICHEN_LOG(Log, "%s\t缓存文件创建成功: %s", *FDateTime::Now().ToString(), *FilePath);
-		EncryptingData();
-	}
-	else
+	// 没有新的验证结果时不写文件
+	if (!bCacheDirty || FilePath.IsEmpty()) return;
+
+	FToolKitsCacheRecord Record;
+	Record.bValid = CachedLicenseValid ? 1 : 0;
+	Record.Ticks = LastCheckTime.GetTicks();
+	Record.Crc = Record.CalculateCrc();
+
+	YICHEN_CLOG(License, Display, "保存的时间：%s", *LastCheckTime.ToString());
+
+	// 使用XOR加密后一次性写入（目录不存在时会自动创建）
+	uint8* Data = reinterpret_cast<uint8*>(&Record);
+	XorEncryptDecrypt(Data, sizeof(Record), MyKey);
+
+	if (FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(Data, sizeof(Record)), *FilePath))
 	{
-		EncryptingData();
+		YICHEN_CLOG(License, Log, "%s\t缓存文件保存成功: %s", *GetNow().ToString(), *FilePath);
 	}
 }
 
@@ -225,34 +335,34 @@ void FToolKitsModule::LoadCache()
 	// 保存路径
 	Path = FPaths::Combine(FPaths::ProjectPluginsDir(),TEXT("ToolKits/Saved"));
 	// 缓存文件名称
-	CacheFileName = TEXT("ToolKitsCache.ini");
+	CacheFileName = TEXT("ToolKitsCache.bin");
 	// 缓存文件路径
 	FilePath = FPaths::Combine(Path, CacheFileName);
 
-	if (FPaths::FileExists(FilePath))
+	// 一次性读取整条记录
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath, FILEREAD_Silent)) return;
+	if (Data.Num() != sizeof(FToolKitsCacheRecord))
 	{
-		// 从文件中读取加密后的数据
-		FString EncryptedData;
-		if (FFileHelper::LoadFileToString(EncryptedData, *FilePath))
-		{
-			// 使用XOR解密
-			FString DecryptedData = XorEncryptDecrypt(*EncryptedData, MyKey);
-
-			// 解析数据
-			TArray<FString> Parts;
-			DecryptedData.ParseIntoArray(Parts,TEXT("\n"), true);
-			if (Parts.Num() == 2)
-			{
-				CachedLicenseValid = Parts[0] == TEXT("1");
+		YICHEN_CLOG(License, Warning, "缓存文件大小无效: %s", *FilePath);
+		return;
+	}
 
-				FDateTime::Parse(*Parts[1], LastCheckTime);
+	// 使用XOR解密
+	XorEncryptDecrypt(Data.GetData(), Data.Num(), MyKey);
 
-				YICHEN_LOG(Display, "读取的时间：%s\t当前时间%s", *LastCheckTime.ToString(), *FDateTime::Now().ToString());
-			}
-		}
+	FToolKitsCacheRecord Record;
+	FMemory::Memcpy(&Record, Data.GetData(), sizeof(Record));
+	if (Record.Magic != CacheMagic || Record.Version != CacheVersion || Record.Crc != Record.CalculateCrc())
+	{
+		YICHEN_CLOG(License, Warning, "缓存文件无效: %s", *FilePath);
+		return;
 	}
-	// 检查许可证有效性
-	CheckLicenseValidity();
+
+	CachedLicenseValid = Record.bValid != 0;
+	LastCheckTime = FDateTime(Record.Ticks);
+
+	YICHEN_CLOG(License, Display, "读取的时间：%s\t当前时间%s", *LastCheckTime.ToString(), *GetNow().ToString());
 }
 
 /*// 创建文件
@@ -270,7 +380,7 @@ void FToolKitsModule::CreateFiles(const FString& Path, const FString& FileName)
 
 		// 创建文件
 		FFileHelper::SaveStringToFile(TEXT(""), *FilePath);
-		YICHEN_LOG( Display, "创建成功！！！");
+		YICHEN_CLOG(License, Display, "创建成功！！！");
 		return;
 	}
 }*/
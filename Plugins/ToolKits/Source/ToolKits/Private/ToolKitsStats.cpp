@@ -0,0 +1,29 @@
+#include "ToolKitsStats.h"
+
+// 围栏
+DEFINE_STAT(STAT_ToolKits_GeneratingFences);
+DEFINE_STAT(STAT_ToolKits_AddDisplayModel);
+DEFINE_STAT(STAT_ToolKits_FenceHidden);
+DEFINE_STAT(STAT_ToolKits_FenceTransformsTask);
+DEFINE_STAT(STAT_ToolKits_FenceComponentsTask);
+DEFINE_STAT(STAT_ToolKits_FenceInstancesTask);
+DEFINE_STAT(STAT_ToolKits_FenceSpawnTask);
+DEFINE_STAT(STAT_ToolKits_HelicalSplineTask);
+DEFINE_STAT(STAT_ToolKits_FenceHiddenTask);
+DEFINE_STAT(STAT_ToolKits_FenceGenerationSchedule);
+
+DEFINE_STAT(STAT_ToolKits_FencePostsSpawned);
+DEFINE_STAT(STAT_ToolKits_FenceInstancesAdded);
+DEFINE_STAT(STAT_ToolKits_FenceInstancesUpdated);
+DEFINE_STAT(STAT_ToolKits_FenceInstancesRemoved);
+DEFINE_STAT(STAT_ToolKits_FenceAnimationsActive);
+
+// 函数库
+DEFINE_STAT(STAT_ToolKits_BezierCurve);
+
+// 战争迷雾
+DEFINE_STAT(STAT_ToolKits_FogUpdate);
+DEFINE_STAT(STAT_ToolKits_FogVisibility);
+DEFINE_STAT(STAT_ToolKits_FogUpload);
+
+DEFINE_STAT(STAT_ToolKits_FogCellsUpdated);
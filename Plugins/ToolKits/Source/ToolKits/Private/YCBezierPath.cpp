@@ -0,0 +1,569 @@
+#include "YCBezierPath.h"
+#include "ToolKitsStats.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+
+// 展开时的最大细分深度
+static constexpr int32 MaxFlattenDepth = 16;
+
+// 构建时缓存包围盒的分段数
+static constexpr int32 BoundsPieceNum = 8;
+
+// 德卡斯特里奥算法在 T 处细分，Left/Right 各写入 ControlPoints.Num() 个点，Scratch 会被修改
+static void SplitControlPoints(TArrayView<FVector> Scratch, const double T, FVector* Left, FVector* Right)
+{
+	const int32 Degree = Scratch.Num() - 1;
+	Left[0] = Scratch[0];
+	Right[Degree] = Scratch[Degree];
+	for (int32 k = 1; k <= Degree; ++k)
+	{
+		for (int32 i = 0; i <= Degree - k; ++i)
+		{
+			Scratch[i] = FMath::Lerp(Scratch[i], Scratch[i + 1], T);
+		}
+		Left[k] = Scratch[0];
+		Right[Degree - k] = Scratch[Degree - k];
+	}
+}
+
+// 构建曲线
+void FYCBezierPath::Build(const TArray<FVector>& InPoints, const int32 InResolution)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::Build);
+
+	Points = InPoints;
+	Coefficients.Reset();
+	DerivativeCoefficients.Reset();
+	ArcLengths.Reset();
+	Bounds.Init();
+	PieceControlPoints.Reset();
+	PieceBounds.Reset();
+	if (Points.IsEmpty()) return;
+
+	// 伯恩斯坦基转换为幂基：C[j] = C(n,j) * Σ(-1)^(j-i) * C(j,i) * P[i]
+	const int32 Degree = Points.Num() - 1;
+	Coefficients.SetNumUninitialized(Degree + 1);
+	double BinomialNJ = 1.0;
+	for (int32 j = 0; j <= Degree; ++j)
+	{
+		FVector Sum = FVector::ZeroVector;
+		double BinomialJI = 1.0;
+		for (int32 i = 0; i <= j; ++i)
+		{
+			const double Sign = ((j - i) & 1) ? -1.0 : 1.0;
+			Sum += Points[i] * (Sign * BinomialJI);
+			BinomialJI = BinomialJI * (j - i) / (i + 1);
+		}
+		Coefficients[j] = Sum * BinomialNJ;
+		BinomialNJ = BinomialNJ * (Degree - j) / (j + 1);
+	}
+
+	// 导数系数
+	DerivativeCoefficients.SetNumUninitialized(FMath::Max(Degree, 1));
+	DerivativeCoefficients[0] = FVector::ZeroVector;
+	for (int32 j = 1; j <= Degree; ++j)
+	{
+		DerivativeCoefficients[j - 1] = Coefficients[j] * j;
+	}
+
+	// 弧长表：按时间均匀分段，累计弦长
+	const int32 Resolution = FMath::Max(InResolution, 1);
+	ArcLengths.SetNumUninitialized(Resolution + 1);
+	ArcLengths[0] = 0.f;
+	FVector Previous = Points[0];
+	for (int32 i = 1; i <= Resolution; ++i)
+	{
+		const FVector Current = GetPositionAtTime(static_cast<float>(i) / Resolution);
+		ArcLengths[i] = ArcLengths[i - 1] + FVector::Dist(Previous, Current);
+		Previous = Current;
+	}
+
+	// 按时间均分为几段，每段的控制点包含该段曲线（凸包性质），用来给查询剪枝
+	const int32 PointNum = Points.Num();
+	PieceControlPoints.SetNumUninitialized(PointNum * BoundsPieceNum);
+	PieceBounds.Reset(BoundsPieceNum);
+	TArray<FVector, TInlineAllocator<16>> Remaining(Points);
+	TArray<FVector, TInlineAllocator<16>> Right;
+	Right.SetNumUninitialized(PointNum);
+	for (int32 Piece = 0; Piece < BoundsPieceNum; ++Piece)
+	{
+		FVector* PieceData = PieceControlPoints.GetData() + Piece * PointNum;
+		if (Piece + 1 < BoundsPieceNum)
+		{
+			// 剩余部分的时间范围为 [Piece/N, 1]，从中切下 1/(N-Piece)
+			SplitControlPoints(Remaining, 1.0 / (BoundsPieceNum - Piece), PieceData, Right.GetData());
+			Remaining = Right;
+		}
+		else
+		{
+			FMemory::Memcpy(PieceData, Remaining.GetData(), PointNum * sizeof(FVector));
+		}
+		Bounds += PieceBounds.Add_GetRef(FBox(PieceData, PointNum));
+	}
+}
+
+// 获取时间对应的位置
+FVector FYCBezierPath::GetPositionAtTime(const float Time) const
+{
+	if (Coefficients.IsEmpty()) return FVector::ZeroVector;
+
+	// 霍纳法则
+	const double T = FMath::Clamp(Time, 0.f, 1.f);
+	FVector Result = Coefficients.Last();
+	for (int32 j = Coefficients.Num() - 2; j >= 0; --j)
+	{
+		Result = Result * T + Coefficients[j];
+	}
+	return Result;
+}
+
+// 获取时间对应的切线
+FVector FYCBezierPath::GetTangentAtTime(const float Time) const
+{
+	if (DerivativeCoefficients.IsEmpty()) return FVector::ZeroVector;
+
+	const double T = FMath::Clamp(Time, 0.f, 1.f);
+	FVector Result = DerivativeCoefficients.Last();
+	for (int32 j = DerivativeCoefficients.Num() - 2; j >= 0; --j)
+	{
+		Result = Result * T + DerivativeCoefficients[j];
+	}
+	return Result;
+}
+
+// 获取时间对应的距离
+float FYCBezierPath::GetDistanceAtTime(const float Time) const
+{
+	if (ArcLengths.Num() < 2) return 0.f;
+
+	const int32 Resolution = ArcLengths.Num() - 1;
+	const float Scaled = FMath::Clamp(Time, 0.f, 1.f) * Resolution;
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Scaled), Resolution - 1);
+	return FMath::Lerp(ArcLengths[Index], ArcLengths[Index + 1], Scaled - Index);
+}
+
+// 获取距离对应的时间
+float FYCBezierPath::GetTimeAtDistance(const float Distance) const
+{
+	if (ArcLengths.Num() < 2 || GetLength() <= 0.f) return 0.f;
+
+	const float ClampedDistance = FMath::Clamp(Distance, 0.f, GetLength());
+	// 第一个不小于距离的点
+	const int32 Upper = Algo::LowerBound(ArcLengths, ClampedDistance);
+	if (Upper == 0) return 0.f;
+	return InterpolateTime(Upper - 1, ClampedDistance);
+}
+
+// 批量采样位置
+void FYCBezierPath::SamplePositions(const int32 Count, const bool bConstantSpeed, TArray<FVector>& OutPositions) const
+{
+	OutPositions.Reset(Count);
+	if (Count <= 0 || !IsValid()) return;
+	if (Count == 1)
+	{
+		OutPositions.Add(GetPositionAtTime(0.f));
+		return;
+	}
+
+	const float Step = 1.f / (Count - 1);
+	if (!bConstantSpeed)
+	{
+		for (int32 i = 0; i < Count; ++i)
+		{
+			OutPositions.Add(GetPositionAtTime(i * Step));
+		}
+		return;
+	}
+
+	TArray<float, TInlineAllocator<256>> Distances;
+	Distances.SetNumUninitialized(Count);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Distances[i] = GetLength() * i * Step;
+	}
+
+	TArray<float> Times;
+	GetTimesAtSortedDistances(Distances, Times);
+	for (const float Time : Times)
+	{
+		OutPositions.Add(GetPositionAtTime(Time));
+	}
+}
+
+// 批量获取距离对应的时间
+void FYCBezierPath::GetTimesAtSortedDistances(const TArrayView<const float> Distances, TArray<float>& OutTimes) const
+{
+	OutTimes.Reset(Distances.Num());
+	if (ArcLengths.Num() < 2 || GetLength() <= 0.f)
+	{
+		OutTimes.AddZeroed(Distances.Num());
+		return;
+	}
+
+	// 距离递增，弧长表的位置只需向前移动
+	const int32 Resolution = ArcLengths.Num() - 1;
+	int32 Index = 0;
+	for (const float Distance : Distances)
+	{
+		const float ClampedDistance = FMath::Clamp(Distance, 0.f, GetLength());
+		while (Index < Resolution - 1 && ArcLengths[Index + 1] < ClampedDistance)
+		{
+			++Index;
+		}
+		OutTimes.Add(InterpolateTime(Index, ClampedDistance));
+	}
+}
+
+// 在弧长表的一段内按距离插值时间
+float FYCBezierPath::InterpolateTime(const int32 Index, const float Distance) const
+{
+	const int32 Resolution = ArcLengths.Num() - 1;
+	const float SegmentLength = ArcLengths[Index + 1] - ArcLengths[Index];
+	const float Alpha = SegmentLength > UE_KINDA_SMALL_NUMBER ? FMath::Clamp((Distance - ArcLengths[Index]) / SegmentLength, 0.f, 1.f) : 0.f;
+	return (Index + Alpha) / Resolution;
+}
+
+// 控制多边形是否足够平直
+static bool IsControlPolygonFlat(const TArrayView<const FVector> ControlPoints, const double ToleranceSquared)
+{
+	const FVector& Start = ControlPoints[0];
+	const FVector& End = ControlPoints.Last();
+	for (int32 i = 1; i < ControlPoints.Num() - 1; ++i)
+	{
+		if (FMath::PointDistToSegmentSquared(ControlPoints[i], Start, End) > ToleranceSquared)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// 自适应展开为折线
+void FYCBezierPath::FlattenPoints(const TArrayView<const FVector> ControlPoints, const float Tolerance, TArray<FVector>& OutPoints)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::FlattenPoints);
+
+	OutPoints.Reset();
+	const int32 PointNum = ControlPoints.Num();
+	if (PointNum == 0) return;
+
+	OutPoints.Add(ControlPoints[0]);
+	if (PointNum == 1) return;
+
+	const double ToleranceSquared = FMath::Square(FMath::Max<double>(Tolerance, UE_KINDA_SMALL_NUMBER));
+
+	// 用栈代替递归，每个元素是一组控制点和对应的细分深度；先处理左半段，保证输出按顺序
+	TArray<FVector, TInlineAllocator<128>> Stack;
+	TArray<int32, TInlineAllocator<32>> Depths;
+	Stack.Append(ControlPoints.GetData(), PointNum);
+	Depths.Add(0);
+
+	TArray<FVector, TInlineAllocator<16>> Current, Left, Right;
+	Left.SetNumUninitialized(PointNum);
+	Right.SetNumUninitialized(PointNum);
+	while (!Depths.IsEmpty())
+	{
+		const int32 Depth = Depths.Pop(false);
+		Current.Reset();
+		Current.Append(Stack.GetData() + Stack.Num() - PointNum, PointNum);
+		Stack.SetNum(Stack.Num() - PointNum, false);
+
+		if (Depth >= MaxFlattenDepth || IsControlPolygonFlat(Current, ToleranceSquared))
+		{
+			OutPoints.Add(Current.Last());
+			continue;
+		}
+
+		// 从中间细分
+		SplitControlPoints(Current, 0.5, Left.GetData(), Right.GetData());
+
+		Stack.Append(Right);
+		Depths.Add(Depth + 1);
+		Stack.Append(Left);
+		Depths.Add(Depth + 1);
+	}
+}
+
+// 按时间顺序遍历曲线的分段
+template <typename PruneFuncType, typename LeafFuncType>
+void FYCBezierPath::VisitPieces(const float Tolerance, PruneFuncType&& Prune, LeafFuncType&& Leaf) const
+{
+	const int32 PointNum = Points.Num();
+	if (PointNum == 0 || PieceBounds.IsEmpty()) return;
+
+	const double ToleranceSquared = FMath::Square(FMath::Max<double>(Tolerance, UE_KINDA_SMALL_NUMBER));
+
+	// 与 FlattenPoints 相同，用栈代替递归，先处理时间靠前的一段
+	struct FPieceRange
+	{
+		FBox Box;
+		float StartTime;
+		float EndTime;
+		int32 Depth;
+	};
+	TArray<FVector, TInlineAllocator<128>> Stack;
+	TArray<FPieceRange, TInlineAllocator<32>> Ranges;
+
+	// 缓存的分段倒序入栈，包围盒直接使用缓存
+	const int32 PieceNum = PieceBounds.Num();
+	for (int32 Piece = PieceNum - 1; Piece >= 0; --Piece)
+	{
+		Stack.Append(PieceControlPoints.GetData() + Piece * PointNum, PointNum);
+		Ranges.Add({PieceBounds[Piece], static_cast<float>(Piece) / PieceNum, static_cast<float>(Piece + 1) / PieceNum, 0});
+	}
+
+	TArray<FVector, TInlineAllocator<16>> Current, Left, Right;
+	Left.SetNumUninitialized(PointNum);
+	Right.SetNumUninitialized(PointNum);
+	while (!Ranges.IsEmpty())
+	{
+		const FPieceRange Range = Ranges.Pop(false);
+		Current.Reset();
+		Current.Append(Stack.GetData() + Stack.Num() - PointNum, PointNum);
+		Stack.SetNum(Stack.Num() - PointNum, false);
+
+		// 出栈时再剪枝，之前找到的结果可以让后面的分段被跳过
+		if (Prune(Range.Box)) continue;
+
+		if (Range.Depth >= MaxFlattenDepth || IsControlPolygonFlat(Current, ToleranceSquared))
+		{
+			if (Leaf(Current[0], Current.Last(), Range.StartTime, Range.EndTime)) return;
+			continue;
+		}
+
+		SplitControlPoints(Current, 0.5, Left.GetData(), Right.GetData());
+		const float MiddleTime = (Range.StartTime + Range.EndTime) * 0.5f;
+
+		Stack.Append(Right);
+		Ranges.Add({FBox(Right.GetData(), PointNum), MiddleTime, Range.EndTime, Range.Depth + 1});
+		Stack.Append(Left);
+		Ranges.Add({FBox(Left.GetData(), PointNum), Range.StartTime, MiddleTime, Range.Depth + 1});
+	}
+}
+
+// 线段 Start-End 上离 Location 最近的点对应的比例
+static float GetSegmentAlpha(const FVector& Location, const FVector& Start, const FVector& End)
+{
+	const FVector Segment = End - Start;
+	const double LengthSquared = Segment.SizeSquared();
+	return LengthSquared > UE_SMALL_NUMBER ? static_cast<float>(FMath::Clamp(((Location - Start) | Segment) / LengthSquared, 0.0, 1.0)) : 0.f;
+}
+
+// 查找曲线上离某点最近的点
+bool FYCBezierPath::FindClosestPoint(const FVector& Location, float& OutTime, FVector& OutLocation, const float Tolerance) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::FindClosestPoint);
+
+	OutTime = 0.f;
+	OutLocation = FVector::ZeroVector;
+	if (!IsValid()) return false;
+
+	double BestDistanceSquared = TNumericLimits<double>::Max();
+	VisitPieces(Tolerance,
+	            [&](const FBox& Box)
+	            {
+		            return Box.ComputeSquaredDistanceToPoint(Location) >= BestDistanceSquared;
+	            },
+	            [&](const FVector& Start, const FVector& End, const float StartTime, const float EndTime)
+	            {
+		            const float Alpha = GetSegmentAlpha(Location, Start, End);
+		            const double DistanceSquared = FVector::DistSquared(Location, FMath::Lerp(Start, End, Alpha));
+		            if (DistanceSquared < BestDistanceSquared)
+		            {
+			            BestDistanceSquared = DistanceSquared;
+			            OutTime = FMath::Lerp(StartTime, EndTime, Alpha);
+		            }
+		            return false;
+	            });
+
+	OutLocation = GetPositionAtTime(OutTime);
+	return true;
+}
+
+// 查找曲线与平面的第一个交点
+bool FYCBezierPath::IntersectPlane(const FPlane& Plane, float& OutTime, FVector& OutLocation, const float Tolerance) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::IntersectPlane);
+
+	bool bHit = false;
+	VisitPieces(Tolerance,
+	            [&Plane](const FBox& Box)
+	            {
+		            // 包围盒完全在平面一侧
+		            FVector Center, Extent;
+		            Box.GetCenterAndExtents(Center, Extent);
+		            const FVector Normal = Plane.GetNormal();
+		            const double Radius = FMath::Abs(Normal.X) * Extent.X + FMath::Abs(Normal.Y) * Extent.Y + FMath::Abs(Normal.Z) * Extent.Z;
+		            return FMath::Abs(Plane.PlaneDot(Center)) > Radius;
+	            },
+	            [&](const FVector& Start, const FVector& End, const float StartTime, const float EndTime)
+	            {
+		            const double StartDistance = Plane.PlaneDot(Start);
+		            const double EndDistance = Plane.PlaneDot(End);
+		            if (StartDistance * EndDistance > 0.0) return false;
+
+		            const double Denominator = StartDistance - EndDistance;
+		            const float Alpha = FMath::Abs(Denominator) > UE_SMALL_NUMBER ? static_cast<float>(StartDistance / Denominator) : 0.f;
+		            OutTime = FMath::Lerp(StartTime, EndTime, Alpha);
+		            OutLocation = FMath::Lerp(Start, End, Alpha);
+		            bHit = true;
+		            return true;
+	            });
+	return bHit;
+}
+
+// 查找曲线与射线的第一个交点
+bool FYCBezierPath::IntersectRay(const FVector& Origin, const FVector& Direction, const float Radius, float& OutTime, FVector& OutLocation, const float Tolerance) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::IntersectRay);
+
+	if (!IsValid() || Direction.IsNearlyZero()) return false;
+
+	// 射线截断到能穿过整条曲线包围盒的长度
+	const double HitRadius = FMath::Max(Radius, 0.f) + FMath::Max(Tolerance, 0.f);
+	const double RayLength = FVector::Dist(Origin, Bounds.GetCenter()) + Bounds.GetExtent().Size() + HitRadius;
+	const FVector RayEnd = Origin + Direction.GetSafeNormal() * RayLength;
+	const FVector RayDelta = RayEnd - Origin;
+
+	bool bHit = false;
+	VisitPieces(Tolerance,
+	            [&](const FBox& Box)
+	            {
+		            return !FMath::LineBoxIntersection(Box.ExpandBy(HitRadius), Origin, RayEnd, RayDelta);
+	            },
+	            [&](const FVector& Start, const FVector& End, const float StartTime, const float EndTime)
+	            {
+		            FVector PointOnCurve, PointOnRay;
+		            FMath::SegmentDistToSegmentSafe(Start, End, Origin, RayEnd, PointOnCurve, PointOnRay);
+		            if (FVector::DistSquared(PointOnCurve, PointOnRay) > FMath::Square(HitRadius)) return false;
+
+		            OutTime = FMath::Lerp(StartTime, EndTime, GetSegmentAlpha(PointOnCurve, Start, End));
+		            OutLocation = PointOnCurve;
+		            bHit = true;
+		            return true;
+	            });
+	return bHit;
+}
+
+// 曲线是否与包围盒重叠
+bool FYCBezierPath::IntersectsBox(const FBox& Box, float& OutTime, const float Tolerance) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierPath::IntersectsBox);
+
+	if (!IsValid() || !Box.IsValid || !Box.Intersect(Bounds)) return false;
+
+	bool bHit = false;
+	VisitPieces(Tolerance,
+	            [&Box](const FBox& PieceBox)
+	            {
+		            return !Box.Intersect(PieceBox);
+	            },
+	            [&](const FVector& Start, const FVector& End, const float StartTime, const float EndTime)
+	            {
+		            float Alpha = 0.f;
+		            if (!Box.IsInsideOrOn(Start))
+		            {
+			            FVector HitLocation, HitNormal;
+			            if (!FMath::LineExtentBoxIntersection(Box, Start, End, FVector::ZeroVector, HitLocation, HitNormal, Alpha)) return false;
+		            }
+		            OutTime = FMath::Lerp(StartTime, EndTime, Alpha);
+		            bHit = true;
+		            return true;
+	            });
+	return bHit;
+}
+
+#if !UE_BUILD_SHIPPING
+// 展开基准测试：对比自适应展开与固定步长采样的点数和耗时
+static FAutoConsoleCommand BezierFlattenBenchmarkCommand(
+	TEXT("ToolKits.Bezier.FlattenBenchmark"),
+	TEXT("输出贝塞尔曲线自适应展开与固定步长采样的点数和耗时"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		constexpr int32 Iterations = 1000;
+		constexpr int32 FixedSteps = 128;
+
+		// 一段较直的曲线和一段急转弯的曲线
+		const TArray<FVector> Curves[] =
+		{
+			{FVector(0, 0, 0), FVector(1000, 50, 0), FVector(2000, -50, 0), FVector(3000, 0, 0)},
+			{FVector(0, 0, 0), FVector(3000, 0, 0), FVector(3000, 3000, 0), FVector(0, 100, 0)},
+		};
+
+		for (const TArray<FVector>& Curve : Curves)
+		{
+			for (const float Tolerance : {1.f, 5.f, 25.f})
+			{
+				TArray<FVector> Polyline;
+				const double FlattenStart = FPlatformTime::Seconds();
+				for (int32 i = 0; i < Iterations; ++i)
+				{
+					FYCBezierPath::FlattenPoints(Curve, Tolerance, Polyline);
+				}
+				const double FlattenUs = (FPlatformTime::Seconds() - FlattenStart) * 1e6 / Iterations;
+
+				FYCBezierPath Path;
+				Path.Build(Curve);
+				TArray<FVector> Fixed;
+				const double FixedStart = FPlatformTime::Seconds();
+				for (int32 i = 0; i < Iterations; ++i)
+				{
+					Path.SamplePositions(FixedSteps + 1, false, Fixed);
+				}
+				const double FixedUs = (FPlatformTime::Seconds() - FixedStart) * 1e6 / Iterations;
+
+				Ar.Logf(TEXT("贝塞尔展开 长度 %.0f 容差 %.0f: 自适应 %d 点 %.2f us, 固定步长 %d 点 %.2f us"),
+				        Path.GetLength(), Tolerance, Polyline.Num(), FlattenUs, Fixed.Num(), FixedUs);
+			}
+		}
+	}));
+
+// 查询基准测试：对比包围盒剪枝的最近点查询与固定步长采样
+static FAutoConsoleCommand BezierQueryBenchmarkCommand(
+	TEXT("ToolKits.Bezier.QueryBenchmark"),
+	TEXT("输出贝塞尔曲线最近点查询与固定步长采样的耗时和误差"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		constexpr int32 QueryNum = 10000;
+		constexpr int32 FixedSteps = 128;
+
+		FYCBezierPath Path;
+		Path.Build({FVector(0, 0, 0), FVector(1000, 0, 1500), FVector(3000, 500, 1500), FVector(4000, 500, 0)});
+
+		FRandomStream Random(QueryNum);
+		TArray<FVector> Locations;
+		Locations.SetNumUninitialized(QueryNum);
+		for (FVector& Location : Locations)
+		{
+			Location = Random.RandPointInBox(Path.GetBounds().ExpandBy(1000.0));
+		}
+
+		double QueryError = 0.0;
+		const double QueryStart = FPlatformTime::Seconds();
+		for (const FVector& Location : Locations)
+		{
+			float Time;
+			FVector ClosestPoint;
+			Path.FindClosestPoint(Location, Time, ClosestPoint);
+			QueryError += FVector::Dist(Location, ClosestPoint);
+		}
+		const double QueryUs = (FPlatformTime::Seconds() - QueryStart) * 1e6 / QueryNum;
+
+		double FixedError = 0.0;
+		const double FixedStart = FPlatformTime::Seconds();
+		for (const FVector& Location : Locations)
+		{
+			double BestDistanceSquared = TNumericLimits<double>::Max();
+			for (int32 i = 0; i <= FixedSteps; ++i)
+			{
+				BestDistanceSquared = FMath::Min(BestDistanceSquared, FVector::DistSquared(Location, Path.GetPositionAtTime(static_cast<float>(i) / FixedSteps)));
+			}
+			FixedError += FMath::Sqrt(BestDistanceSquared);
+		}
+		const double FixedUs = (FPlatformTime::Seconds() - FixedStart) * 1e6 / QueryNum;
+
+		// 平均距离越小越精确
+		Ar.Logf(TEXT("贝塞尔最近点: 剪枝查询 %.2f us 平均距离 %.2f, 固定步长 %d 次 %.2f us 平均距离 %.2f"),
+		        QueryUs, QueryError / QueryNum, FixedSteps + 1, FixedUs, FixedError / QueryNum);
+	}));
+#endif
@@ -0,0 +1,247 @@
+#include "YCBezierTrajectoryBatch.h"
+#include "ToolKitsStats.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+// 每个并行任务处理的组数（每组4条弹道）
+static constexpr int32 GroupsPerTask = 64;
+
+FYCBezierTrajectoryBatch::FYCBezierTrajectoryBatch(const FVector& InOrigin): Origin(InOrigin)
+{
+}
+
+// 添加二次贝塞尔弹道
+int32 FYCBezierTrajectoryBatch::AddQuadratic(const FVector& P0, const FVector& P1, const FVector& P2, const float StartTime, const float Duration)
+{
+	// 升阶为三次贝塞尔
+	const FVector C1 = P0 + (P1 - P0) * (2.0 / 3.0);
+	const FVector C2 = P2 + (P1 - P2) * (2.0 / 3.0);
+	return AddCubic(P0, C1, C2, P2, StartTime, Duration);
+}
+
+// 添加三次贝塞尔弹道
+int32 FYCBezierTrajectoryBatch::AddCubic(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, const float StartTime, const float Duration)
+{
+	// 先转换到以原点为中心，再转换为多项式系数
+	const FVector3f L0(P0 - Origin);
+	const FVector3f L1(P1 - Origin);
+	const FVector3f L2(P2 - Origin);
+	const FVector3f L3(P3 - Origin);
+	return AddCoefficients(
+		-L0 + L1 * 3.f - L2 * 3.f + L3,
+		L0 * 3.f - L1 * 6.f + L2 * 3.f,
+		(L1 - L0) * 3.f,
+		L0,
+		StartTime, Duration);
+}
+
+// 添加多项式系数
+int32 FYCBezierTrajectoryBatch::AddCoefficients(const FVector3f& A, const FVector3f& B, const FVector3f& C, const FVector3f& D, const float StartTime, const float Duration)
+{
+	const int32 Index = Count++;
+
+	// 补齐到4的倍数，补齐部分全部为0
+	if (Index == StartTimes.Num())
+	{
+		for (TArray<float>(&Term)[3] : Coefficients)
+		{
+			for (TArray<float>& Component : Term)
+			{
+				Component.AddZeroed(4);
+			}
+		}
+		StartTimes.AddZeroed(4);
+		InvDurations.AddZeroed(4);
+	}
+
+	const FVector3f* Terms[4] = {&A, &B, &C, &D};
+	for (int32 Term = 0; Term < 4; ++Term)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Coefficients[Term][Axis][Index] = (*Terms[Term])[Axis];
+		}
+	}
+	StartTimes[Index] = StartTime;
+	InvDurations[Index] = Duration > UE_KINDA_SMALL_NUMBER ? 1.f / Duration : UE_BIG_NUMBER;
+	return Index;
+}
+
+// 交换删除弹道
+void FYCBezierTrajectoryBatch::RemoveAtSwap(const int32 Index)
+{
+	check(Index >= 0 && Index < Count);
+
+	const int32 LastIndex = --Count;
+	for (TArray<float>(&Term)[3] : Coefficients)
+	{
+		for (TArray<float>& Component : Term)
+		{
+			Component[Index] = Component[LastIndex];
+			Component[LastIndex] = 0.f;
+		}
+	}
+	StartTimes[Index] = StartTimes[LastIndex];
+	StartTimes[LastIndex] = 0.f;
+	InvDurations[Index] = InvDurations[LastIndex];
+	InvDurations[LastIndex] = 0.f;
+
+	// 多出一整组补齐时收缩
+	const int32 PaddedNum = Align(Count, 4);
+	if (PaddedNum < StartTimes.Num())
+	{
+		for (TArray<float>(&Term)[3] : Coefficients)
+		{
+			for (TArray<float>& Component : Term)
+			{
+				Component.SetNum(PaddedNum, false);
+			}
+		}
+		StartTimes.SetNum(PaddedNum, false);
+		InvDurations.SetNum(PaddedNum, false);
+	}
+}
+
+// 清空
+void FYCBezierTrajectoryBatch::Reset()
+{
+	Count = 0;
+	for (TArray<float>(&Term)[3] : Coefficients)
+	{
+		for (TArray<float>& Component : Term)
+		{
+			Component.Reset();
+		}
+	}
+	StartTimes.Reset();
+	InvDurations.Reset();
+}
+
+// 按组拆分任务
+template <typename FuncType>
+void FYCBezierTrajectoryBatch::ForEachGroupRange(const bool bParallel, FuncType&& Func) const
+{
+	const int32 GroupNum = StartTimes.Num() / 4;
+	const int32 TaskNum = FMath::DivideAndRoundUp(GroupNum, GroupsPerTask);
+	ParallelFor(TaskNum, [GroupNum, &Func](const int32 TaskIndex)
+	{
+		const int32 FirstGroup = TaskIndex * GroupsPerTask;
+		Func(FirstGroup, FMath::Min(FirstGroup + GroupsPerTask, GroupNum));
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
+
+// 计算所有弹道的位置
+void FYCBezierTrajectoryBatch::Evaluate(const float Time, TArrayView<FVector> OutPositions, const bool bParallel) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierTrajectoryBatch::Evaluate);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_BezierCurve);
+	check(OutPositions.Num() >= Count);
+
+	ForEachGroupRange(bParallel, [this, Time, &OutPositions](const int32 FirstGroup, const int32 LastGroup)
+	{
+		EvaluateGroups(Time, FirstGroup, LastGroup, OutPositions.GetData() + FirstGroup * 4, nullptr);
+	});
+}
+
+// 计算所有弹道的变换
+void FYCBezierTrajectoryBatch::EvaluateTransforms(const float Time, TArrayView<FTransform> InOutTransforms, const bool bOrientToVelocity, const bool bParallel) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FYCBezierTrajectoryBatch::EvaluateTransforms);
+	SCOPE_CYCLE_COUNTER(STAT_ToolKits_BezierCurve);
+	check(InOutTransforms.Num() >= Count);
+
+	ForEachGroupRange(bParallel, [this, Time, bOrientToVelocity, &InOutTransforms](const int32 FirstGroup, const int32 LastGroup)
+	{
+		// 每个任务先把结果写入栈上的小缓冲，再写入变换
+		constexpr int32 BufferSize = GroupsPerTask * 4;
+		FVector Positions[BufferSize];
+		FVector Directions[BufferSize];
+		EvaluateGroups(Time, FirstGroup, LastGroup, Positions, bOrientToVelocity ? Directions : nullptr);
+
+		const int32 First = FirstGroup * 4;
+		const int32 Last = FMath::Min(LastGroup * 4, Count);
+		for (int32 i = First; i < Last; ++i)
+		{
+			FTransform& Transform = InOutTransforms[i];
+			Transform.SetLocation(Positions[i - First]);
+			if (bOrientToVelocity && !Directions[i - First].IsNearlyZero())
+			{
+				Transform.SetRotation(Directions[i - First].ToOrientationQuat());
+			}
+		}
+	});
+}
+
+// 把变换写入实例组件
+void FYCBezierTrajectoryBatch::UpdateInstances(const float Time, UInstancedStaticMeshComponent* Component, const bool bOrientToVelocity, const bool bParallel)
+{
+	if (Component == nullptr || Count == 0) return;
+	check(Component->GetInstanceCount() >= Count);
+
+	// 新增的变换默认为单位变换，缩放保持为1
+	InstanceTransforms.SetNum(Count, false);
+	EvaluateTransforms(Time, InstanceTransforms, bOrientToVelocity, bParallel);
+	Component->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+}
+
+// 获取已经结束的弹道
+void FYCBezierTrajectoryBatch::GetFinished(const float Time, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	for (int32 i = Count - 1; i >= 0; --i)
+	{
+		if ((Time - StartTimes[i]) * InvDurations[i] >= 1.f)
+		{
+			OutIndices.Add(i);
+		}
+	}
+}
+
+// 计算一段组的位置和速度方向，输出从第 FirstGroup 组开始写
+void FYCBezierTrajectoryBatch::EvaluateGroups(const float Time, const int32 FirstGroup, const int32 LastGroup, FVector* OutPositions, FVector* OutDirections) const
+{
+	const VectorRegister4Float TimeVector = VectorSetFloat1(Time);
+	const VectorRegister4Float Two = VectorSetFloat1(2.f);
+	const VectorRegister4Float Three = VectorSetFloat1(3.f);
+	const int32 OutputOffset = FirstGroup * 4;
+
+	alignas(16) float Positions[3][4];
+	alignas(16) float Directions[3][4];
+	for (int32 Group = FirstGroup; Group < LastGroup; ++Group)
+	{
+		const int32 Base = Group * 4;
+
+		// t = clamp((Time - Start) / Duration, 0, 1)
+		VectorRegister4Float T = VectorMultiply(VectorSubtract(TimeVector, VectorLoad(StartTimes.GetData() + Base)), VectorLoad(InvDurations.GetData() + Base));
+		T = VectorMin(VectorMax(T, GlobalVectorConstants::FloatZero), GlobalVectorConstants::FloatOne);
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const VectorRegister4Float A = VectorLoad(Coefficients[0][Axis].GetData() + Base);
+			const VectorRegister4Float B = VectorLoad(Coefficients[1][Axis].GetData() + Base);
+			const VectorRegister4Float C = VectorLoad(Coefficients[2][Axis].GetData() + Base);
+			const VectorRegister4Float D = VectorLoad(Coefficients[3][Axis].GetData() + Base);
+
+			// ((A*t + B)*t + C)*t + D
+			const VectorRegister4Float Position = VectorMultiplyAdd(VectorMultiplyAdd(VectorMultiplyAdd(A, T, B), T, C), T, D);
+			VectorStoreAligned(Position, Positions[Axis]);
+
+			if (OutDirections)
+			{
+				// (3A*t + 2B)*t + C
+				const VectorRegister4Float Direction = VectorMultiplyAdd(VectorMultiplyAdd(VectorMultiply(A, Three), T, VectorMultiply(B, Two)), T, C);
+				VectorStoreAligned(Direction, Directions[Axis]);
+			}
+		}
+
+		const int32 Valid = FMath::Min(4, Count - Base);
+		for (int32 Lane = 0; Lane < Valid; ++Lane)
+		{
+			OutPositions[Base + Lane - OutputOffset] = Origin + FVector(Positions[0][Lane], Positions[1][Lane], Positions[2][Lane]);
+			if (OutDirections)
+			{
+				OutDirections[Base + Lane - OutputOffset] = FVector(Directions[0][Lane], Directions[1][Lane], Directions[2][Lane]);
+			}
+		}
+	}
+}
@@ -1,11 +1,38 @@
 #include "YC_Log.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFileManager.h"
+#include "Logging/LogVerbosity.h"
 
 DEFINE_LOG_CATEGORY(YiChenLog);
 
 bool bYiChenLogEnable = false;
 
+// 没有配置时默认为 Log，运行时打开 bYiChenLogEnable 后即可输出
+uint8 GYiChenLogLevels[EYiChenLogCategory::Num] = {ELogVerbosity::Log, ELogVerbosity::Log, ELogVerbosity::Log, ELogVerbosity::Log};
+
+// 分类在配置文件中的键
+static const TCHAR* const YiChenLogCategoryKeys[EYiChenLogCategory::Num] =
+{
+	TEXT("Default"),
+	TEXT("Fence"),
+	TEXT("Fog"),
+	TEXT("License"),
+};
+
+// 根据配置刷新每个分类的运行时级别
+static void ApplyLogLevels(const TMap<FString, FString>& ConfigMap)
+{
+	for (int32 Index = 0; Index < EYiChenLogCategory::Num; ++Index)
+	{
+		ELogVerbosity::Type Level = ELogVerbosity::Log;
+		if (const FString* Value = ConfigMap.Find(YiChenLogCategoryKeys[Index]))
+		{
+			Level = ParseLogVerbosityFromString(*Value);
+		}
+		GYiChenLogLevels[Index] = Level;
+	}
+}
+
 // 读取配置
 void LoadConfig()
 {
@@ -33,7 +60,9 @@ void LoadConfig()
 	if (!FPaths::FileExists(FilePath))
 	{
 		// 默认内容
-		FString DefaultContent = TEXT("; true ? false 是否开启YiChenLog打印 \nbYiChenLogEnable = true\n");
+		FString DefaultContent = TEXT("; true ? false 是否开启YiChenLog打印 \nbYiChenLogEnable = true\n")
+			TEXT("; 各分类的日志级别 NoLogging/Fatal/Error/Warning/Display/Log/Verbose/VeryVerbose \n")
+			TEXT("Default = Log\nFence = Log\nFog = Log\nLicense = Log\n");
 		if (FFileHelper::SaveStringToFile(DefaultContent, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8))
 		{
 			UE_LOG(YiChenLog, Log, TEXT("%s\t配置文件创建成功: %s"), *FDateTime::Now().ToString(), *FilePath);
@@ -60,15 +89,19 @@ void LoadConfig()
 				FString TempKey;
 				FString TempValue;
 
+				// 跳过注释
+				if (Line.TrimStart().StartsWith(TEXT(";"))) continue;
+
 				if (Line.Split(TEXT("="), &TempKey, &TempValue))
 				{
 					// 清理键值对，并放入 Map 中
-					ConfigMap.Add(Key.TrimStartAndEnd(), TempValue.TrimStartAndEnd());
+					ConfigMap.Add(TempKey.TrimStartAndEnd(), TempValue.TrimStartAndEnd());
 				}
 			}
 
 			// 读取配置
 			bYiChenLogEnable = ConfigMap.FindRef(Key) == TEXT("true") ? true : false;
+			ApplyLogLevels(ConfigMap);
 			// UE_LOG(YiChenLog, Log, TEXT("读取到的值是:%d"), bYiChenLogEnable);
 		}
 	}
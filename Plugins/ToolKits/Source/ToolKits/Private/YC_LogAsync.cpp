@@ -0,0 +1,299 @@
+#include "YC_LogAsync.h"
+#include "YC_Log.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+namespace YCLog
+{
+	// 单条日志格式化后的最大长度
+	static constexpr int32 MaxMessageLength = 1024;
+
+	/**
+	 * 单生产者单消费者环形缓冲
+	 * 生产者是写日志的线程，消费者是后台线程（崩溃时为崩溃线程）
+	 */
+	struct FRing
+	{
+		// 容量，必须是2的幂
+		static constexpr uint32 Capacity = 512;
+
+		FRecord Records[Capacity];
+		// 生产者写入位置
+		std::atomic<uint32> Head{0};
+		// 消费者读取位置
+		std::atomic<uint32> Tail{0};
+		// 因缓冲已满被丢弃的数量
+		std::atomic<uint32> Dropped{0};
+	};
+
+	// 后台线程是否在运行
+	static std::atomic<bool> GBackendRunning{false};
+
+	// 所有线程的环形缓冲，线程首次写日志时注册
+	// 线程退出后缓冲依然保留，由于数量以线程数为上限，不做回收，避免与生产者产生竞争
+	static TArray<FRing*> GRings;
+
+	// 保护 GRings 的注册
+	static FCriticalSection GRingsLock;
+
+	// 保证同一时间只有一个消费者
+	static FCriticalSection GConsumerLock;
+
+	// 当前线程的环形缓冲
+	static thread_local FRing* GThreadRing = nullptr;
+
+	// 当前线程正在写入的位置
+	static thread_local uint32 GThreadHead = 0;
+
+	// 输出一条格式化好的日志，与 UE_LOG 一样遵守分类的运行时级别（log 命令、-LogCmds）
+	static void Output(const FRecord& Record)
+	{
+		if (YiChenLog.IsSuppressed(Record.Verbosity)) return;
+
+		TCHAR Message[MaxMessageLength];
+		Record.Decode(Record, Message, MaxMessageLength);
+		GLog->Serialize(Message, Record.Verbosity, YiChenLog.GetCategoryName());
+	}
+
+	/**
+	 * 取出一个缓冲中的日志并输出，调用者需要持有 GConsumerLock
+	 * @return 是否处理了日志
+	 */
+	static bool DrainRing(FRing* Ring)
+	{
+		bool bProcessed = false;
+		const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+		uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+		for (; Tail != Head; ++Tail)
+		{
+			Output(Ring->Records[Tail & (FRing::Capacity - 1)]);
+			// 每条处理完立即归还，让生产者尽早复用
+			Ring->Tail.store(Tail + 1, std::memory_order_release);
+			bProcessed = true;
+		}
+
+		if (const uint32 Dropped = Ring->Dropped.exchange(0, std::memory_order_relaxed))
+		{
+			GLog->Serialize(*FString::Printf(TEXT("日志缓冲已满，丢弃了 %u 条日志"), Dropped), ELogVerbosity::Warning, YiChenLog.GetCategoryName());
+		}
+		return bProcessed;
+	}
+
+	/**
+	 * 取出所有缓冲中的日志并输出
+	 * @return 是否处理了日志
+	 */
+	static bool Drain()
+	{
+		FScopeLock ConsumerLock(&GConsumerLock);
+
+		TArray<FRing*, TInlineAllocator<64>> Rings;
+		{
+			FScopeLock RingsLock(&GRingsLock);
+			Rings = GRings;
+		}
+
+		bool bProcessed = false;
+		for (FRing* Ring : Rings)
+		{
+			bProcessed |= DrainRing(Ring);
+		}
+		return bProcessed;
+	}
+
+	/**
+	 * 崩溃时输出剩余日志
+	 * 持有锁的线程可能已经停止，崩溃线程只在限定时间内尝试加锁，拿不到锁时放弃剩余日志
+	 */
+	static void FlushOnSystemError()
+	{
+		constexpr double LockTimeoutSeconds = 0.1;
+		const double StartTime = FPlatformTime::Seconds();
+		while (!GConsumerLock.TryLock())
+		{
+			if (FPlatformTime::Seconds() - StartTime > LockTimeoutSeconds)
+			{
+				GLog->Flush();
+				return;
+			}
+			FPlatformProcess::YieldThread();
+		}
+
+		if (GRingsLock.TryLock())
+		{
+			for (FRing* Ring : GRings)
+			{
+				DrainRing(Ring);
+			}
+			GRingsLock.Unlock();
+		}
+		GConsumerLock.Unlock();
+		GLog->Flush();
+	}
+
+	/**
+	 * 后台写入线程
+	 */
+	class FWriterRunnable : public FRunnable
+	{
+	public:
+		FWriterRunnable(): WakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+		{
+		}
+
+		virtual ~FWriterRunnable() override
+		{
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!bStopping.load(std::memory_order_relaxed))
+			{
+				// 生产者不通知事件，热路径只有一次原子写；后台线程空闲时定时轮询
+				if (!Drain())
+				{
+					WakeEvent->Wait(PollIntervalMs);
+				}
+			}
+			Drain();
+			return 0;
+		}
+
+		virtual void Stop() override
+		{
+			bStopping.store(true, std::memory_order_relaxed);
+			WakeEvent->Trigger();
+		}
+
+	private:
+		// 空闲时的轮询间隔
+		static constexpr uint32 PollIntervalMs = 5;
+
+		FEvent* WakeEvent;
+		std::atomic<bool> bStopping{false};
+	};
+
+	// 后台线程
+	static FWriterRunnable* GWriterRunnable = nullptr;
+	static FRunnableThread* GWriterThread = nullptr;
+
+	// 崩溃回调
+	static FDelegateHandle GSystemErrorHandle;
+
+	// 获取下一个空位
+	FRecord* BeginRecord()
+	{
+		if (!GBackendRunning.load(std::memory_order_relaxed)) return nullptr;
+
+		FRing* Ring = GThreadRing;
+		if (Ring == nullptr)
+		{
+			// 线程第一次写日志，注册环形缓冲（每个线程只加锁一次）
+			Ring = new FRing();
+			{
+				FScopeLock RingsLock(&GRingsLock);
+				GRings.Add(Ring);
+			}
+			GThreadRing = Ring;
+		}
+
+		const uint32 Head = Ring->Head.load(std::memory_order_relaxed);
+		const uint32 Tail = Ring->Tail.load(std::memory_order_acquire);
+		if (Head - Tail >= FRing::Capacity)
+		{
+			// 缓冲已满，丢弃新日志
+			Ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		GThreadHead = Head;
+		return &Ring->Records[Head & (FRing::Capacity - 1)];
+	}
+
+	// 提交记录
+	void CommitRecord()
+	{
+		GThreadRing->Head.store(GThreadHead + 1, std::memory_order_release);
+
+		// BeginRecord 之后后台线程可能已经停止，StopBackend 的最后一次 Drain 不一定能看到这条记录，由生产者自己输出
+		// 与 StopBackend 中的栅栏配对：要么这里看到已停止，要么 StopBackend 的 Drain 看到新的 Head，两边都处理时由 Tail 去重
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!GBackendRunning.load(std::memory_order_relaxed))
+		{
+			Drain();
+		}
+	}
+
+	// 直接输出
+	void WriteImmediately(const FRecord& Record)
+	{
+		Output(Record);
+	}
+
+	// 后台线程是否在运行
+	bool IsBackendRunning()
+	{
+		return GBackendRunning.load(std::memory_order_relaxed);
+	}
+
+	// 以运行时的格式字符串格式化
+	void FormatVA(TCHAR* Dest, const int32 DestSize, const TCHAR* Format, ...)
+	{
+		const TCHAR* Fmt = Format;
+		va_list Args;
+		va_start(Args, Format);
+		FCString::GetVarArgs(Dest, DestSize, Fmt, Args);
+		va_end(Args);
+	}
+
+	// 启动后台写入线程
+	void StartBackend()
+	{
+		if (GWriterThread != nullptr || !FPlatformProcess::SupportsMultithreading()) return;
+
+		GWriterRunnable = new FWriterRunnable();
+		GWriterThread = FRunnableThread::Create(GWriterRunnable, TEXT("YiChenLogWriter"), 0, TPri_BelowNormal);
+		if (GWriterThread == nullptr)
+		{
+			delete GWriterRunnable;
+			GWriterRunnable = nullptr;
+			return;
+		}
+
+		// 崩溃时在崩溃线程上同步输出剩余日志
+		GSystemErrorHandle = FCoreDelegates::OnHandleSystemError.AddStatic(&FlushOnSystemError);
+		GBackendRunning.store(true, std::memory_order_release);
+	}
+
+	// 停止后台写入线程
+	void StopBackend()
+	{
+		if (GWriterThread == nullptr) return;
+
+		// 先停止接收新日志，之后的日志直接同步输出
+		GBackendRunning.store(false, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		FCoreDelegates::OnHandleSystemError.Remove(GSystemErrorHandle);
+
+		GWriterThread->Kill(true);
+		delete GWriterThread;
+		GWriterThread = nullptr;
+		delete GWriterRunnable;
+		GWriterRunnable = nullptr;
+
+		Flush();
+	}
+
+	// 同步输出所有未处理的日志
+	void Flush()
+	{
+		Drain();
+		GLog->Flush();
+	}
+}
@@ -3,8 +3,12 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "YCBezierPath.h"
+#include "Components/SplineComponent.h"
 #include "ToolFunctionLibrary.generated.h"
 
+class UInstancedStaticMeshComponent;
+
 /**
  * 工具函数库
  */
@@ -19,4 +23,114 @@ class TOOLKITS_API UToolFunctionLibrary : public UBlueprintFunctionLibrary
 	 */
 	UFUNCTION(BlueprintPure, BlueprintCallable, meta=(DisplayName = "GetBezierCurve", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
 	static FVector BezierCurve(TArray<FVector> Points, const float CurveTime, const float TotalTime = 1.f);
+
+	/**								创建预计算的贝塞尔曲线，适合反复采样（弹道、镜头轨道）
+	 *								构建会计算弧长表，不是纯函数，结果保存到变量后再采样
+	 * @param Points				所有的点
+	 * @param Resolution			弧长表的分段数，越大匀速运动越精确
+	 */
+	UFUNCTION(BlueprintCallable, meta=(DisplayName = "MakeBezierPath", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static FYCBezierPath MakeBezierPath(const TArray<FVector>& Points, int32 Resolution = 64);
+
+	// 获取贝塞尔曲线的长度
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "GetBezierPathLength", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static float GetBezierPathLength(const FYCBezierPath& Path);
+
+	/**								获取曲线上的位置
+	 * @param Path					曲线
+	 * @param Distance				沿曲线的距离（匀速运动使用）
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "GetBezierPathLocationAtDistance", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static FVector GetBezierPathLocationAtDistance(const FYCBezierPath& Path, float Distance);
+
+	/**								获取曲线上的位置和切线
+	 * @param Path					曲线
+	 * @param Time					曲线的时间（0~1）
+	 * @param Tangent				切线（未归一化）
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "GetBezierPathLocationAtTime", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static FVector GetBezierPathLocationAtTime(const FYCBezierPath& Path, float Time, FVector& Tangent);
+
+	/**								批量采样曲线
+	 * @param Path					曲线
+	 * @param Count					采样数量（包含起点和终点）
+	 * @param bConstantSpeed		是否按距离均匀采样
+	 */
+	UFUNCTION(BlueprintCallable, meta=(DisplayName = "SampleBezierPath", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static TArray<FVector> SampleBezierPath(const FYCBezierPath& Path, int32 Count = 32, bool bConstantSpeed = true);
+
+	/**								查找曲线上离某点最近的点（如单位到弹道的距离）
+	 * @param Path					曲线
+	 * @param Location				查询点
+	 * @param Time					最近点的时间（0~1）
+	 * @param Tolerance				精度（世界单位）
+	 * @return						最近点
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "FindClosestPointOnBezierPath", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static FVector FindClosestPointOnBezierPath(const FYCBezierPath& Path, const FVector& Location, float& Time, float Tolerance = 1.f);
+
+	/**								查找曲线与平面的第一个交点（如弹道落地点）
+	 * @param Path					曲线
+	 * @param PlaneOrigin			平面上的点
+	 * @param PlaneNormal			平面法线
+	 * @param Time					交点的时间（0~1）
+	 * @param Location				交点
+	 * @param Tolerance				精度（世界单位）
+	 * @return						是否相交
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "IntersectBezierPathWithPlane", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static bool IntersectBezierPathWithPlane(const FYCBezierPath& Path, const FVector& PlaneOrigin, const FVector& PlaneNormal, float& Time, FVector& Location, float Tolerance = 1.f);
+
+	/**								查找曲线与射线的第一个交点
+	 * @param Path					曲线
+	 * @param RayOrigin				射线起点
+	 * @param RayDirection			射线方向
+	 * @param Radius				射线半径
+	 * @param Time					交点的时间（0~1）
+	 * @param Location				交点
+	 * @param Tolerance				精度（世界单位）
+	 * @return						是否相交
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "IntersectBezierPathWithRay", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static bool IntersectBezierPathWithRay(const FYCBezierPath& Path, const FVector& RayOrigin, const FVector& RayDirection, float Radius, float& Time, FVector& Location, float Tolerance = 1.f);
+
+	/**								曲线是否与包围盒重叠
+	 * @param Path					曲线
+	 * @param Box					包围盒
+	 * @param Time					第一个进入包围盒的时间（0~1）
+	 * @param Tolerance				精度（世界单位）
+	 * @return						是否重叠
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "BezierPathOverlapsBox", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static bool BezierPathOverlapsBox(const FYCBezierPath& Path, const FBox& Box, float& Time, float Tolerance = 1.f);
+
+	// 获取贝塞尔曲线的包围盒
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "GetBezierPathBounds", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static FBox GetBezierPathBounds(const FYCBezierPath& Path);
+
+	/**								自适应展开贝塞尔曲线为折线
+	 * @param Points				所有的点
+	 * @param Tolerance				允许的最大偏差（世界单位）
+	 */
+	UFUNCTION(BlueprintPure, meta=(DisplayName = "FlattenBezierCurve", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static TArray<FVector> FlattenBezierCurve(const TArray<FVector>& Points, float Tolerance = 5.f);
+
+	/**								用展开后的贝塞尔曲线设置样条线的点
+	 * @param Spline				样条线
+	 * @param Points				所有的点
+	 * @param Tolerance				允许的最大偏差（世界单位）
+	 * @param CoordinateSpace		点的坐标空间
+	 * @return						样条线点的数量
+	 */
+	UFUNCTION(BlueprintCallable, meta=(DisplayName = "SetSplineFromBezierCurve", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static int32 SetSplineFromBezierCurve(USplineComponent* Spline, const TArray<FVector>& Points, float Tolerance = 5.f, ESplineCoordinateSpace::Type CoordinateSpace = ESplineCoordinateSpace::World);
+
+	/**								在展开后的贝塞尔曲线的每个点添加实例，朝向下一个点
+	 * @param Component				实例组件
+	 * @param Points				所有的点（世界坐标）
+	 * @param Tolerance				允许的最大偏差（世界单位）
+	 * @return						添加的实例数量
+	 */
+	UFUNCTION(BlueprintCallable, meta=(DisplayName = "AddInstancesAlongBezierCurve", Keywords = "贝塞尔曲线"), Category="ToolKits|FunctionLibrary")
+	static int32 AddInstancesAlongBezierCurve(UInstancedStaticMeshComponent* Component, const TArray<FVector>& Points, float Tolerance = 5.f);
 };
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Modules/ModuleManager.h"
 
@@ -16,8 +18,27 @@ public:
 	// 网络检查许可证是否有效
 	void CheckLicenseValidity();
 
+	// 获取当前时间，默认为本地时间，可通过 SetTimeSource 替换
+	static FDateTime GetNow();
+
+	/**
+	 * 替换时间来源（用于测试或离线环境模拟时间），可在任意线程调用
+	 * @param InTimeSource			返回当前时间的函数，为空时恢复为本地时间
+	 */
+	static void SetTimeSource(TFunction<FDateTime()> InTimeSource);
+
 	// 许可证是否有效
-	static bool IsLicenseValid(FDateTime CurrentDate = FDateTime::Now());
+	static bool IsLicenseValid(FDateTime CurrentDate = GetNow());
+
+	// 上次网络验证的缓存是否仍在有效期内
+	static bool IsCacheFresh(FDateTime InLastCheckTime, FDateTime CurrentDate = GetNow());
+
+	/**
+	 * 获取重试前的等待时间，从1秒开始每次翻倍，最长60秒
+	 * @param RetryCount			第几次重试（从1开始）
+	 * @return						超过最大重试次数时返回负数
+	 */
+	static float GetRetryDelay(int32 RetryCount);
 
 	/**
 	 * @brief						及时收到回应
@@ -30,7 +51,7 @@ public:
 	// 授权
 	static void Authorization(bool bValid);
 
-	// 重新请求网络
+	// 以指数退避重新请求网络
 	void RerequestNetwork();
 
 private:
@@ -45,9 +66,21 @@ private:
 	bool CachedLicenseValid = false;
 	// 上次检查时间
 	FDateTime LastCheckTime = FDateTime::MinValue();
+	// 缓存是否有未保存的修改
+	bool bCacheDirty = false;
+
+	// 后台读取缓存的任务
+	TFuture<void> LoadCacheFuture;
+	// 验证用的定时器（等待缓存读取、重试退避）
+	FTSTicker::FDelegateHandle ValidationTickerHandle;
+	// 正在进行的网络请求
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> PendingRequest;
+
+	// 缓存读取完成后开始验证
+	bool TickWaitForCache(float DeltaTime);
 
-	// 写入加密数据
-	void EncryptingData() const;
+	// 退避结束后重新验证
+	bool TickRetry(float DeltaTime);
 
 	// 加载缓存
 	void LoadCache();
@@ -0,0 +1,38 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * 插件统一的性能统计
+ * 控制台输入 stat ToolKits 查看，Unreal Insights 中可看到同名的 CPU 事件
+ */
+DECLARE_STATS_GROUP(TEXT("ToolKits"), STATGROUP_ToolKits, STATCAT_Advanced);
+
+// 围栏
+DECLARE_CYCLE_STAT_EXTERN(TEXT("生成围栏"), STAT_ToolKits_GeneratingFences, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("添加显示模型"), STAT_ToolKits_AddDisplayModel, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("隐藏围栏"), STAT_ToolKits_FenceHidden, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-计算坐标"), STAT_ToolKits_FenceTransformsTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-创建组件"), STAT_ToolKits_FenceComponentsTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-添加实例"), STAT_ToolKits_FenceInstancesTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-生成单体"), STAT_ToolKits_FenceSpawnTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-螺旋样条线"), STAT_ToolKits_HelicalSplineTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏任务-隐藏"), STAT_ToolKits_FenceHiddenTask, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("围栏生成调度"), STAT_ToolKits_FenceGenerationSchedule, STATGROUP_ToolKits, TOOLKITS_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("生成的围栏单体"), STAT_ToolKits_FencePostsSpawned, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("添加的围栏实例"), STAT_ToolKits_FenceInstancesAdded, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("更新的围栏实例"), STAT_ToolKits_FenceInstancesUpdated, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("删除的围栏实例"), STAT_ToolKits_FenceInstancesRemoved, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("播放中的围栏动画"), STAT_ToolKits_FenceAnimationsActive, STATGROUP_ToolKits, TOOLKITS_API);
+
+// 函数库
+DECLARE_CYCLE_STAT_EXTERN(TEXT("贝塞尔曲线"), STAT_ToolKits_BezierCurve, STATGROUP_ToolKits, TOOLKITS_API);
+
+// 战争迷雾
+DECLARE_CYCLE_STAT_EXTERN(TEXT("迷雾更新"), STAT_ToolKits_FogUpdate, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("迷雾可见性"), STAT_ToolKits_FogVisibility, STATGROUP_ToolKits, TOOLKITS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("迷雾上传"), STAT_ToolKits_FogUpload, STATGROUP_ToolKits, TOOLKITS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("更新的迷雾格子"), STAT_ToolKits_FogCellsUpdated, STATGROUP_ToolKits, TOOLKITS_API);
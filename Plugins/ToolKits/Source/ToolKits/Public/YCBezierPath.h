@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "YCBezierPath.generated.h"
+
+/**
+ * 预计算的贝塞尔曲线
+ * 构建时把控制点转换为多项式系数，并生成弧长表，
+ * 之后按时间求位置/切线为 O(阶数)，按距离求时间为 O(log n)，可用于匀速运动
+ * 同时缓存分段包围盒，最近点和相交查询只细分可能命中的分段
+ * 控制点较多（超过20个）时多项式系数的精度会下降，建议拆分为多段曲线
+ */
+USTRUCT(BlueprintType)
+struct TOOLKITS_API FYCBezierPath
+{
+	GENERATED_BODY()
+
+	/**
+	 * 构建曲线
+	 * @param InPoints			控制点
+	 * @param InResolution		弧长表的分段数，越大匀速运动越精确
+	 */
+	void Build(const TArray<FVector>& InPoints, int32 InResolution = 64);
+
+	// 是否已构建
+	FORCEINLINE bool IsValid() const { return !Coefficients.IsEmpty(); }
+
+	// 获取曲线长度
+	FORCEINLINE float GetLength() const { return ArcLengths.IsEmpty() ? 0.f : ArcLengths.Last(); }
+
+	// 获取控制点
+	FORCEINLINE const TArray<FVector>& GetPoints() const { return Points; }
+
+	// 获取时间（0~1）对应的位置
+	FVector GetPositionAtTime(float Time) const;
+
+	// 获取时间（0~1）对应的切线（未归一化，长度为速度）
+	FVector GetTangentAtTime(float Time) const;
+
+	// 获取时间（0~1）对应的距离，O(1)
+	float GetDistanceAtTime(float Time) const;
+
+	// 获取距离对应的时间（0~1），O(log n)
+	float GetTimeAtDistance(float Distance) const;
+
+	// 获取距离对应的位置
+	FORCEINLINE FVector GetPositionAtDistance(const float Distance) const { return GetPositionAtTime(GetTimeAtDistance(Distance)); }
+
+	/**
+	 * 批量采样位置
+	 * @param Count				采样数量（包含起点和终点）
+	 * @param bConstantSpeed	是否按距离均匀采样，否则按时间均匀采样
+	 * @param OutPositions		采样结果
+	 */
+	void SamplePositions(int32 Count, bool bConstantSpeed, TArray<FVector>& OutPositions) const;
+
+	/**
+	 * 批量获取距离对应的时间，距离需要递增，整体为 O(n + 分段数)
+	 * @param Distances			递增的距离
+	 * @param OutTimes			对应的时间
+	 */
+	void GetTimesAtSortedDistances(TArrayView<const float> Distances, TArray<float>& OutTimes) const;
+
+	/**
+	 * 自适应展开为折线，平直处点少，弯曲处点多
+	 * @param Tolerance			允许的最大偏差（世界单位）
+	 * @param OutPoints			折线的点（包含起点和终点），会先被清空
+	 */
+	FORCEINLINE void Flatten(const float Tolerance, TArray<FVector>& OutPoints) const { FlattenPoints(Points, Tolerance, OutPoints); }
+
+	/**
+	 * 按控制点自适应展开贝塞尔曲线，不需要先构建
+	 * 控制多边形到首尾连线的距离不超过 Tolerance 时视为平直，否则从中间细分
+	 * @param ControlPoints		控制点
+	 * @param Tolerance			允许的最大偏差（世界单位）
+	 * @param OutPoints			折线的点（包含起点和终点），会先被清空
+	 */
+	static void FlattenPoints(TArrayView<const FVector> ControlPoints, float Tolerance, TArray<FVector>& OutPoints);
+
+	// 获取整条曲线的包围盒
+	FORCEINLINE const FBox& GetBounds() const { return Bounds; }
+
+	/**
+	 * 查找曲线上离某点最近的点
+	 * 按缓存的分段包围盒剪枝，只细分可能更近的分段
+	 * @param Location			查询点
+	 * @param OutTime			最近点的时间（0~1）
+	 * @param OutLocation		最近点
+	 * @param Tolerance			精度（世界单位）
+	 * @return					曲线未构建时返回 false
+	 */
+	bool FindClosestPoint(const FVector& Location, float& OutTime, FVector& OutLocation, float Tolerance = 1.f) const;
+
+	/**
+	 * 查找曲线与平面的第一个交点（例如弹道落地点）
+	 * @param Plane				平面
+	 * @param OutTime			交点的时间（0~1）
+	 * @param OutLocation		交点
+	 * @param Tolerance			精度（世界单位）
+	 * @return					是否相交
+	 */
+	bool IntersectPlane(const FPlane& Plane, float& OutTime, FVector& OutLocation, float Tolerance = 1.f) const;
+
+	/**
+	 * 查找曲线与射线（可带半径）的第一个交点，按曲线时间排序
+	 * @param Origin			射线起点
+	 * @param Direction			射线方向
+	 * @param Radius			射线半径，为0时按精度判断
+	 * @param OutTime			交点的时间（0~1）
+	 * @param OutLocation		交点
+	 * @param Tolerance			精度（世界单位）
+	 * @return					是否相交
+	 */
+	bool IntersectRay(const FVector& Origin, const FVector& Direction, float Radius, float& OutTime, FVector& OutLocation, float Tolerance = 1.f) const;
+
+	/**
+	 * 曲线是否与包围盒重叠
+	 * @param Box				包围盒
+	 * @param OutTime			第一个进入包围盒的时间（0~1）
+	 * @param Tolerance			精度（世界单位）
+	 * @return					是否重叠
+	 */
+	bool IntersectsBox(const FBox& Box, float& OutTime, float Tolerance = 1.f) const;
+
+private:
+	// 弧长表中 Index 段内按距离插值时间
+	float InterpolateTime(int32 Index, float Distance) const;
+
+	/**
+	 * 按时间顺序遍历曲线的分段，从缓存的分段开始，不满足精度时继续细分
+	 * @param Tolerance			精度，控制多边形足够平直时视为直线段
+	 * @param Prune				(包围盒) 返回 true 时跳过该段
+	 * @param Leaf				(起点, 终点, 开始时间, 结束时间) 返回 true 时停止遍历
+	 */
+	template <typename PruneFuncType, typename LeafFuncType>
+	void VisitPieces(float Tolerance, PruneFuncType&& Prune, LeafFuncType&& Leaf) const;
+
+	// 控制点
+	UPROPERTY()
+	TArray<FVector> Points;
+
+	// 多项式系数，P(t) = Σ Coefficients[j] * t^j
+	UPROPERTY()
+	TArray<FVector> Coefficients;
+
+	// 导数的多项式系数
+	UPROPERTY()
+	TArray<FVector> DerivativeCoefficients;
+
+	// 弧长表，ArcLengths[i] 为时间 i/分段数 处的累计长度
+	UPROPERTY()
+	TArray<float> ArcLengths;
+
+	// 整条曲线的包围盒
+	UPROPERTY()
+	FBox Bounds = FBox(ForceInit);
+
+	// 按时间均分的分段的控制点，每段 Points.Num() 个
+	UPROPERTY()
+	TArray<FVector> PieceControlPoints;
+
+	// 分段的包围盒（由控制点得到，包含该段曲线）
+	UPROPERTY()
+	TArray<FBox> PieceBounds;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * 批量贝塞尔弹道
+ * 二次、三次贝塞尔统一存为三次多项式系数（SoA），每次用4路SIMD同时计算4条弹道，
+ * 可选拆分到多个工作线程，结果直接写入位置数组或实例变换
+ * 控制点以 Origin 为原点存为 float，Origin 应靠近弹道所在区域
+ */
+class TOOLKITS_API FYCBezierTrajectoryBatch
+{
+public:
+	explicit FYCBezierTrajectoryBatch(const FVector& InOrigin = FVector::ZeroVector);
+
+	/**
+	 * 添加二次贝塞尔弹道
+	 * @param P0			起点
+	 * @param P1			控制点
+	 * @param P2			终点
+	 * @param StartTime		开始时间
+	 * @param Duration		持续时间
+	 * @return				弹道下标
+	 */
+	int32 AddQuadratic(const FVector& P0, const FVector& P1, const FVector& P2, float StartTime, float Duration);
+
+	/**
+	 * 添加三次贝塞尔弹道
+	 * @param P0			起点
+	 * @param P1			控制点1
+	 * @param P2			控制点2
+	 * @param P3			终点
+	 * @param StartTime		开始时间
+	 * @param Duration		持续时间
+	 * @return				弹道下标
+	 */
+	int32 AddCubic(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, float StartTime, float Duration);
+
+	// 交换删除弹道，最后一条弹道会移动到 Index
+	void RemoveAtSwap(int32 Index);
+
+	// 清空
+	void Reset();
+
+	// 弹道数量
+	FORCEINLINE int32 Num() const { return Count; }
+
+	// 获取原点
+	FORCEINLINE const FVector& GetOrigin() const { return Origin; }
+
+	/**
+	 * 计算所有弹道在 Time 时的位置
+	 * @param Time			当前时间
+	 * @param OutPositions	位置，数量需不少于 Num()
+	 * @param bParallel		是否拆分到多个工作线程
+	 */
+	void Evaluate(float Time, TArrayView<FVector> OutPositions, bool bParallel = false) const;
+
+	/**
+	 * 计算所有弹道在 Time 时的变换，只修改位置和旋转，保留缩放
+	 * @param Time				当前时间
+	 * @param InOutTransforms	变换，数量需不少于 Num()
+	 * @param bOrientToVelocity	是否朝向运动方向
+	 * @param bParallel			是否拆分到多个工作线程
+	 */
+	void EvaluateTransforms(float Time, TArrayView<FTransform> InOutTransforms, bool bOrientToVelocity = true, bool bParallel = false) const;
+
+	/**
+	 * 把所有弹道的变换直接写入实例组件，实例 i 对应弹道 i
+	 * @param Time				当前时间
+	 * @param Component			实例组件，实例数量需不少于 Num()
+	 * @param bOrientToVelocity	是否朝向运动方向
+	 * @param bParallel			是否拆分到多个工作线程
+	 */
+	void UpdateInstances(float Time, UInstancedStaticMeshComponent* Component, bool bOrientToVelocity = true, bool bParallel = false);
+
+	// 获取在 Time 时已经结束的弹道下标（降序，可直接按顺序 RemoveAtSwap）
+	void GetFinished(float Time, TArray<int32>& OutIndices) const;
+
+private:
+	// 添加多项式系数 A*t^3 + B*t^2 + C*t + D
+	int32 AddCoefficients(const FVector3f& A, const FVector3f& B, const FVector3f& C, const FVector3f& D, float StartTime, float Duration);
+
+	// 计算 [FirstGroup, LastGroup) 组（每组4条）的位置和速度方向，输出数组从第 FirstGroup 组开始
+	void EvaluateGroups(float Time, int32 FirstGroup, int32 LastGroup, FVector* OutPositions, FVector* OutDirections) const;
+
+	// 按组拆分任务
+	template <typename FuncType>
+	void ForEachGroupRange(bool bParallel, FuncType&& Func) const;
+
+	// 原点
+	FVector Origin;
+
+	// 弹道数量
+	int32 Count = 0;
+
+	// 系数，[项][分量]，项依次为 t^3、t^2、t、常数，长度补齐到4的倍数
+	TArray<float> Coefficients[4][3];
+
+	// 开始时间
+	TArray<float> StartTimes;
+
+	// 持续时间的倒数，补齐部分为0
+	TArray<float> InvDurations;
+
+	// 复用的变换数组
+	TArray<FTransform> InstanceTransforms;
+};
@@ -1,26 +1,89 @@
 #pragma once
 #include "CoreMinimal.h"
+#include "YC_LogAsync.h"
 
-DECLARE_LOG_CATEGORY_EXTERN(YiChenLog, Log, All);
+TOOLKITS_API DECLARE_LOG_CATEGORY_EXTERN(YiChenLog, Log, All);
 
-// 全局Log启用开关，默认关闭
-extern bool bYiChenLogEnable;
+// 全局Log启用开关，默认关闭，运行时修改立即生效
+extern TOOLKITS_API bool bYiChenLogEnable;
 
 /**
- * YICHEN_LOG 宏定义用于条件性地记录日志消息。
- * 它根据 bYiChenLogEnable 标志决定是否记录日志。
- * 这个宏只在 bYiChenLogEnable 为真时执行日志记录操作。
+ * 编译期日志级别，高于该级别的 YICHEN_LOG 会被整体剔除（参数表达式也不会执行）
+ * 可在 Build.cs 中通过 PublicDefinitions 覆盖，例如 YICHEN_LOG_COMPILED_VERBOSITY=ELogVerbosity::Error
+ */
+#ifndef YICHEN_LOG_COMPILED_VERBOSITY
+#if UE_BUILD_SHIPPING
+#define YICHEN_LOG_COMPILED_VERBOSITY ELogVerbosity::Warning
+#else
+#define YICHEN_LOG_COMPILED_VERBOSITY ELogVerbosity::VeryVerbose
+#endif
+#endif
+
+// YiChenLog 的子分类，每个分类的运行时级别可在 YiChenLog.ini 中单独配置
+namespace EYiChenLogCategory
+{
+	enum Type : uint8
+	{
+		// 默认
+		Default,
+		// 围栏
+		Fence,
+		// 战争迷雾
+		Fog,
+		// 授权
+		License,
+
+		Num
+	};
+}
+
+// 每个分类的运行时级别，由 LoadConfig 读取一次
+extern TOOLKITS_API uint8 GYiChenLogLevels[EYiChenLogCategory::Num];
+
+// 与 UE_LOG 相同的编译期格式检查
+#if defined(UE_VALIDATE_FORMAT_STRING)
+#define YICHEN_LOG_CHECK_FORMAT(Format, ...) UE_VALIDATE_FORMAT_STRING(Format, ##__VA_ARGS__)
+#elif defined(UE_CHECK_FORMAT_STRING)
+#define YICHEN_LOG_CHECK_FORMAT(Format, ...) UE_CHECK_FORMAT_STRING(Format, ##__VA_ARGS__)
+#else
+#define YICHEN_LOG_CHECK_FORMAT(Format, ...)
+#endif
+
+/**
+ * YICHEN_CLOG 宏定义用于按分类记录日志消息。
+ * 高于 YICHEN_LOG_COMPILED_VERBOSITY 的日志在编译期被剔除（Fatal 除外），
+ * 其余日志只在 bYiChenLogEnable 为真且不高于分类的运行时级别时记录，关闭时只有一次布尔判断。
+ * 除 Fatal 外的日志交给后台线程格式化和输出（见 YC_LogAsync.h），参数只支持数值、枚举和字符串，
+ * 格式字符串与参数的匹配在编译期按 UE_LOG 的规则检查。
  * 
+ * @param Category 日志分类，EYiChenLogCategory 中的名称。
  * @param Verbosity 日志的详细级别，决定了日志的重要性。
  * @param Format 格式字符串，描述了日志消息的结构。
  * @param ... 可变参数列表，包含格式字符串中的替换项。
  */
-#define YICHEN_LOG(Verbosity, Format, ...) \
+#define YICHEN_CLOG(Category, Verbosity, Format, ...) \
 	do{\
-		if(bYiChenLogEnable){\
-			UE_LOG(YiChenLog,Verbosity,TEXT(Format),##__VA_ARGS__);\
+		if constexpr (ELogVerbosity::Verbosity == ELogVerbosity::Fatal || ELogVerbosity::Verbosity <= YICHEN_LOG_COMPILED_VERBOSITY){\
+			if(bYiChenLogEnable && ELogVerbosity::Verbosity <= GYiChenLogLevels[EYiChenLogCategory::Category]){\
+				if constexpr (ELogVerbosity::Verbosity == ELogVerbosity::Fatal){\
+					YCLog::Flush();\
+					UE_LOG(YiChenLog,Verbosity,TEXT(Format),##__VA_ARGS__);\
+				}else{\
+					YICHEN_LOG_CHECK_FORMAT(TEXT(Format), ##__VA_ARGS__);\
+					YCLog::Log(ELogVerbosity::Verbosity,TEXT(Format),##__VA_ARGS__);\
+				}\
+			}\
 		}\
 	}while(0)
 
+/**
+ * YICHEN_LOG 宏定义用于条件性地记录日志消息，使用默认分类。
+ * 
+ * @param Verbosity 日志的详细级别，决定了日志的重要性。
+ * @param Format 格式字符串，描述了日志消息的结构。
+ * @param ... 可变参数列表，包含格式字符串中的替换项。
+ */
+#define YICHEN_LOG(Verbosity, Format, ...) YICHEN_CLOG(Default, Verbosity, Format, ##__VA_ARGS__)
+
 // 读取配置文件
-void LoadConfig();
+TOOLKITS_API void LoadConfig();
@@ -0,0 +1,232 @@
+#pragma once
+#include "CoreMinimal.h"
+#include <type_traits>
+
+/**
+ * YICHEN_LOG 的异步后端
+ * 调用线程只把 格式字符串指针（作为格式ID）+ 原始参数 写入本线程的无锁环形缓冲，
+ * 格式化和输出由后台线程完成。缓冲写满时丢弃新日志并计数，内存占用有上限。
+ */
+namespace YCLog
+{
+	// 单条日志的参数区大小（字节），超出的字符串会被截断
+	static constexpr int32 PayloadSize = 232;
+
+	// 单个参数槽的大小
+	static constexpr int32 SlotSize = 8;
+
+	struct FRecord;
+
+	// 解码函数，由参数类型实例化
+	typedef void (*FDecodeFunc)(const FRecord& Record, TCHAR* Dest, int32 DestSize);
+
+	// 日志记录
+	struct FRecord
+	{
+		// 格式字符串（字面量，生命周期为整个程序）
+		const TCHAR* Format;
+		// 解码函数
+		FDecodeFunc Decode;
+		// 日志级别
+		ELogVerbosity::Type Verbosity;
+		// 参数区，前面是每个参数一个槽，后面是字符串数据
+		alignas(8) uint8 Payload[PayloadSize];
+	};
+
+	/**
+	 * 获取当前线程环形缓冲中的下一个空位
+	 * @return 缓冲已满时返回 nullptr（日志被丢弃）
+	 */
+	TOOLKITS_API FRecord* BeginRecord();
+
+	// 提交 BeginRecord 获取的记录
+	TOOLKITS_API void CommitRecord();
+
+	// 后台线程未运行时直接输出
+	TOOLKITS_API void WriteImmediately(const FRecord& Record);
+
+	// 后台线程是否在运行
+	TOOLKITS_API bool IsBackendRunning();
+
+	// 以运行时的格式字符串格式化
+	TOOLKITS_API void FormatVA(TCHAR* Dest, int32 DestSize, const TCHAR* Format, ...);
+
+	// 启动后台写入线程
+	TOOLKITS_API void StartBackend();
+
+	// 停止后台写入线程，并输出所有未处理的日志
+	TOOLKITS_API void StopBackend();
+
+	// 同步输出所有未处理的日志（Fatal 日志前使用，崩溃回调使用不会阻塞的版本）
+	TOOLKITS_API void Flush();
+
+	namespace Private
+	{
+		// 参数的编码方式：数值直接存入槽，字符串拷贝到参数区末尾
+		// 其他指针指向的内容在后台线程格式化时可能已经失效，不允许作为参数
+		template <typename T, typename = void>
+		struct TArg
+		{
+			static_assert(std::is_arithmetic_v<T>, "YICHEN_LOG 参数只支持数值、枚举和字符串（TCHAR/ANSICHAR/UTF8CHAR）");
+
+			// 可变参数默认提升后的类型
+			using FStored = std::conditional_t<std::is_floating_point_v<T>, double,
+			                                   std::conditional_t<std::is_integral_v<T> && (sizeof(T) < sizeof(int)), int, T>>;
+
+			static FORCEINLINE void Write(uint8* Payload, const int32 Slot, int32& /*StringOffset*/, const T Value)
+			{
+				const FStored Stored = static_cast<FStored>(Value);
+				FMemory::Memcpy(Payload + Slot * SlotSize, &Stored, sizeof(FStored));
+			}
+
+			static FORCEINLINE FStored Read(const uint8* Payload, const int32 Slot)
+			{
+				FStored Stored;
+				FMemory::Memcpy(&Stored, Payload + Slot * SlotSize, sizeof(FStored));
+				return Stored;
+			}
+		};
+
+		// 枚举按底层类型处理
+		template <typename T>
+		struct TArg<T, std::enable_if_t<std::is_enum_v<T>>> : TArg<std::underlying_type_t<T>>
+		{
+			static FORCEINLINE void Write(uint8* Payload, const int32 Slot, int32& StringOffset, const T Value)
+			{
+				TArg<std::underlying_type_t<T>>::Write(Payload, Slot, StringOffset, static_cast<std::underlying_type_t<T>>(Value));
+			}
+		};
+
+		// 字符串：拷贝到参数区，槽里存放字符串在参数区中的偏移，保持原来的字符类型
+		template <typename CharType>
+		struct TStringArg
+		{
+			static FORCEINLINE void Write(uint8* Payload, const int32 Slot, int32& StringOffset, const CharType* Value)
+			{
+				// 按字符类型对齐，ANSI 字符串之后的 TCHAR 字符串不能从奇数偏移开始
+				StringOffset = Align(StringOffset, alignof(CharType));
+				const int32 Capacity = (PayloadSize - StringOffset) / static_cast<int32>(sizeof(CharType)) - 1;
+
+				int32 Len = 0;
+				if (Value)
+				{
+					while (Len < Capacity && Value[Len] != CharType(0))
+					{
+						++Len;
+					}
+				}
+
+				int32 Offset = StringOffset;
+				if (Capacity < 0)
+				{
+					// 参数区已满，指向最后一个空字符
+					Offset = PayloadSize - sizeof(CharType);
+					FMemory::Memzero(Payload + Offset, sizeof(CharType));
+				}
+				else
+				{
+					CharType* Dest = reinterpret_cast<CharType*>(Payload + StringOffset);
+					FMemory::Memcpy(Dest, Value, Len * sizeof(CharType));
+					Dest[Len] = CharType(0);
+					StringOffset += (Len + 1) * sizeof(CharType);
+				}
+				FMemory::Memcpy(Payload + Slot * SlotSize, &Offset, sizeof(int32));
+			}
+
+			static FORCEINLINE const CharType* Read(const uint8* Payload, const int32 Slot)
+			{
+				int32 Offset;
+				FMemory::Memcpy(&Offset, Payload + Slot * SlotSize, sizeof(int32));
+				return reinterpret_cast<const CharType*>(Payload + Offset);
+			}
+		};
+
+		template <>
+		struct TArg<const TCHAR*> : TStringArg<TCHAR>
+		{
+		};
+
+		template <>
+		struct TArg<TCHAR*> : TStringArg<TCHAR>
+		{
+		};
+
+		template <>
+		struct TArg<const ANSICHAR*> : TStringArg<ANSICHAR>
+		{
+		};
+
+		template <>
+		struct TArg<ANSICHAR*> : TStringArg<ANSICHAR>
+		{
+		};
+
+		template <>
+		struct TArg<const UTF8CHAR*> : TStringArg<UTF8CHAR>
+		{
+		};
+
+		template <>
+		struct TArg<UTF8CHAR*> : TStringArg<UTF8CHAR>
+		{
+		};
+
+		// 按参数类型解码并格式化
+		template <typename... Ts, int32... Slots>
+		void DecodeImpl(const FRecord& Record, TCHAR* Dest, const int32 DestSize, TIntegerSequence<int32, Slots...>)
+		{
+			FormatVA(Dest, DestSize, Record.Format, TArg<Ts>::Read(Record.Payload, Slots)...);
+		}
+
+		template <typename... Ts>
+		void Decode(const FRecord& Record, TCHAR* Dest, const int32 DestSize)
+		{
+			DecodeImpl<Ts...>(Record, Dest, DestSize, TMakeIntegerSequence<int32, sizeof...(Ts)>());
+		}
+
+		// 写入所有参数
+		template <typename... Ts, int32... Slots>
+		FORCEINLINE void WriteArgs(uint8* Payload, TIntegerSequence<int32, Slots...>, const Ts&... Args)
+		{
+			int32 StringOffset = sizeof...(Ts) * SlotSize;
+			(TArg<Ts>::Write(Payload, Slots, StringOffset, Args), ...);
+		}
+	}
+
+	/**
+	 * 记录一条日志
+	 * @param Verbosity		日志级别
+	 * @param Format		格式字符串字面量
+	 * @param Args			参数
+	 */
+	template <typename... Ts>
+	FORCEINLINE void Log(const ELogVerbosity::Type Verbosity, const TCHAR* Format, const Ts... Args)
+	{
+		// 至少给字符串留出一部分空间
+		static_assert(sizeof...(Ts) * SlotSize + 64 <= PayloadSize, "YICHEN_LOG 参数过多");
+
+		FRecord StackRecord;
+		FRecord* Record = BeginRecord();
+		const bool bQueued = Record != nullptr;
+		if (!bQueued)
+		{
+			// 后台线程未运行时在栈上组装后直接输出；缓冲已满时丢弃（由 BeginRecord 计数）
+			if (IsBackendRunning()) return;
+			Record = &StackRecord;
+		}
+
+		Record->Format = Format;
+		Record->Decode = &Private::Decode<std::decay_t<Ts>...>;
+		Record->Verbosity = Verbosity;
+		Private::WriteArgs<std::decay_t<Ts>...>(Record->Payload, TMakeIntegerSequence<int32, sizeof...(Ts)>(), Args...);
+
+		if (bQueued)
+		{
+			CommitRecord();
+		}
+		else
+		{
+			WriteImmediately(*Record);
+		}
+	}
+}
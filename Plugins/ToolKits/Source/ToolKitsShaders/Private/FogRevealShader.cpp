@@ -0,0 +1,64 @@
+﻿#include "FogRevealShader.h"
+#include "FogRevealPass.h"
+
+#include "DataDrivenShaderPlatformInfo.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderTargetPool.h"
+#include "RHI.h"
+
+IMPLEMENT_GLOBAL_SHADER(FFogRevealCS, "/ToolKitsMaterial/FogWar/FogReveal.usf", "MainCS", SF_Compute);
+
+bool FFogRevealCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+}
+
+void FFogRevealCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), ThreadGroupSize);
+}
+
+// 当前RHI是否能运行迷雾Compute Shader
+bool FogOfWar::CanUseGPUReveal()
+{
+	return !GUsingNullRHI && FApp::CanEverRender() && GMaxRHIFeatureLevel >= ERHIFeatureLevel::SM5;
+}
+
+// 添加迷雾照亮Pass
+void FogOfWar::AddFogRevealPass(FRHICommandListImmediate& RHICmdList, FRHITexture* FogTexture, const TArray<FVector4f>& VisionSources, const FIntPoint& GridSize, const float EdgeWidth)
+{
+	check(IsInRenderingThread());
+	if (FogTexture == nullptr) return;
+
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	// 迷雾渲染目标同时作为输入和输出，先拷贝一份上一帧的数据用于读取已探索通道
+	const FRDGTextureRef OutTexture = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(FogTexture, TEXT("FogOfWar.Fog")));
+	const FRDGTextureDesc PrevDesc = FRDGTextureDesc::Create2D(OutTexture->Desc.Extent, OutTexture->Desc.Format, FClearValueBinding::Black, TexCreate_ShaderResource);
+	const FRDGTextureRef PrevTexture = GraphBuilder.CreateTexture(PrevDesc, TEXT("FogOfWar.PrevFog"));
+	AddCopyTexturePass(GraphBuilder, OutTexture, PrevTexture);
+
+	// 结构化缓冲不能为空，没有视野源时放一个占位元素
+	static const TArray<FVector4f> EmptySources = {FVector4f(0.f, 0.f, -1.f, 0.f)};
+	const FRDGBufferRef SourceBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("FogOfWar.VisionSources"), VisionSources.IsEmpty() ? EmptySources : VisionSources);
+
+	FFogRevealCS::FParameters* PassParameters = GraphBuilder.AllocParameters<FFogRevealCS::FParameters>();
+	PassParameters->GridSize = GridSize;
+	PassParameters->NumSources = VisionSources.Num();
+	PassParameters->EdgeWidth = FMath::Max(EdgeWidth, UE_KINDA_SMALL_NUMBER);
+	PassParameters->VisionSources = GraphBuilder.CreateSRV(SourceBuffer);
+	PassParameters->PrevFog = PrevTexture;
+	PassParameters->OutFog = GraphBuilder.CreateUAV(OutTexture);
+
+	const TShaderMapRef<FFogRevealCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("FogOfWar.Reveal"),
+		ComputeShader,
+		PassParameters,
+		FComputeShaderUtils::GetGroupCount(GridSize, FFogRevealCS::ThreadGroupSize));
+
+	GraphBuilder.Execute();
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphResources.h"
+
+/**
+ * 战争迷雾照亮 Compute Shader
+ * 读取视野源结构化缓冲，一次Dispatch写入可见（带模糊边缘）和已探索通道
+ */
+class FFogRevealCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FFogRevealCS);
+	SHADER_USE_PARAMETER_STRUCT(FFogRevealCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FIntPoint, GridSize)
+		SHADER_PARAMETER(uint32, NumSources)
+		SHADER_PARAMETER(float, EdgeWidth)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float4>, VisionSources)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float2>, PrevFog)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float2>, OutFog)
+	END_SHADER_PARAMETER_STRUCT()
+
+	// 线程组边长
+	static constexpr int32 ThreadGroupSize = 8;
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
@@ -0,0 +1,25 @@
+﻿#include "ToolKitsShaders.h"
+#include "ShaderCore.h"
+#include "HAL/PlatformFileManager.h"
+
+#define LOCTEXT_NAMESPACE "FToolKitsShadersModule"
+
+void FToolKitsShadersModule::StartupModule()
+{
+	InitShadersPath();
+}
+
+void FToolKitsShadersModule::ShutdownModule()
+{
+}
+
+// 初始化着色器路径
+void FToolKitsShadersModule::InitShadersPath()
+{
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*PluginsShaderDirectory);
+	AddShaderSourceDirectoryMapping(TEXT("/ToolKitsMaterial"), PluginsShaderDirectory);
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FToolKitsShadersModule, ToolKitsShaders)
@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class FRHICommandListImmediate;
+class FRHITexture;
+
+namespace FogOfWar
+{
+	// 当前RHI是否能运行迷雾Compute Shader（NullRHI下返回false，回退到CPU网格）
+	TOOLKITSSHADERS_API bool CanUseGPUReveal();
+
+	/**
+	 * 在渲染线程添加迷雾照亮Pass
+	 * @param RHICmdList		渲染命令列表
+	 * @param FogTexture		迷雾渲染目标（需要支持UAV）
+	 * @param VisionSources		视野源，xy=格子坐标，z=半径（格子数）
+	 * @param GridSize			网格大小
+	 * @param EdgeWidth			模糊边缘宽度（格子数）
+	 */
+	TOOLKITSSHADERS_API void AddFogRevealPass(FRHICommandListImmediate& RHICmdList, FRHITexture* FogTexture, const TArray<FVector4f>& VisionSources, const FIntPoint& GridSize, float EdgeWidth);
+}
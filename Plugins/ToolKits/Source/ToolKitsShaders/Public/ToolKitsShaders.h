@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+/**
+ * 插件着色器模块
+ * 在 PostConfigInit 阶段注册 /ToolKitsMaterial 路径和全局着色器，不依赖插件的其他模块
+ */
+class FToolKitsShadersModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+	// 插件Shader路径
+	const FString PluginsShaderDirectory = FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("ToolKits/Shaders"));
+
+	// 初始化材质路径
+	void InitShadersPath();
+};
@@ -0,0 +1,25 @@
+﻿using UnrealBuildTool;
+
+public class ToolKitsShaders : ModuleRules
+{
+	public ToolKitsShaders(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"RHI"
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"RenderCore"
+			}
+		);
+	}
+}
\ No newline at end of file